@@ -1962,6 +1962,8 @@ extern bfd_boolean _bfd_elf_write_corefile_contents
   (bfd *);
 extern bfd_boolean _bfd_elf_set_section_contents
   (bfd *, sec_ptr, const void *, file_ptr, bfd_size_type);
+extern bfd_boolean bfd_elf_set_last_section_size
+  (bfd *, asection *, bfd_size_type);
 extern long _bfd_elf_get_symtab_upper_bound
   (bfd *);
 extern long _bfd_elf_canonicalize_symtab
@@ -8333,6 +8333,51 @@ _bfd_elf_set_section_contents (bfd *abfd,
   return TRUE;
 }
 
+/* Change the size of SEC, the last section in the file of ABFD, to
+   SIZE.  This lets a writer lay out a section whose final size it does
+   not know yet, write past its laid-out end with bfd_seek and
+   bfd_bwrite, and then record the size it ended up with.  The section
+   header, and any program header holding exactly SEC, are updated,
+   and the section headers will be written after SIZE bytes of SEC when
+   ABFD is closed.  */
+
+bfd_boolean
+bfd_elf_set_last_section_size (bfd *abfd, asection *sec, bfd_size_type size)
+{
+  const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+  Elf_Internal_Ehdr *ehdr = elf_elfheader (abfd);
+  Elf_Internal_Phdr *phdr = elf_tdata (abfd)->phdr;
+  bfd_size_type old_size = sec->size;
+  unsigned int i;
+
+  if (!abfd->output_has_begun
+      || elf_next_file_pos (abfd) != sec->filepos + (file_ptr) old_size)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      return FALSE;
+    }
+
+  sec->size = size;
+  elf_section_data (sec)->this_hdr.sh_size = size;
+
+  /* The program headers were written out when the file was laid
+     out.  */
+  for (i = 0; i < ehdr->e_phnum; i++)
+    if (phdr[i].p_type != PT_NULL
+	&& phdr[i].p_offset == (bfd_vma) sec->filepos
+	&& phdr[i].p_filesz == old_size)
+      {
+	phdr[i].p_filesz = size;
+	if (bfd_seek (abfd, ehdr->e_phoff + i * bed->s->sizeof_phdr,
+		      SEEK_SET) != 0
+	    || bed->s->write_out_phdrs (abfd, &phdr[i], 1) != 0)
+	  return FALSE;
+      }
+
+  elf_next_file_pos (abfd) = sec->filepos + size;
+  return TRUE;
+}
+
 void
 _bfd_elf_no_info_to_howto (bfd *abfd ATTRIBUTE_UNUSED,
 			   arelent *cache_ptr ATTRIBUTE_UNUSED,
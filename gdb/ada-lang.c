@@ -6558,7 +6558,7 @@ ada_make_symbol_completion_list (const char *text0, const char *word,
     data.word = word;
     data.wild_match = wild_match_p;
     data.encoded = encoded_p;
-    expand_symtabs_matching (NULL, ada_complete_symbol_matcher, NULL,
+    expand_symtabs_matching (NULL, ada_complete_symbol_matcher, NULL, NULL,
 			     ALL_DOMAIN, &data);
   }
 
@@ -13383,7 +13383,7 @@ ada_add_global_exceptions (regex_t *preg, VEC(ada_exc_info) **exceptions)
   struct objfile *objfile;
   struct compunit_symtab *s;
 
-  expand_symtabs_matching (NULL, ada_exc_search_name_matches, NULL,
+  expand_symtabs_matching (NULL, ada_exc_search_name_matches, NULL, NULL,
 			   VARIABLES_DOMAIN, preg);
 
   ALL_COMPUNITS (objfile, s)
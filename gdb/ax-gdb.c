@@ -2497,6 +2497,300 @@ gen_eval_for_expr (CORE_ADDR scope, struct expression *expr)
   return ax;
 }
 
+/* Return non-zero if AX, an expression built by gen_eval_for_expr, can
+   be run by ax_eval_on_host.  The expression must be well-formed, only
+   jump forward, and only use the bytecodes that compute integer values
+   from registers, memory and constants; anything involving tracing,
+   trace state variables, floating point or printf is rejected.  */
+
+int
+ax_eval_on_host_p (struct agent_expr *ax)
+{
+  int i;
+
+  ax_reqs (ax);
+  if (ax->flaw != agent_flaw_none
+      || ax->min_height < 0
+      || ax->final_height < 1
+      || ax->max_height > 1024)
+    return 0;
+
+  for (i = 0; i < ax->len; )
+    {
+      enum agent_op op = (enum agent_op) ax->buf[i];
+
+      switch (op)
+	{
+	case aop_add:
+	case aop_sub:
+	case aop_mul:
+	case aop_div_signed:
+	case aop_div_unsigned:
+	case aop_rem_signed:
+	case aop_rem_unsigned:
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	case aop_log_not:
+	case aop_bit_and:
+	case aop_bit_or:
+	case aop_bit_xor:
+	case aop_bit_not:
+	case aop_equal:
+	case aop_less_signed:
+	case aop_less_unsigned:
+	case aop_ext:
+	case aop_zero_ext:
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	case aop_reg:
+	case aop_end:
+	case aop_dup:
+	case aop_pop:
+	case aop_pick:
+	case aop_rot:
+	case aop_swap:
+	  break;
+
+	case aop_if_goto:
+	case aop_goto:
+	  /* Only allow forward jumps, so that every bytecode runs at
+	     most once.  */
+	  if (((ax->buf[i + 1] << 8) + ax->buf[i + 2]) <= i)
+	    return 0;
+	  break;
+
+	default:
+	  return 0;
+	}
+
+      i += 1 + aop_map[op].op_size;
+    }
+
+  return 1;
+}
+
+/* Run AX, for which ax_eval_on_host_p returned non-zero, reading
+   registers from REGCACHE and memory from the current target, and
+   store the value left on top of the stack in *RESULT.  This follows
+   the semantics of the agent's bytecode interpreter, but does not
+   build any value.  Return non-zero on success, or zero if AX could
+   not be evaluated: a division by zero, an unreadable register or
+   memory location, and so on.  The caller can then evaluate the
+   original expression to report the error.  */
+
+int
+ax_eval_on_host (struct agent_expr *ax, struct regcache *regcache,
+		 ULONGEST *result)
+{
+  struct gdbarch *gdbarch = ax->gdbarch;
+  enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+  ULONGEST *stack = XALLOCAVEC (ULONGEST, ax->max_height + 1);
+  int sp = 0;
+  int pc = 0;
+
+  if (get_regcache_arch (regcache) != gdbarch)
+    return 0;
+
+  while (1)
+    {
+      enum agent_op op = (enum agent_op) ax->buf[pc++];
+      ULONGEST top;
+      int arg, size;
+      gdb_byte buf[8];
+
+      switch (op)
+	{
+	case aop_add:
+	  sp--;
+	  stack[sp - 1] += stack[sp];
+	  break;
+
+	case aop_sub:
+	  sp--;
+	  stack[sp - 1] -= stack[sp];
+	  break;
+
+	case aop_mul:
+	  sp--;
+	  stack[sp - 1] *= stack[sp];
+	  break;
+
+	case aop_div_signed:
+	case aop_div_unsigned:
+	case aop_rem_signed:
+	case aop_rem_unsigned:
+	  top = stack[--sp];
+	  if (top == 0)
+	    return 0;
+	  if (op == aop_div_signed)
+	    stack[sp - 1] = (LONGEST) stack[sp - 1] / (LONGEST) top;
+	  else if (op == aop_div_unsigned)
+	    stack[sp - 1] /= top;
+	  else if (op == aop_rem_signed)
+	    stack[sp - 1] = (LONGEST) stack[sp - 1] % (LONGEST) top;
+	  else
+	    stack[sp - 1] %= top;
+	  break;
+
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	  top = stack[--sp];
+	  if (top >= sizeof (ULONGEST) * HOST_CHAR_BIT)
+	    return 0;
+	  if (op == aop_lsh)
+	    stack[sp - 1] <<= top;
+	  else if (op == aop_rsh_signed)
+	    stack[sp - 1] = (LONGEST) stack[sp - 1] >> top;
+	  else
+	    stack[sp - 1] >>= top;
+	  break;
+
+	case aop_log_not:
+	  stack[sp - 1] = !stack[sp - 1];
+	  break;
+
+	case aop_bit_and:
+	  sp--;
+	  stack[sp - 1] &= stack[sp];
+	  break;
+
+	case aop_bit_or:
+	  sp--;
+	  stack[sp - 1] |= stack[sp];
+	  break;
+
+	case aop_bit_xor:
+	  sp--;
+	  stack[sp - 1] ^= stack[sp];
+	  break;
+
+	case aop_bit_not:
+	  stack[sp - 1] = ~stack[sp - 1];
+	  break;
+
+	case aop_equal:
+	  sp--;
+	  stack[sp - 1] = stack[sp - 1] == stack[sp];
+	  break;
+
+	case aop_less_signed:
+	  sp--;
+	  stack[sp - 1] = (LONGEST) stack[sp - 1] < (LONGEST) stack[sp];
+	  break;
+
+	case aop_less_unsigned:
+	  sp--;
+	  stack[sp - 1] = stack[sp - 1] < stack[sp];
+	  break;
+
+	case aop_ext:
+	  arg = ax->buf[pc++];
+	  if (arg > 0 && arg < HOST_CHAR_BIT * (int) sizeof (ULONGEST))
+	    {
+	      ULONGEST mask = (ULONGEST) 1 << (arg - 1);
+
+	      top = stack[sp - 1] & (((ULONGEST) 1 << arg) - 1);
+	      stack[sp - 1] = (top ^ mask) - mask;
+	    }
+	  break;
+
+	case aop_zero_ext:
+	  arg = ax->buf[pc++];
+	  if (arg < HOST_CHAR_BIT * (int) sizeof (ULONGEST))
+	    stack[sp - 1] &= ((ULONGEST) 1 << arg) - 1;
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  size = aop_map[op].data_size / 8;
+	  if (target_read_memory ((CORE_ADDR) stack[sp - 1], buf, size) != 0)
+	    return 0;
+	  stack[sp - 1] = extract_unsigned_integer (buf, size, byte_order);
+	  break;
+
+	case aop_if_goto:
+	  if (stack[--sp] != 0)
+	    pc = (ax->buf[pc] << 8) + ax->buf[pc + 1];
+	  else
+	    pc += 2;
+	  break;
+
+	case aop_goto:
+	  pc = (ax->buf[pc] << 8) + ax->buf[pc + 1];
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  size = aop_map[op].op_size;
+	  top = 0;
+	  while (size-- > 0)
+	    top = (top << 8) + ax->buf[pc++];
+	  stack[sp++] = top;
+	  break;
+
+	case aop_reg:
+	  arg = (ax->buf[pc] << 8) + ax->buf[pc + 1];
+	  pc += 2;
+	  if (arg >= gdbarch_num_regs (gdbarch)
+	      || register_size (gdbarch, arg) > (int) sizeof (ULONGEST)
+	      || regcache_raw_read_unsigned (regcache, arg,
+					     &stack[sp]) != REG_VALID)
+	    return 0;
+	  sp++;
+	  break;
+
+	case aop_end:
+	  *result = stack[sp - 1];
+	  return 1;
+
+	case aop_dup:
+	  stack[sp] = stack[sp - 1];
+	  sp++;
+	  break;
+
+	case aop_pop:
+	  sp--;
+	  break;
+
+	case aop_pick:
+	  arg = ax->buf[pc++];
+	  if (arg >= sp)
+	    return 0;
+	  stack[sp] = stack[sp - 1 - arg];
+	  sp++;
+	  break;
+
+	case aop_rot:
+	  top = stack[sp - 1];
+	  stack[sp - 1] = stack[sp - 2];
+	  stack[sp - 2] = stack[sp - 3];
+	  stack[sp - 3] = top;
+	  break;
+
+	case aop_swap:
+	  top = stack[sp - 1];
+	  stack[sp - 1] = stack[sp - 2];
+	  stack[sp - 2] = top;
+	  break;
+
+	default:
+	  return 0;
+	}
+    }
+}
+
 struct agent_expr *
 gen_trace_for_return_address (CORE_ADDR scope, struct gdbarch *gdbarch,
 			      int trace_string)
@@ -20,6 +20,7 @@
 #define AX_GDB_H
 
 struct expression;
+struct regcache;
 union exp_element;
 
 /* Types and enums */
@@ -113,6 +114,16 @@ extern struct agent_expr *gen_trace_for_return_address (CORE_ADDR,
 
 extern struct agent_expr *gen_eval_for_expr (CORE_ADDR, struct expression *);
 
+/* Return non-zero if AX, built by gen_eval_for_expr, can be evaluated
+   by ax_eval_on_host.  */
+extern int ax_eval_on_host_p (struct agent_expr *ax);
+
+/* Evaluate AX in GDB, reading registers from REGCACHE and memory from
+   the current target, and store its value in *RESULT.  Return zero if
+   the expression could not be evaluated.  */
+extern int ax_eval_on_host (struct agent_expr *ax, struct regcache *regcache,
+			    ULONGEST *result);
+
 extern void gen_expr (struct expression *exp, union exp_element **pc,
 		      struct agent_expr *ax, struct axs_value *value);
 
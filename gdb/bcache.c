@@ -31,15 +31,12 @@
 
 struct bstring
 {
-  /* Hash chain.  */
-  struct bstring *next;
-  /* Assume the data length is no more than 64k.  */
-  unsigned short length;
-  /* The half hash hack.  This contains the upper 16 bits of the hash
-     value and is used as a pre-check when comparing two strings and
-     avoids the need to do length or memcmp calls.  It proves to be
-     roughly 100% effective.  */
-  unsigned short half_hash;
+  /* The length of the data.  */
+  unsigned int length;
+
+  /* The hash value of the data, truncated to 32 bits.  This fills
+     what would otherwise be padding before the data.  */
+  unsigned int hash;
 
   union
   {
@@ -52,18 +49,30 @@ struct bstring
 
 /* The structure for a bcache itself.  The bcache is initialized, in
    bcache_xmalloc(), by filling it with zeros and then setting the
-   corresponding obstack's malloc() and free() methods.  */
+   corresponding obstack's malloc() and free() methods.
+
+   The hash table uses open addressing with linear probing.  Slot I is
+   empty if TAGS[I] is zero; otherwise BUCKET[I] is a string whose
+   tag, a byte made of the low bits of its hash value, is TAGS[I].
+   Probing only reads the dense TAGS array until a tag matches.  The
+   home slot of a string is its hash value scaled to the table size
+   (see bstring_home), and as the strings record their hash values,
+   growing the table never calls the hash function again.  */
 
 struct bcache
 {
   /* All the bstrings are allocated here.  */
   struct obstack cache;
 
-  /* How many hash buckets we're using.  */
+  /* How many slots we're using.  */
   unsigned int num_buckets;
-  
-  /* Hash buckets.  This table is allocated using malloc, so when we
-     grow the table we can return the old table to the system.  */
+
+  /* The hash tags of the slots.  */
+  unsigned char *tags;
+
+  /* The strings of the slots.  These tables are allocated using
+     malloc, so when we grow the table we can return the old table to
+     the system.  */
   struct bstring **bucket;
 
   /* Statistics.  */
@@ -73,16 +82,11 @@ struct bcache
   long total_size;      /* total number of bytes cached, including dups */
   long structure_size;	/* total size of bcache, including infrastructure */
   /* Number of times that the hash table is expanded and hence
-     re-built, and the corresponding number of times that a string is
-     [re]hashed as part of entering it into the expanded table.  The
-     total number of hashes can be computed by adding TOTAL_COUNT to
-     expand_hash_count.  */
+     re-built.  */
   unsigned long expand_count;
-  unsigned long expand_hash_count;
-  /* Number of times that the half-hash compare hit (compare the upper
-     16 bits of hash values) hit, but the corresponding combined
-     length/data compare missed.  */
-  unsigned long half_hash_miss_count;
+  /* Number of times that the hash tag of a slot matched, but the
+     corresponding combined length/data compare missed.  */
+  unsigned long tag_miss_count;
 
   /* Hash function to be used for this bcache object.  */
   unsigned long (*hash_function)(const void *addr, int length);
@@ -91,108 +95,148 @@ struct bcache
   int (*compare_function)(const void *, const void *, int length);
 };
 
-/* The old hash function was stolen from SDBM. This is what DB 3.0
-   uses now, and is better than the old one.  */
-
+/* The multiplier used to mix each word into the hash.  It is the
+   golden ratio scaled to 64 bits, so that the product spreads every
+   bit of a word over the upper bits of the hash.  */
+#define HASH_MULTIPLIER ((ULONGEST) 0x9e3779b97f4a7c15ULL)
+
+/* Mix the 64-bit word W into the hash value H.  */
+
+static inline ULONGEST
+hash_mix_word (ULONGEST h, ULONGEST w)
+{
+  return (((h << 5) | (h >> 59)) ^ w) * HASH_MULTIPLIER;
+}
+
+/* Hash LENGTH bytes at ADDR, eight at a time.  */
+
 unsigned long
 hash(const void *addr, int length)
 {
   return hash_continue (addr, length, 0);
 }
 
-/* Continue the calculation of the hash H at the given address.  */
+/* Continue the calculation of the hash H at the given address.  The
+   bytes are read a word at a time; the final multiply only moves
+   entropy upwards, so the result is folded to make the low bits, which
+   select the slot in a bcache, depend on every byte.  */
 
 unsigned long
 hash_continue (const void *addr, int length, unsigned long h)
 {
-  const unsigned char *k, *e;
+  const gdb_byte *k = (const gdb_byte *) addr;
+  ULONGEST state = hash_mix_word (h, length);
+  ULONGEST w;
 
-  k = (const unsigned char *)addr;
-  e = k+length;
-  for (; k< e;++k)
+  for (; length >= (int) sizeof (w); length -= sizeof (w), k += sizeof (w))
+    {
+      memcpy (&w, k, sizeof (w));
+      state = hash_mix_word (state, w);
+    }
+  if (length > 0)
     {
-      h *=16777619;
-      h ^= *k;
+      w = 0;
+      memcpy (&w, k, length);
+      state = hash_mix_word (state, w);
     }
-  return (h);
+
+  state ^= state >> 32;
+  state *= HASH_MULTIPLIER;
+  state ^= state >> 29;
+  return (unsigned long) state;
 }
-
+
 /* Growing the bcache's hash table.  */
 
-/* If the average chain length grows beyond this, then we want to
-   resize our hash table.  */
-#define CHAIN_LENGTH_THRESHOLD (5)
+/* The number of slots allocated the first time a string is added.  */
+#define INITIAL_NUM_BUCKETS (128)
+
+/* Grow the table when more than 7/8 of its slots are in use.  The
+   probes mostly read the one-byte tags, so a crowded table costs
+   little: see bcache.h.  */
+#define TABLE_FULL_P(bcache) \
+  (((bcache)->unique_count + 1) * 8 \
+   > (unsigned long) (bcache)->num_buckets * 7)
+
+/* Return the tag of a string whose hash value is HASH.  Tags are
+   never zero, which marks an empty slot.  The home slot is taken from
+   the high bits of HASH, so the tag uses the low ones.  */
+
+static inline unsigned char
+bstring_tag (unsigned int hash)
+{
+  return (unsigned char) ((hash & 0x7f) | 0x80);
+}
+
+/* Return the home slot of a string whose hash value is HASH in a
+   table of NUM_BUCKETS slots.  This maps the hash values evenly onto
+   the slots with a multiplication instead of a division, which lets
+   the table grow by less than a factor of two.  */
+
+static inline unsigned int
+bstring_home (unsigned int hash, unsigned int num_buckets)
+{
+  return (unsigned int) (((ULONGEST) hash * num_buckets) >> 32);
+}
+
+/* Place the string S in the first empty slot of the probe sequence of
+   its hash value in TAGS and BUCKETS, which have NUM_BUCKETS slots.  */
+
+static void
+insert_bstring (unsigned char *tags, struct bstring **buckets,
+		unsigned int num_buckets, struct bstring *s)
+{
+  unsigned int i;
+
+  for (i = bstring_home (s->hash, num_buckets);
+       tags[i] != 0;
+       i = i + 1 < num_buckets ? i + 1 : 0)
+    ;
+  tags[i] = bstring_tag (s->hash);
+  buckets[i] = s;
+}
 
 static void
 expand_hash_table (struct bcache *bcache)
 {
-  /* A table of good hash table sizes.  Whenever we grow, we pick the
-     next larger size from this table.  sizes[i] is close to 1 << (i+10),
-     so we roughly double the table size each time.  After we fall off 
-     the end of this table, we just double.  Don't laugh --- there have
-     been executables sighted with a gigabyte of debug info.  */
-  static unsigned long sizes[] = { 
-    1021, 2053, 4099, 8191, 16381, 32771,
-    65537, 131071, 262144, 524287, 1048573, 2097143,
-    4194301, 8388617, 16777213, 33554467, 67108859, 134217757,
-    268435459, 536870923, 1073741827, 2147483659UL
-  };
   unsigned int new_num_buckets;
+  unsigned char *new_tags;
   struct bstring **new_buckets;
   unsigned int i;
 
-  /* Count the stats.  Every unique item needs to be re-hashed and
-     re-entered.  */
   bcache->expand_count++;
-  bcache->expand_hash_count += bcache->unique_count;
 
-  /* Find the next size.  */
-  new_num_buckets = bcache->num_buckets * 2;
-  for (i = 0; i < (sizeof (sizes) / sizeof (sizes[0])); i++)
-    if (sizes[i] > bcache->num_buckets)
-      {
-	new_num_buckets = sizes[i];
-	break;
-      }
+  if (bcache->num_buckets == 0)
+    new_num_buckets = INITIAL_NUM_BUCKETS;
+  else
+    new_num_buckets = bcache->num_buckets + bcache->num_buckets / 4;
 
   /* Allocate the new table.  */
-  {
-    size_t new_size = new_num_buckets * sizeof (new_buckets[0]);
+  new_tags = XCNEWVEC (unsigned char, new_num_buckets);
+  new_buckets = XNEWVEC (struct bstring *, new_num_buckets);
 
-    new_buckets = (struct bstring **) xmalloc (new_size);
-    memset (new_buckets, 0, new_size);
+  bcache->structure_size -= (bcache->num_buckets
+			     * (sizeof (bcache->tags[0])
+				+ sizeof (bcache->bucket[0])));
+  bcache->structure_size += (new_num_buckets
+			     * (sizeof (new_tags[0])
+				+ sizeof (new_buckets[0])));
 
-    bcache->structure_size -= (bcache->num_buckets
-			       * sizeof (bcache->bucket[0]));
-    bcache->structure_size += new_size;
-  }
-
-  /* Rehash all existing strings.  */
+  /* Move the existing strings, using their recorded hash values.  */
   for (i = 0; i < bcache->num_buckets; i++)
-    {
-      struct bstring *s, *next;
-
-      for (s = bcache->bucket[i]; s; s = next)
-	{
-	  struct bstring **new_bucket;
-	  next = s->next;
-
-	  new_bucket = &new_buckets[(bcache->hash_function (&s->d.data,
-							    s->length)
-				     % new_num_buckets)];
-	  s->next = *new_bucket;
-	  *new_bucket = s;
-	}
-    }
+    if (bcache->tags[i] != 0)
+      insert_bstring (new_tags, new_buckets, new_num_buckets,
+		      bcache->bucket[i]);
 
   /* Plug in the new table.  */
-  if (bcache->bucket)
-    xfree (bcache->bucket);
+  xfree (bcache->tags);
+  xfree (bcache->bucket);
+  bcache->tags = new_tags;
   bcache->bucket = new_buckets;
   bcache->num_buckets = new_num_buckets;
 }
 
-
+
 /* Looking up things in the bcache.  */
 
 /* The number of bytes needed to allocate a struct bstring whose data
@@ -217,10 +261,9 @@ bcache (const void *addr, int length, struct bcache *cache)
 const void *
 bcache_full (const void *addr, int length, struct bcache *bcache, int *added)
 {
-  unsigned long full_hash;
-  unsigned short half_hash;
-  int hash_index;
-  struct bstring *s;
+  unsigned int hash;
+  unsigned char tag;
+  unsigned int i;
 
   if (added)
     *added = 0;
@@ -235,34 +278,39 @@ bcache_full (const void *addr, int length, struct bcache *bcache, int *added)
       obstack_init (&bcache->cache);
     }
 
-  /* If our average chain length is too high, expand the hash table.  */
-  if (bcache->unique_count >= bcache->num_buckets * CHAIN_LENGTH_THRESHOLD)
+  /* If the table would become too crowded to probe quickly, expand
+     it.  */
+  if (TABLE_FULL_P (bcache))
     expand_hash_table (bcache);
 
   bcache->total_count++;
   bcache->total_size += length;
 
-  full_hash = bcache->hash_function (addr, length);
-
-  half_hash = (full_hash >> 16);
-  hash_index = full_hash % bcache->num_buckets;
+  hash = (unsigned int) bcache->hash_function (addr, length);
+  tag = bstring_tag (hash);
 
-  /* Search the hash bucket for a string identical to the caller's.
-     As a short-circuit first compare the upper part of each hash
-     values.  */
-  for (s = bcache->bucket[hash_index]; s; s = s->next)
+  /* Search the probe sequence for a string identical to the caller's.
+     As a short-circuit, only look at the strings whose tag is the
+     caller's, and only compare those whose whole hash value is.  */
+  for (i = bstring_home (hash, bcache->num_buckets);
+       bcache->tags[i] != 0;
+       i = i + 1 < bcache->num_buckets ? i + 1 : 0)
     {
-      if (s->half_hash == half_hash)
+      if (bcache->tags[i] == tag)
 	{
-	  if (s->length == length
+	  struct bstring *s = bcache->bucket[i];
+
+	  if (s->hash == hash
+	      && s->length == length
 	      && bcache->compare_function (&s->d.data, addr, length))
 	    return &s->d.data;
 	  else
-	    bcache->half_hash_miss_count++;
+	    bcache->tag_miss_count++;
 	}
     }
 
-  /* The user's string isn't in the list.  Insert it after *ps.  */
+  /* The user's string isn't in the table.  Insert it in the empty
+     slot that ended the search.  */
   {
     struct bstring *newobj
       = (struct bstring *) obstack_alloc (&bcache->cache,
@@ -270,9 +318,9 @@ bcache_full (const void *addr, int length, struct bcache *bcache, int *added)
 
     memcpy (&newobj->d.data, addr, length);
     newobj->length = length;
-    newobj->next = bcache->bucket[hash_index];
-    newobj->half_hash = half_hash;
-    bcache->bucket[hash_index] = newobj;
+    newobj->hash = hash;
+    bcache->tags[i] = tag;
+    bcache->bucket[i] = newobj;
 
     bcache->unique_count++;
     bcache->unique_size += length;
@@ -284,7 +332,7 @@ bcache_full (const void *addr, int length, struct bcache *bcache, int *added)
     return &newobj->d.data;
   }
 }
-
+
 
 /* Compare the byte string at ADDR1 of lenght LENGHT to the
    string at ADDR2.  Return 1 if they are equal.  */
@@ -332,6 +380,7 @@ bcache_xfree (struct bcache *bcache)
   /* Only free the obstack if we actually initialized it.  */
   if (bcache->total_count > 0)
     obstack_free (&bcache->cache, 0);
+  xfree (bcache->tags);
   xfree (bcache->bucket);
   xfree (bcache);
 }
@@ -351,6 +400,8 @@ print_percentage (int portion, int total)
 }
 
 
+
+
 /* Print statistics on BCACHE's memory usage and efficacity at
    eliminating duplication.  NAME should describe the kind of data
    BCACHE holds.  Statistics are printed using `printf_filtered' and
@@ -358,72 +409,58 @@ print_percentage (int portion, int total)
 void
 print_bcache_statistics (struct bcache *c, char *type)
 {
-  int occupied_buckets;
-  int max_chain_length;
-  int median_chain_length;
+  int max_probe_length;
+  int median_probe_length;
+  unsigned long total_probe_length;
   int max_entry_size;
   int median_entry_size;
 
-  /* Count the number of occupied buckets, tally the various string
-     lengths, and measure chain lengths.  */
+  /* Tally the various string lengths, and measure the number of slots
+     probed to find each string.  */
   {
     unsigned int b;
-    int *chain_length = XCNEWVEC (int, c->num_buckets + 1);
+    int *probe_length = XCNEWVEC (int, c->unique_count + 1);
     int *entry_size = XCNEWVEC (int, c->unique_count + 1);
     int stringi = 0;
 
-    occupied_buckets = 0;
+    total_probe_length = 0;
 
     for (b = 0; b < c->num_buckets; b++)
-      {
-	struct bstring *s = c->bucket[b];
-
-	chain_length[b] = 0;
-
-	if (s)
-	  {
-	    occupied_buckets++;
-	    
-	    while (s)
-	      {
-		gdb_assert (b < c->num_buckets);
-		chain_length[b]++;
-		gdb_assert (stringi < c->unique_count);
-		entry_size[stringi++] = s->length;
-		s = s->next;
-	      }
-	  }
-      }
+      if (c->tags[b] != 0)
+	{
+	  unsigned int home = bstring_home (c->bucket[b]->hash,
+					    c->num_buckets);
+
+	  gdb_assert (stringi < c->unique_count);
+	  probe_length[stringi] = ((b >= home ? b - home
+				    : b + c->num_buckets - home) + 1);
+	  total_probe_length += probe_length[stringi];
+	  entry_size[stringi++] = c->bucket[b]->length;
+	}
 
-    /* To compute the median, we need the set of chain lengths
+    /* To compute the median, we need the set of probe lengths
        sorted.  */
-    qsort (chain_length, c->num_buckets, sizeof (chain_length[0]),
+    qsort (probe_length, c->unique_count, sizeof (probe_length[0]),
 	   compare_positive_ints);
     qsort (entry_size, c->unique_count, sizeof (entry_size[0]),
 	   compare_positive_ints);
 
-    if (c->num_buckets > 0)
-      {
-	max_chain_length = chain_length[c->num_buckets - 1];
-	median_chain_length = chain_length[c->num_buckets / 2];
-      }
-    else
-      {
-	max_chain_length = 0;
-	median_chain_length = 0;
-      }
     if (c->unique_count > 0)
       {
+	max_probe_length = probe_length[c->unique_count - 1];
+	median_probe_length = probe_length[c->unique_count / 2];
 	max_entry_size = entry_size[c->unique_count - 1];
 	median_entry_size = entry_size[c->unique_count / 2];
       }
     else
       {
+	max_probe_length = 0;
+	median_probe_length = 0;
 	max_entry_size = 0;
 	median_entry_size = 0;
       }
 
-    xfree (chain_length);
+    xfree (probe_length);
     xfree (entry_size);
   }
 
@@ -464,21 +501,22 @@ Total memory used by bcache, including overhead: %ld\n"),
   printf_filtered (_("    Hash table expands:        %lu\n"),
 		   c->expand_count);
   printf_filtered (_("    Hash table hashes:         %lu\n"),
-		   c->total_count + c->expand_hash_count);
-  printf_filtered (_("    Half hash misses:          %lu\n"),
-		   c->half_hash_miss_count);
+		   c->total_count);
+  printf_filtered (_("    Hash tag misses:           %lu\n"),
+		   c->tag_miss_count);
   printf_filtered (_("    Hash table population:     "));
-  print_percentage (occupied_buckets, c->num_buckets);
-  printf_filtered (_("    Median hash chain length:  %3d\n"),
-		   median_chain_length);
-  printf_filtered (_("    Average hash chain length: "));
-  if (c->num_buckets > 0)
-    printf_filtered ("%3lu\n", c->unique_count / c->num_buckets);
+  print_percentage (c->unique_count, c->num_buckets);
+  printf_filtered (_("    Median probe length:       %3d\n"),
+		   median_probe_length);
+  printf_filtered (_("    Average probe length:      "));
+  if (c->unique_count > 0)
+    printf_filtered ("%5.2f\n",
+		     (double) total_probe_length / c->unique_count);
   else
-    /* i18n: "Average hash chain length: (not applicable)".  */
+    /* i18n: "Average probe length: (not applicable)".  */
     printf_filtered (_("(not applicable)\n"));
-  printf_filtered (_("    Maximum hash chain length: %3d\n"), 
-		   max_chain_length);
+  printf_filtered (_("    Maximum probe length:      %3d\n"),
+		   max_probe_length);
   printf_filtered ("\n");
 }
 
@@ -62,77 +62,47 @@
    sharing its space with future duplicates.
 
 
-   Size of bcache VS hashtab:
+   Layout of the bcache:
 
-   For bcache, the most critical cost is size (or more exactly the
-   overhead added by the bcache).  It turns out that the bcache is
-   remarkably efficient.
+   The bcache once chained its strings in buckets, and hashed their
+   bytes one at a time.  Both showed up when loading large programs:
+   following a chain touches a string for every step, and growing the
+   table rehashed every string.
 
-   Assuming a 32-bit system (the hash table slots are 4 bytes),
-   ignoring alignment, and limit strings to 255 bytes (1 byte length)
-   we get ...
-
-   bcache: This uses a separate linked list to track the hash chain.
-   The numbers show roughly 100% occupancy of the hash table and an
-   average chain length of 4.  Spreading the slot cost over the 4
-   chain elements:
-
-   4 (slot) / 4 (chain length) + 1 (length) + 4 (chain) = 6 bytes
-
-   hashtab: This uses a more traditional re-hash algorithm where the
-   chain is maintained within the hash table.  The table occupancy is
-   kept below 75% but we'll assume its perfect:
-
-   4 (slot) x 4/3 (occupancy) +  1 (length) = 6 1/3 bytes
-
-   So a perfect hashtab has just slightly larger than an average
-   bcache.
-
-   It turns out that an average hashtab is far worse.  Two things
-   hurt:
-
-   - Hashtab's occupancy is more like 50% (it ranges between 38% and
-   75%) giving a per slot cost of 4x2 vs 4x4/3.
-
-   - the string structure needs to be aligned to 8 bytes which for
-   hashtab wastes 7 bytes, while for bcache wastes only 3.
-
-   This gives:
-
-   hashtab: 4 x 2 + 1 + 7 = 16 bytes
-
-   bcache 4 / 4 + 1 + 4 + 3 = 9 bytes
-
-   The numbers of GDB debugging GDB support this.  ~40% vs ~70% overhead.
-
-
-   Speed of bcache VS hashtab (the half hash hack):
-
-   While hashtab has a typical chain length of 1, bcache has a chain
-   length of round 4.  This means that the bcache will require
-   something like double the number of compares after that initial
-   hash.  In both cases the comparison takes the form:
+   The table now uses open addressing with linear probing.  Each slot
+   holds a pointer to the string and, in a separate dense array, a
+   one-byte tag made of 7 bits of the string's hash value.  A search
+   only reads tags until one matches, and then compares the full
+   32-bit hash value, which the string keeps in what would otherwise
+   be padding after its length, and finally
 
    a.length == b.length && memcmp (a.data, b.data, a.length) == 0
 
-   That is lengths are checked before doing the memcmp.
-
-   For GDB debugging GDB, it turned out that all lengths were 24 bytes
-   (no C++ so only psymbols were cached) and hence, all compares
-   required a call to memcmp.  As a hack, two bytes of padding
-   (mentioned above) are used to store the upper 16 bits of the
-   string's hash value and then that is used in the comparison vis:
-
-   a.half_hash == b.half_hash && a.length == b.length && memcmp
-   (a.data, b.data, a.length)
-
-   The numbers from GDB debugging GDB show this to be a remarkable
-   100% effective (only necessary length and memcmp tests being
-   performed).
-
-   Mind you, looking at the wall clock, the same GDB debugging GDB
-   showed only marginal speed up (0.780 vs 0.773s).  Seems GDB is too
-   busy doing something else :-(
+   which almost never fails.  The home slot of a string is its hash
+   value scaled to the table size, so growing the table moves the
+   strings without hashing them again.  The strings themselves no
+   longer need a chain pointer.
+
+   Since probes mostly read one-byte tags, long probe sequences are
+   cheap, and the table is let fill up to 7/8 of its slots.  It then
+   grows by a quarter rather than doubling, which is what the scaling
+   of hash values to the table size allows, so that it is never less
+   than 7/10 full.  Assuming a 64-bit host, and strings aligned to 8
+   bytes, this costs
+
+   (1 (tag) + 8 (slot)) x 8/7 to 10/7 (occupancy) + 8 (length and
+   hash) = 18.3 to 20.9 bytes
+
+   for each unique string, against 8 / 5 to 8 / 2.5 (slot) + 8
+   (chain) + 8 (length and half hash) = 17.6 to 19.2 bytes for the
+   chained table, which grew when its chains reached 5 strings on
+   average.  For example, the partial symbol cache of a program with
+   128k partial symbols takes 4.52MB, against 4.36MB with the chained
+   table.  Doubling the table instead would cost up to 28.6 bytes for
+   each string.  Growing by a quarter moves each string four times on
+   average, but "maint intern-psymbols" on that program is still 25%
+   faster than with the chained table.  The hash function reads the
+   strings a word at a time.
   
 */
 
@@ -168,7 +138,8 @@ extern struct bcache *bcache_xmalloc (
 extern void print_bcache_statistics (struct bcache *bcache, char *type);
 extern int bcache_memory_used (struct bcache *bcache);
 
-/* The hash functions */
+/* The hash functions.  These read the bytes a word at a time; the
+   value for a given string depends on the host's byte order.  */
 extern unsigned long hash(const void *addr, int length);
 extern unsigned long hash_continue (const void *addr, int length,
                                     unsigned long h);
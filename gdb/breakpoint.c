@@ -975,6 +975,19 @@ get_first_locp_gte_addr (CORE_ADDR address)
   return locp_found;
 }
 
+/* Free the bytecode GDB uses to evaluate the condition of LOC, so that
+   it is compiled again from the new condition the next time it is
+   checked.  */
+
+static void
+clear_host_cond_bytecode (struct bp_location *loc)
+{
+  if (loc->host_cond_bytecode != NULL)
+    free_agent_expr (loc->host_cond_bytecode);
+  loc->host_cond_bytecode = NULL;
+  loc->host_cond_bytecode_tried = 0;
+}
+
 void
 set_breakpoint_condition (struct breakpoint *b, const char *exp,
 			  int from_tty)
@@ -997,6 +1010,7 @@ set_breakpoint_condition (struct breakpoint *b, const char *exp,
 	{
 	  xfree (loc->cond);
 	  loc->cond = NULL;
+	  clear_host_cond_bytecode (loc);
 
 	  /* No need to free the condition agent expression
 	     bytecode (if we have one).  We will handle this
@@ -5438,6 +5452,103 @@ bpstat_check_watchpoint (bpstat bs)
     }
 }
 
+/* Non-zero if GDB evaluates the breakpoint conditions it can compile
+   to agent expression bytecode without building values.  */
+
+static int breakpoint_condition_bytecode = 1;
+
+/* Implement the "maint show breakpoint-condition-bytecode" command.  */
+
+static void
+show_breakpoint_condition_bytecode (struct ui_file *file, int from_tty,
+				    struct cmd_list_element *c,
+				    const char *value)
+{
+  fprintf_filtered (file,
+		    _("Whether GDB evaluates simple breakpoint conditions "
+		      "as bytecode is %s.\n"),
+		    value);
+}
+
+/* When non-zero, report the breakpoint conditions evaluated as
+   bytecode.  */
+
+static unsigned int debug_breakpoint_bytecode;
+
+/* Implement the "show debug breakpoint-bytecode" command.  */
+
+static void
+show_debug_breakpoint_bytecode (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("Breakpoint condition bytecode debugging is %s.\n"),
+		    value);
+}
+
+/* Try to evaluate the condition of BL, a breakpoint location, in the
+   current frame without building values: conditions such as "i == 10"
+   or "p->len > n" are compiled once to the agent expression bytecode
+   also used for target-side conditions, and the bytecode is then run
+   directly on the registers and memory of the inferior.  Return
+   non-zero and set *VALUE_IS_ZERO on success, or return zero if the
+   caller must evaluate the condition as usual.  */
+
+static int
+breakpoint_cond_eval_bytecode (struct bp_location *bl, int *value_is_zero)
+{
+  struct frame_info *frame;
+  ULONGEST result = 0;
+  int ok = 0;
+
+  if (!breakpoint_condition_bytecode)
+    return 0;
+
+  if (!bl->host_cond_bytecode_tried)
+    {
+      bl->host_cond_bytecode_tried = 1;
+      bl->host_cond_bytecode = parse_cond_to_aexpr (bl->address, bl->cond);
+      if (bl->host_cond_bytecode != NULL
+	  && !ax_eval_on_host_p (bl->host_cond_bytecode))
+	{
+	  free_agent_expr (bl->host_cond_bytecode);
+	  bl->host_cond_bytecode = NULL;
+	}
+    }
+
+  if (bl->host_cond_bytecode == NULL)
+    return 0;
+
+  /* The bytecode reads the registers of the frame it was compiled
+     for, at the location's address.  */
+  frame = get_current_frame ();
+  if (get_frame_type (frame) != NORMAL_FRAME
+      || get_frame_pc (frame) != bl->address)
+    return 0;
+
+  TRY
+    {
+      ok = ax_eval_on_host (bl->host_cond_bytecode, get_current_regcache (),
+			    &result);
+    }
+  CATCH (ex, RETURN_MASK_ERROR)
+    {
+      ok = 0;
+    }
+  END_CATCH
+
+  if (ok)
+    {
+      if (debug_breakpoint_bytecode)
+	fprintf_unfiltered (gdb_stdlog,
+			    "Condition of breakpoint %d evaluated as "
+			    "bytecode: %s\n",
+			    bl->owner->number, pulongest (result));
+      *value_is_zero = (result == 0);
+    }
+  return ok;
+}
+
 /* For breakpoints that are currently marked as telling gdb to stop,
    check conditions (condition proper, frame, thread and ignore count)
    of breakpoint referred to by BS.  If we should not stop for this
@@ -5446,7 +5557,7 @@ bpstat_check_watchpoint (bpstat bs)
 static void
 bpstat_check_breakpoint_conditions (bpstat bs, ptid_t ptid)
 {
-  const struct bp_location *bl;
+  struct bp_location *bl;
   struct breakpoint *b;
   int value_is_zero = 0;
   struct expression *cond;
@@ -5544,10 +5655,14 @@ bpstat_check_breakpoint_conditions (bpstat bs, ptid_t ptid)
 	    within_current_scope = 0;
 	}
       if (within_current_scope)
-	value_is_zero
-	  = catch_errors (breakpoint_cond_eval, cond,
-			  "Error in testing breakpoint condition:\n",
-			  RETURN_MASK_ALL);
+	{
+	  if (w != NULL
+	      || !breakpoint_cond_eval_bytecode (bl, &value_is_zero))
+	    value_is_zero
+	      = catch_errors (breakpoint_cond_eval, cond,
+			      "Error in testing breakpoint condition:\n",
+			      RETURN_MASK_ALL);
+	}
       else
 	{
 	  warning (_("Watchpoint condition cannot be tested "
@@ -7324,6 +7439,7 @@ init_bp_location (struct bp_location *loc, const struct bp_location_ops *ops,
   loc->owner = owner;
   loc->cond = NULL;
   loc->cond_bytecode = NULL;
+  loc->host_cond_bytecode = NULL;
   loc->shlib_disabled = 0;
   loc->enabled = 1;
 
@@ -12879,6 +12995,8 @@ bp_location_dtor (struct bp_location *self)
   xfree (self->cond);
   if (self->cond_bytecode)
     free_agent_expr (self->cond_bytecode);
+  if (self->host_cond_bytecode)
+    free_agent_expr (self->host_cond_bytecode);
   xfree (self->function_name);
 
   VEC_free (agent_expr_p, self->target_info.conditions);
@@ -16617,6 +16735,29 @@ when execution stops."),
 				&breakpoint_set_cmdlist,
 				&breakpoint_show_cmdlist);
 
+  add_setshow_boolean_cmd ("breakpoint-condition-bytecode", class_maintenance,
+			   &breakpoint_condition_bytecode, _("\
+Set whether GDB evaluates simple breakpoint conditions as bytecode."), _("\
+Show whether GDB evaluates simple breakpoint conditions as bytecode."), _("\
+When on, breakpoint conditions evaluated by GDB that only compute integer\n\
+values from variables, registers and constants are compiled to agent\n\
+expression bytecode, which GDB runs directly on the inferior's registers\n\
+and memory instead of evaluating the expression."),
+			   NULL,
+			   show_breakpoint_condition_bytecode,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_setshow_zuinteger_cmd ("breakpoint-bytecode", class_maintenance,
+			     &debug_breakpoint_bytecode, _("\
+Set debugging of breakpoint conditions evaluated as bytecode."), _("\
+Show debugging of breakpoint conditions evaluated as bytecode."), _("\
+When non-zero, GDB reports each breakpoint condition it evaluates\n\
+as bytecode, and the result."),
+			     NULL,
+			     show_debug_breakpoint_bytecode,
+			     &setdebuglist, &showdebuglist);
+
   add_setshow_enum_cmd ("condition-evaluation", class_breakpoint,
 			condition_evaluation_enums,
 			&condition_evaluation_mode_1, _("\
@@ -338,6 +338,16 @@ struct bp_location
      condition evaluation.  */
   struct agent_expr *cond_bytecode;
 
+  /* Conditional expression in agent expression bytecode form, for
+     evaluation by GDB itself without building values.  Compiled from
+     COND the first time the condition is checked; NULL if COND cannot
+     be compiled, or has not been checked yet.  */
+  struct agent_expr *host_cond_bytecode;
+
+  /* Non-zero if we already tried to compile COND into
+     HOST_COND_BYTECODE.  */
+  char host_cond_bytecode_tried;
+
   /* Signals that the condition has changed since the last time
      we updated the global location list.  This means the condition
      needs to be sent to the target again.  This is used together
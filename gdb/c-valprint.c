@@ -567,6 +567,7 @@ c_value_print (struct value *val, struct ui_file *stream,
   struct type *type, *real_type, *val_type;
   int full, top, using_enc;
   struct value_print_options opts = *options;
+  const gdb_byte *valaddr = NULL;
 
   opts.deref_ref = 1;
 
@@ -686,7 +687,10 @@ c_value_print (struct value *val, struct ui_file *stream,
       /* Otherwise, we end up at the return outside this "if".  */
     }
 
-  val_print (val_type, value_contents_for_printing (val),
+  if (!val_print_array_streaming_p (val, &opts, current_language))
+    valaddr = value_contents_for_printing (val);
+
+  val_print (val_type, valaddr,
 	     value_embedded_offset (val),
 	     value_address (val),
 	     stream, 0,
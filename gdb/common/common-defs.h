@@ -85,4 +85,12 @@
 # define EXTERN_C_POP
 #endif
 
+/* Storage class of the global state that every thread running GDB
+   code needs its own copy of, such as the chain of cleanups.  */
+#ifdef HAVE_WORKER_THREADS
+# define GDB_THREAD_LOCAL __thread
+#else
+# define GDB_THREAD_LOCAL
+#endif
+
 #endif /* COMMON_DEFS_H */
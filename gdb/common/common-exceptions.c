@@ -54,8 +54,8 @@ struct catcher
   struct catcher *prev;
 };
 
-/* Where to go for throw_exception().  */
-static struct catcher *current_catcher;
+/* Where to go for throw_exception().  Each thread has its own.  */
+static GDB_THREAD_LOCAL struct catcher *current_catcher;
 
 /* Return length of current_catcher list.  */
 
@@ -218,7 +218,7 @@ exceptions_state_mc_action_iter_1 (void)
 /* How many nested TRY blocks we have.  See exception_messages and
    throw_it.  */
 
-static int try_scope_depth;
+static GDB_THREAD_LOCAL int try_scope_depth;
 
 /* Called on entry to a TRY scope.  */
 
@@ -309,10 +309,10 @@ throw_exception (struct gdb_exception exception)
    This is indexed by the size of the current_catcher list.
    It is a dynamically allocated array so that we don't care how deeply
    GDB nests its TRY_CATCHs.  */
-static char **exception_messages;
+static GDB_THREAD_LOCAL char **exception_messages;
 
 /* The number of currently allocated entries in exception_messages.  */
-static int exception_messages_size;
+static GDB_THREAD_LOCAL int exception_messages_size;
 
 static void ATTRIBUTE_NORETURN ATTRIBUTE_PRINTF (3, 0)
 throw_it (enum return_reason reason, enum errors error, const char *fmt,
@@ -354,6 +354,20 @@ throw_it (enum return_reason reason, enum errors error, const char *fmt,
   throw_exception (e);
 }
 
+/* See common-exceptions.h.  */
+
+void
+free_exception_messages (void)
+{
+  int i;
+
+  for (i = 0; i < exception_messages_size; i++)
+    xfree (exception_messages[i]);
+  xfree (exception_messages);
+  exception_messages = NULL;
+  exception_messages_size = 0;
+}
+
 void
 throw_verror (enum errors error, const char *fmt, va_list ap)
 {
@@ -298,6 +298,12 @@ extern void throw_error (enum errors error, const char *fmt, ...)
 extern void throw_quit (const char *fmt, ...)
      ATTRIBUTE_NORETURN ATTRIBUTE_PRINTF (1, 2);
 
+/* Free the messages of the exceptions thrown by the calling thread.
+   A thread other than the main one calls this before exiting, once
+   it throws no more exceptions.  */
+
+extern void free_exception_messages (void);
+
 /* A pre-defined non-exception.  */
 extern const struct gdb_exception exception_none;
 
@@ -21,6 +21,7 @@
 #include "complaints.h"
 #include "command.h"
 #include "gdbcmd.h"
+#include "worker-threads.h"
 
 extern void _initialize_complaints (void);
 
@@ -160,11 +161,19 @@ vcomplaint (struct complaints **c, const char *file,
 	    int line, const char *fmt,
 	    va_list args)
 {
-  struct complaints *complaints = get_complaints (c);
-  struct complain *complaint = find_complaint (complaints, file, 
-					       line, fmt);
+  struct complaints *complaints;
+  struct complain *complaint;
   enum complaint_series series;
 
+  /* Complaints are only issued by the main thread: a work item of a
+     worker thread gives up instead, and is then redone by the main
+     thread.  */
+  if (worker_thread_p ())
+    error (_("complaint issued by a worker thread"));
+
+  complaints = get_complaints (c);
+  complaint = find_complaint (complaints, file, line, fmt);
+
   gdb_assert (complaints != NULL);
 
   complaint->counter++;
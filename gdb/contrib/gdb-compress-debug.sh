@@ -0,0 +1,72 @@
+#! /bin/sh
+
+# Compress the debug sections of a file in chunks that GDB can
+# decompress in parallel.
+
+# Copyright (C) 2016 Free Software Foundation, Inc.
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This program assumes gdb and objcopy are in $PATH.
+# If not, or you want others, pass the following in the environment
+GDB=${GDB:=gdb}
+OBJCOPY=${OBJCOPY:=objcopy}
+
+myname="${0##*/}"
+
+if test $# != 1; then
+    echo "usage: $myname FILE" 1>&2
+    exit 1
+fi
+
+file="$1"
+
+if test ! -r "$file"; then
+    echo "$myname: unable to access: $file" 1>&2
+    exit 1
+fi
+
+dir="${file%/*}"
+test "$dir" = "$file" && dir="."
+index="${file}.gdb_zchunks"
+
+rm -f "$index" "$file".zdebug_*
+# Ensure intermediate files are removed when we exit.
+trap 'rm -f "$index" "$file".zdebug_*' 0
+
+$GDB --batch -nx -iex 'set auto-load no' \
+    -ex "file $file" -ex "save compressed-debug-sections $dir" || {
+    # Just in case.
+    status=$?
+    echo "$myname: gdb error compressing debug sections of $file" 1>&2
+    exit $status
+}
+
+# Like gdb-add-index.sh, do nothing if gdb found no debug sections.
+status=0
+
+if test -f "$index"; then
+    set -- --remove-section .gdb_zchunks --add-section .gdb_zchunks="$index"
+    for section in "$file".zdebug_*; do
+	zname=".zdebug_${section##*.zdebug_}"
+	name=".debug_${section##*.zdebug_}"
+	set -- "$@" --remove-section "$name" --remove-section "$zname" \
+	    --add-section "$zname"="$section"
+    done
+    $OBJCOPY "$@" "$file" "$file"
+    status=$?
+else
+    echo "$myname: No debug sections were compressed for $file" 1>&2
+fi
+
+exit $status
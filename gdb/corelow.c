@@ -45,6 +45,15 @@
 #include "gdb_bfd.h"
 #include "completer.h"
 #include "filestuff.h"
+#include "gcore.h"
+#include <sys/stat.h>
+#include <zlib.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#ifndef MAP_FAILED
+#define MAP_FAILED ((void *) -1)
+#endif
+#endif
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -74,6 +83,125 @@ static struct gdbarch *core_gdbarch = NULL;
    unix child targets.  */
 static struct target_section_table *core_data;
 
+/* The core file mapped into GDB's address space, or NULL if it could
+   not be mapped.  Reads of the core's contents are served from here
+   when possible, which avoids going through BFD's stdio reads and
+   shares the pages with any other process mapping the same core.  */
+static const gdb_byte *core_mapping;
+static size_t core_mapping_size;
+
+/* A memory segment of the core file.  */
+
+struct core_segment
+{
+  /* The range of target addresses the segment covers.  */
+  CORE_ADDR addr;
+  CORE_ADDR endaddr;
+
+  /* The core file section holding the segment.  */
+  struct bfd_section *section;
+
+  /* The start of the segment's contents in CORE_MAPPING, or NULL if
+     they must be read through BFD.  Only the first CONTENTS_LEN bytes
+     are mapped; the rest, such as the part of a segment that runs
+     past the end of a truncated core file, is read through BFD.  */
+  const gdb_byte *contents;
+  ULONGEST contents_len;
+};
+
+/* The memory segments of the core file, sorted by address, so that
+   the segment holding an address can be found by a binary search
+   instead of a linear scan of CORE_DATA.  NULL if the segments
+   overlap, in which case the section table is used.  */
+static struct core_segment *core_segments;
+static int core_num_segments;
+
+/* A memory segment whose contents are compressed in a core file
+   written by "gcore -z".  See gcore.h for the format.  */
+
+struct core_zsegment
+{
+  /* The range of target addresses the segment covers.  */
+  CORE_ADDR addr;
+  CORE_ADDR endaddr;
+
+  /* Index in CORE_ZBLOCKS of the segment's first block.  */
+  ULONGEST first_block;
+};
+
+/* A block of a compressed memory segment.  */
+
+struct core_zblock
+{
+  /* Offset of the block's data in CORE_ZSECTION, and its size.  */
+  ULONGEST offset;
+  ULONGEST size;
+
+  enum zcore_block_kind kind;
+};
+
+/* The core file section holding compressed memory contents, or NULL
+   if the core has none.  */
+static struct bfd_section *core_zsection;
+
+/* The compressed memory segments, sorted by address, and their
+   blocks.  */
+static struct core_zsegment *core_zsegments;
+static ULONGEST core_num_zsegments;
+static struct core_zblock *core_zblocks;
+static ULONGEST core_num_zblocks;
+
+/* The size of the uncompressed blocks; only the last block of a
+   segment may be shorter.  */
+static ULONGEST core_zblock_size;
+
+/* A cache of decompressed blocks, so that consecutive small reads
+   do not each decompress a whole block.  Block N can only be held in
+   entry N % CORE_ZCACHE_SIZE.  */
+
+#define CORE_ZCACHE_SIZE 8
+
+struct core_zcache_entry
+{
+  int valid;
+  ULONGEST block;
+
+  /* The buffer holding the block, and its size.  */
+  gdb_byte *data;
+  ULONGEST data_size;
+};
+
+/* zlib never expands data by more than this factor.  A compressed
+   block claiming to hold more is invalid.  */
+#define ZLIB_MAX_EXPANSION 1032
+
+static struct core_zcache_entry core_zcache[CORE_ZCACHE_SIZE];
+
+/* A register note of the core file: the section holding register set
+   NAME of thread LWP, as BFD names it "NAME/LWP", or just "NAME" when
+   LWP is zero.  */
+
+struct core_reg_note
+{
+  long lwp;
+
+  /* The register set name, which is not NUL-terminated when it
+     points into a section name with an LWP suffix.  */
+  const char *name;
+  size_t name_len;
+
+  struct bfd_section *section;
+
+  /* The note's contents in CORE_MAPPING, or NULL if they must be read
+     through BFD.  */
+  const gdb_byte *contents;
+};
+
+/* The register notes of the core file, so that fetching the registers
+   of a thread neither formats and looks up section names nor reads
+   the notes through BFD.  */
+static htab_t core_reg_notes;
+
 static void core_files_info (struct target_ops *);
 
 static struct core_fns *sniff_core_bfd (bfd *);
@@ -84,8 +212,12 @@ static void core_close (struct target_ops *self);
 
 static void core_close_cleanup (void *ignore);
 
+static void free_core_zsegment_index (void);
+
 static void add_to_thread_list (bfd *, asection *, void *);
 
+static void build_core_reg_note_table (void);
+
 static void init_core_ops (void);
 
 void _initialize_corelow (void);
@@ -208,6 +340,25 @@ core_close (struct target_ops *self)
 	  core_data = NULL;
 	}
 
+      xfree (core_segments);
+      core_segments = NULL;
+      core_num_segments = 0;
+
+      free_core_zsegment_index ();
+
+      if (core_reg_notes != NULL)
+	{
+	  htab_delete (core_reg_notes);
+	  core_reg_notes = NULL;
+	}
+
+#ifdef HAVE_MMAP
+      if (core_mapping != NULL)
+	munmap ((void *) core_mapping, core_mapping_size);
+#endif
+      core_mapping = NULL;
+      core_mapping_size = 0;
+
       gdb_bfd_unref (core_bfd);
       core_bfd = NULL;
     }
@@ -221,6 +372,606 @@ core_close_cleanup (void *ignore)
   core_close (NULL);
 }
 
+/* Map the whole of the core file into GDB's address space, setting
+   CORE_MAPPING.  Nothing is mapped if the core is open for writing,
+   since writes go through BFD.  */
+
+static void
+core_map_file (void)
+{
+#ifdef HAVE_MMAP
+  struct stat st;
+  int fd;
+
+  if (write_files
+      || core_bfd->origin != 0
+      || (core_bfd->flags & BFD_IN_MEMORY) != 0)
+    return;
+
+  fd = gdb_open_cloexec (bfd_get_filename (core_bfd),
+			 O_RDONLY | O_BINARY | O_LARGEFILE, 0);
+  if (fd < 0)
+    return;
+
+  if (fstat (fd, &st) == 0
+      && st.st_size > 0
+      && (off_t) (size_t) st.st_size == st.st_size)
+    {
+      void *base = mmap (NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+      if (base != MAP_FAILED)
+	{
+	  core_mapping = (const gdb_byte *) base;
+	  core_mapping_size = st.st_size;
+	}
+    }
+
+  close (fd);
+#endif /* HAVE_MMAP */
+}
+
+/* Return a pointer to the SIZE bytes at file offset FILEPOS of the
+   core file in CORE_MAPPING, or NULL if they are not mapped.  */
+
+static const gdb_byte *
+core_mapped_contents (file_ptr filepos, bfd_size_type size)
+{
+  if (core_mapping == NULL
+      || filepos < 0
+      || (ULONGEST) filepos > core_mapping_size
+      || size > core_mapping_size - (ULONGEST) filepos)
+    return NULL;
+
+  return core_mapping + filepos;
+}
+
+/* qsort comparison function for struct core_segment.  */
+
+static int
+compare_core_segments (const void *a, const void *b)
+{
+  const struct core_segment *sa = (const struct core_segment *) a;
+  const struct core_segment *sb = (const struct core_segment *) b;
+
+  if (sa->addr < sb->addr)
+    return -1;
+  if (sa->addr > sb->addr)
+    return 1;
+  return 0;
+}
+
+/* Build CORE_SEGMENTS from the core's section table.  */
+
+static void
+build_core_segment_index (void)
+{
+  struct core_segment *segments;
+  struct target_section *p;
+  int n = 0;
+  int i;
+
+  segments = XNEWVEC (struct core_segment,
+		      core_data->sections_end - core_data->sections);
+
+  for (p = core_data->sections; p < core_data->sections_end; p++)
+    {
+      struct bfd_section *asect = p->the_bfd_section;
+      struct core_segment *seg;
+
+      if (p->endaddr <= p->addr)
+	continue;
+
+      seg = &segments[n++];
+      seg->addr = p->addr;
+      seg->endaddr = p->endaddr;
+      seg->section = asect;
+      seg->contents = NULL;
+      seg->contents_len = 0;
+      if ((bfd_get_section_flags (core_bfd, asect) & SEC_HAS_CONTENTS) != 0
+	  && core_mapping != NULL
+	  && asect->filepos >= 0
+	  && (ULONGEST) asect->filepos < core_mapping_size)
+	{
+	  ULONGEST len = p->endaddr - p->addr;
+
+	  /* Never map more than the section holds, nor more than the
+	     file holds: touching pages past the end of the file would
+	     raise SIGBUS.  */
+	  if (len > bfd_section_size (core_bfd, asect))
+	    len = bfd_section_size (core_bfd, asect);
+	  if (len > core_mapping_size - (ULONGEST) asect->filepos)
+	    len = core_mapping_size - (ULONGEST) asect->filepos;
+
+	  seg->contents = core_mapped_contents (asect->filepos, len);
+	  if (seg->contents != NULL)
+	    seg->contents_len = len;
+	}
+    }
+
+  qsort (segments, n, sizeof (struct core_segment), compare_core_segments);
+
+  /* If segments overlap, which one is read depends on the order of
+     the section table; leave the lookup to it.  */
+  for (i = 1; i < n; i++)
+    if (segments[i].addr < segments[i - 1].endaddr)
+      {
+	xfree (segments);
+	return;
+      }
+
+  core_segments = segments;
+  core_num_segments = n;
+}
+
+/* Read core memory at OFFSET, using CORE_SEGMENTS.  Like
+   section_table_xfer_memory_partial, this reads at most up to the end
+   of the segment holding OFFSET.  */
+
+static enum target_xfer_status
+core_segment_xfer_memory (gdb_byte *readbuf, ULONGEST offset,
+			  ULONGEST len, ULONGEST *xfered_len)
+{
+  struct core_segment *seg;
+  int lo = 0;
+  int hi = core_num_segments;
+
+  /* Find the last segment that starts at or before OFFSET.  */
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (core_segments[mid].addr <= offset)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if (lo == 0)
+    return TARGET_XFER_EOF;
+
+  seg = &core_segments[lo - 1];
+  if (offset >= seg->endaddr)
+    return TARGET_XFER_EOF;
+
+  if (len > seg->endaddr - offset)
+    len = seg->endaddr - offset;
+
+  if (seg->contents != NULL && offset - seg->addr < seg->contents_len)
+    {
+      if (len > seg->contents_len - (offset - seg->addr))
+	len = seg->contents_len - (offset - seg->addr);
+      memcpy (readbuf, seg->contents + (offset - seg->addr), len);
+    }
+  else if (!bfd_get_section_contents (core_bfd, seg->section, readbuf,
+				      offset - seg->addr, len))
+    return TARGET_XFER_EOF;
+
+  *xfered_len = len;
+  return TARGET_XFER_OK;
+}
+
+/* Free the compressed memory segment index and block cache.  */
+
+static void
+free_core_zsegment_index (void)
+{
+  int i;
+
+  xfree (core_zsegments);
+  core_zsegments = NULL;
+  core_num_zsegments = 0;
+  xfree (core_zblocks);
+  core_zblocks = NULL;
+  core_num_zblocks = 0;
+  core_zsection = NULL;
+  core_zblock_size = 0;
+
+  for (i = 0; i < CORE_ZCACHE_SIZE; i++)
+    {
+      xfree (core_zcache[i].data);
+      core_zcache[i].data = NULL;
+      core_zcache[i].data_size = 0;
+      core_zcache[i].valid = 0;
+    }
+}
+
+/* qsort comparison function for struct core_zsegment.  */
+
+static int
+compare_core_zsegments (const void *a, const void *b)
+{
+  const struct core_zsegment *sa = (const struct core_zsegment *) a;
+  const struct core_zsegment *sb = (const struct core_zsegment *) b;
+
+  if (sa->addr < sb->addr)
+    return -1;
+  if (sa->addr > sb->addr)
+    return 1;
+  return 0;
+}
+
+/* Read and validate the header and tables of the compressed memory
+   contents in section ASECT of the core, filling in the compressed
+   segment index.  Return non-zero on success.  On failure, the index
+   is left empty.  */
+
+static int
+read_core_zsection (struct bfd_section *asect)
+{
+  bfd_size_type size = bfd_section_size (core_bfd, asect);
+  gdb_byte header[ZCORE_HEADER_SIZE];
+  ULONGEST nsegments, nblocks, tables_size, i;
+  ULONGEST max_seg_size = 0;
+  struct cleanup *back_to;
+  const gdb_byte *p;
+  gdb_byte *tables;
+  int valid = 1;
+
+  if (!bfd_get_section_contents (core_bfd, asect, header, 0,
+				 ZCORE_HEADER_SIZE))
+    return 0;
+
+  if (bfd_getl32 (header + 8) != ZCORE_VERSION)
+    return 0;
+  core_zblock_size = bfd_getl32 (header + 12);
+  nsegments = bfd_getl64 (header + 16);
+  nblocks = bfd_getl64 (header + 24);
+  if (core_zblock_size == 0
+      || nsegments > (size - ZCORE_HEADER_SIZE) / ZCORE_SEGMENT_ENTRY_SIZE
+      || nblocks > ((size - ZCORE_HEADER_SIZE
+		     - nsegments * ZCORE_SEGMENT_ENTRY_SIZE)
+		    / ZCORE_BLOCK_ENTRY_SIZE))
+    {
+      free_core_zsegment_index ();
+      return 0;
+    }
+
+  tables_size = (nsegments * ZCORE_SEGMENT_ENTRY_SIZE
+		 + nblocks * ZCORE_BLOCK_ENTRY_SIZE);
+  tables = (gdb_byte *) xmalloc (tables_size);
+  back_to = make_cleanup (xfree, tables);
+  if (!bfd_get_section_contents (core_bfd, asect, tables,
+				 ZCORE_HEADER_SIZE, tables_size))
+    {
+      do_cleanups (back_to);
+      free_core_zsegment_index ();
+      return 0;
+    }
+
+  core_zsegments = XNEWVEC (struct core_zsegment, nsegments);
+  core_num_zsegments = nsegments;
+  core_zblocks = XNEWVEC (struct core_zblock, nblocks);
+  core_num_zblocks = nblocks;
+
+  p = tables;
+  for (i = 0; i < nsegments; i++, p += ZCORE_SEGMENT_ENTRY_SIZE)
+    {
+      struct core_zsegment *zseg = &core_zsegments[i];
+      ULONGEST seg_size = bfd_getl64 (p + 8);
+      ULONGEST seg_blocks = (seg_size / core_zblock_size
+			     + (seg_size % core_zblock_size != 0));
+
+      zseg->addr = bfd_getl64 (p);
+      zseg->endaddr = zseg->addr + seg_size;
+      zseg->first_block = bfd_getl64 (p + 16);
+      if (zseg->endaddr < zseg->addr
+	  || zseg->first_block > nblocks
+	  || seg_blocks > nblocks - zseg->first_block)
+	valid = 0;
+      if (seg_size > max_seg_size)
+	max_seg_size = seg_size;
+    }
+
+  for (i = 0; i < nblocks; i++, p += ZCORE_BLOCK_ENTRY_SIZE)
+    {
+      struct core_zblock *block = &core_zblocks[i];
+
+      block->offset = bfd_getl64 (p);
+      block->size = bfd_getl32 (p + 8);
+      block->kind = (enum zcore_block_kind) bfd_getl32 (p + 12);
+      if (block->kind != ZCORE_BLOCK_ZERO
+	  && block->kind != ZCORE_BLOCK_STORED
+	  && block->kind != ZCORE_BLOCK_ZLIB)
+	valid = 0;
+      else if (block->kind != ZCORE_BLOCK_ZERO
+	       && (block->offset > size || block->size > size - block->offset))
+	valid = 0;
+    }
+
+  do_cleanups (back_to);
+
+  /* A block never holds more than the segment it is in, so a block
+     size larger than every segment, which the header may claim, just
+     means a single block for each segment.  Limit it to the largest
+     segment, which changes no block, so that the block cache is not
+     allocated with the claimed size.  */
+  if (max_seg_size > 0 && core_zblock_size > max_seg_size)
+    core_zblock_size = max_seg_size;
+
+  qsort (core_zsegments, nsegments, sizeof (struct core_zsegment),
+	 compare_core_zsegments);
+  for (i = 1; i < nsegments; i++)
+    if (core_zsegments[i].addr < core_zsegments[i - 1].endaddr)
+      valid = 0;
+
+  if (!valid)
+    {
+      free_core_zsegment_index ();
+      return 0;
+    }
+
+  core_zsection = asect;
+  return 1;
+}
+
+/* Look for compressed memory contents in the core, and if found, build
+   the compressed segment index from them.  The contents are in a
+   segment of their own, which BFD presents as a non-allocated section
+   starting with ZCORE_MAGIC.  */
+
+static void
+build_core_zsegment_index (void)
+{
+  struct bfd_section *asect;
+
+  for (asect = core_bfd->sections; asect != NULL; asect = asect->next)
+    {
+      flagword flags = bfd_get_section_flags (core_bfd, asect);
+      gdb_byte magic[ZCORE_MAGIC_LEN];
+
+      if ((flags & SEC_ALLOC) != 0
+	  || (flags & SEC_HAS_CONTENTS) == 0
+	  || bfd_section_size (core_bfd, asect) < ZCORE_HEADER_SIZE)
+	continue;
+
+      if (!bfd_get_section_contents (core_bfd, asect, magic, 0,
+				     ZCORE_MAGIC_LEN)
+	  || memcmp (magic, ZCORE_MAGIC, ZCORE_MAGIC_LEN) != 0)
+	continue;
+
+      if (!read_core_zsection (asect))
+	warning (_("\"%s\": ignoring invalid compressed memory contents."),
+		 bfd_get_filename (core_bfd));
+      return;
+    }
+}
+
+/* Return the compressed memory segment holding target address ADDR,
+   or NULL if there is none.  */
+
+static struct core_zsegment *
+find_core_zsegment (CORE_ADDR addr)
+{
+  ULONGEST lo = 0;
+  ULONGEST hi = core_num_zsegments;
+
+  /* Find the last segment that starts at or before ADDR.  */
+  while (lo < hi)
+    {
+      ULONGEST mid = lo + (hi - lo) / 2;
+
+      if (core_zsegments[mid].addr <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if (lo == 0 || addr >= core_zsegments[lo - 1].endaddr)
+    return NULL;
+  return &core_zsegments[lo - 1];
+}
+
+/* Return the contents of compressed block INDEX, whose uncompressed
+   size is BLOCK_LEN, decompressing it if it is not in the cache.
+   Return NULL if the block cannot be read.  */
+
+static const gdb_byte *
+core_zblock_contents (ULONGEST index, ULONGEST block_len)
+{
+  struct core_zcache_entry *entry = &core_zcache[index % CORE_ZCACHE_SIZE];
+  struct core_zblock *block = &core_zblocks[index];
+  struct cleanup *back_to;
+  const gdb_byte *src;
+  uLongf dest_len = block_len;
+  int status;
+
+  if (entry->valid && entry->block == index)
+    return entry->data;
+
+  /* Check the size of the block before allocating room for it.  */
+  if (block_len / ZLIB_MAX_EXPANSION > block->size)
+    return NULL;
+
+  entry->valid = 0;
+  if (entry->data_size < block_len)
+    {
+      xfree (entry->data);
+      entry->data = NULL;
+      entry->data_size = 0;
+      entry->data = (gdb_byte *) xmalloc (block_len);
+      entry->data_size = block_len;
+    }
+
+  back_to = make_cleanup (null_cleanup, NULL);
+  src = core_mapped_contents (core_zsection->filepos + block->offset,
+			      block->size);
+  if (src == NULL)
+    {
+      gdb_byte *buf = (gdb_byte *) xmalloc (block->size);
+
+      make_cleanup (xfree, buf);
+      if (!bfd_get_section_contents (core_bfd, core_zsection, buf,
+				     block->offset, block->size))
+	{
+	  do_cleanups (back_to);
+	  return NULL;
+	}
+      src = buf;
+    }
+
+  status = uncompress (entry->data, &dest_len, src, block->size);
+  do_cleanups (back_to);
+  if (status != Z_OK || dest_len != block_len)
+    return NULL;
+
+  entry->valid = 1;
+  entry->block = index;
+  return entry->data;
+}
+
+/* Read core memory at OFFSET from the compressed segment ZSEG, which
+   holds it.  This reads at most up to the end of the block holding
+   OFFSET.  */
+
+static enum target_xfer_status
+core_zsegment_xfer_memory (struct core_zsegment *zseg, gdb_byte *readbuf,
+			   ULONGEST offset, ULONGEST len,
+			   ULONGEST *xfered_len)
+{
+  ULONGEST seg_offset = offset - zseg->addr;
+  ULONGEST index = seg_offset / core_zblock_size;
+  ULONGEST block_start = index * core_zblock_size;
+  ULONGEST block_len = min (core_zblock_size,
+			    zseg->endaddr - zseg->addr - block_start);
+  ULONGEST within = seg_offset - block_start;
+  struct core_zblock *block = &core_zblocks[zseg->first_block + index];
+  const gdb_byte *contents;
+
+  if (len > block_len - within)
+    len = block_len - within;
+
+  switch (block->kind)
+    {
+    case ZCORE_BLOCK_ZERO:
+      memset (readbuf, 0, len);
+      break;
+
+    case ZCORE_BLOCK_STORED:
+      if (block->size != block_len)
+	return TARGET_XFER_E_IO;
+      contents = core_mapped_contents (core_zsection->filepos + block->offset,
+				       block->size);
+      if (contents != NULL)
+	memcpy (readbuf, contents + within, len);
+      else if (!bfd_get_section_contents (core_bfd, core_zsection, readbuf,
+					  block->offset + within, len))
+	return TARGET_XFER_E_IO;
+      break;
+
+    case ZCORE_BLOCK_ZLIB:
+      contents = core_zblock_contents (zseg->first_block + index, block_len);
+      if (contents == NULL)
+	return TARGET_XFER_E_IO;
+      memcpy (readbuf, contents + within, len);
+      break;
+    }
+
+  *xfered_len = len;
+  return TARGET_XFER_OK;
+}
+
+
+/* Return the hash value of the register note of thread LWP named NAME,
+   of length NAME_LEN.  */
+
+static hashval_t
+hash_core_reg_note_key (long lwp, const char *name, size_t name_len)
+{
+  return iterative_hash (name, name_len, (hashval_t) lwp);
+}
+
+/* Hash function for CORE_REG_NOTES.  */
+
+static hashval_t
+hash_core_reg_note (const void *p)
+{
+  const struct core_reg_note *note = (const struct core_reg_note *) p;
+
+  return hash_core_reg_note_key (note->lwp, note->name, note->name_len);
+}
+
+/* Equality function for CORE_REG_NOTES.  */
+
+static int
+eq_core_reg_note (const void *a, const void *b)
+{
+  const struct core_reg_note *na = (const struct core_reg_note *) a;
+  const struct core_reg_note *nb = (const struct core_reg_note *) b;
+
+  return (na->lwp == nb->lwp
+	  && na->name_len == nb->name_len
+	  && memcmp (na->name, nb->name, na->name_len) == 0);
+}
+
+/* Build CORE_REG_NOTES from the core's non-allocated sections.  */
+
+static void
+build_core_reg_note_table (void)
+{
+  struct bfd_section *asect;
+
+  core_reg_notes = htab_create_alloc (127, hash_core_reg_note,
+				      eq_core_reg_note, xfree,
+				      xcalloc, xfree);
+
+  for (asect = core_bfd->sections; asect != NULL; asect = asect->next)
+    {
+      const char *name = bfd_section_name (core_bfd, asect);
+      const char *slash = strrchr (name, '/');
+      struct core_reg_note key, *note;
+      void **slot;
+
+      if ((bfd_get_section_flags (core_bfd, asect) & SEC_ALLOC) != 0)
+	continue;
+
+      key.lwp = 0;
+      key.name = name;
+      key.name_len = strlen (name);
+      if (slash != NULL && slash[1] != '\0'
+	  && strspn (slash + 1, "0123456789") == strlen (slash + 1))
+	{
+	  key.lwp = atol (slash + 1);
+	  key.name_len = slash - name;
+	}
+
+      /* Like bfd_get_section_by_name, prefer the first of sections
+	 with the same name.  */
+      slot = htab_find_slot (core_reg_notes, &key, INSERT);
+      if (*slot != NULL)
+	continue;
+
+      note = XNEW (struct core_reg_note);
+      *note = key;
+      note->section = asect;
+      note->contents = NULL;
+      if ((bfd_get_section_flags (core_bfd, asect) & SEC_HAS_CONTENTS) != 0)
+	note->contents
+	  = core_mapped_contents (asect->filepos,
+				  bfd_section_size (core_bfd, asect));
+      *slot = note;
+    }
+}
+
+/* Return the register note named NAME of thread LWP, or NULL if the
+   core has none.  */
+
+static struct core_reg_note *
+find_core_reg_note (const char *name, long lwp)
+{
+  struct core_reg_note key;
+
+  if (core_reg_notes == NULL)
+    return NULL;
+
+  key.lwp = lwp;
+  key.name = name;
+  key.name_len = strlen (name);
+  return ((struct core_reg_note *)
+	  htab_find_with_hash (core_reg_notes, &key,
+			       hash_core_reg_note_key (lwp, name,
+						       key.name_len)));
+}
+
 /* Look for sections whose names start with `.reg/' so that we can
    extract the list of threads in a core file.  */
 
@@ -352,6 +1103,11 @@ core_open (const char *arg, int from_tty)
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
 
+  core_map_file ();
+  build_core_segment_index ();
+  build_core_zsegment_index ();
+  build_core_reg_note_table ();
+
   /* If we have no exec file, try to set the architecture from the
      core file.  We don't do this unconditionally since an exec file
      typically contains more information that helps us determine the
@@ -513,21 +1269,14 @@ get_core_register_section (struct regcache *regcache,
 			   const char *human_name,
 			   int required)
 {
-  static char *section_name = NULL;
+  struct core_reg_note *note;
   struct bfd_section *section;
+  const char *section_name;
   bfd_size_type size;
-  char *contents;
+  const gdb_byte *contents;
 
-  xfree (section_name);
-
-  if (ptid_get_lwp (inferior_ptid))
-    section_name = xstrprintf ("%s/%ld", name,
-			       ptid_get_lwp (inferior_ptid));
-  else
-    section_name = xstrdup (name);
-
-  section = bfd_get_section_by_name (core_bfd, section_name);
-  if (! section)
+  note = find_core_reg_note (name, ptid_get_lwp (inferior_ptid));
+  if (note == NULL)
     {
       if (required)
 	warning (_("Couldn't find %s registers in core file."),
@@ -535,6 +1284,8 @@ get_core_register_section (struct regcache *regcache,
       return;
     }
 
+  section = note->section;
+  section_name = bfd_section_name (core_bfd, section);
   size = bfd_section_size (core_bfd, section);
   if (size < min_size)
     {
@@ -547,13 +1298,23 @@ get_core_register_section (struct regcache *regcache,
 	       section_name);
     }
 
-  contents = (char *) alloca (size);
-  if (! bfd_get_section_contents (core_bfd, section, contents,
-				  (file_ptr) 0, size))
+  /* The notes are usually in the mapped core file; the old-style
+     core_read_registers interface needs a writable copy, though.  */
+  contents = note->contents;
+  if (contents == NULL || regset == NULL)
     {
-      warning (_("Couldn't read %s registers from `%s' section in core file."),
-	       human_name, name);
-      return;
+      gdb_byte *buf = (gdb_byte *) alloca (size);
+
+      if (contents != NULL)
+	memcpy (buf, contents, size);
+      else if (! bfd_get_section_contents (core_bfd, section, buf,
+					   (file_ptr) 0, size))
+	{
+	  warning (_("Couldn't read %s registers from `%s' section in core file."),
+		   human_name, name);
+	  return;
+	}
+      contents = buf;
     }
 
   if (regset != NULL)
@@ -563,7 +1324,7 @@ get_core_register_section (struct regcache *regcache,
     }
 
   gdb_assert (core_vec);
-  core_vec->core_read_registers (regcache, contents, size, which,
+  core_vec->core_read_registers (regcache, (char *) contents, size, which,
 				 ((CORE_ADDR)
 				  bfd_section_vma (core_bfd, section)));
 }
@@ -712,6 +1473,16 @@ core_xfer_partial (struct target_ops *ops, enum target_object object,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (readbuf != NULL && core_zsegments != NULL)
+	{
+	  struct core_zsegment *zseg = find_core_zsegment (offset);
+
+	  if (zseg != NULL)
+	    return core_zsegment_xfer_memory (zseg, readbuf, offset, len,
+					      xfered_len);
+	}
+      if (readbuf != NULL && core_segments != NULL)
+	return core_segment_xfer_memory (readbuf, offset, len, xfered_len);
       return section_table_xfer_memory_partial (readbuf, writebuf,
 						offset, len, xfered_len,
 						core_data->sections,
@@ -153,6 +153,13 @@ extern void quit (void);
 
 extern void maybe_quit (void);
 
+/* If non-NULL, called by maybe_quit after checking the quit flag.
+   An interpreter can use this to notice input that should be acted
+   on while a long command runs; the hook may throw a quit to abort
+   the command.  */
+
+extern void (*quit_poll_hook) (void);
+
 /* Check whether a Ctrl-C was typed, and if so, call quit.  The target
    is given a chance to process the Ctrl-C.  E.g., it may detect that
    repeated Ctrl-C requests were issued, and choose to close the
@@ -88,7 +88,10 @@
 
 enum dict_type
   {
-    /* Symbols are stored in a fixed-size hash table.  */
+    /* Symbols are stored in a fixed-size hash table.  The hash tables
+       use open addressing with linear probing: each slot holds a
+       symbol and the tag of its name's hash, and a lookup only looks
+       at the symbols whose tag matches.  */
     DICT_HASHED,
     /* Symbols are stored in an expandable hash table.  */
     DICT_HASHED_EXPANDABLE,
@@ -133,6 +136,9 @@ struct dict_vector
 struct dictionary_hashed
 {
   int nbuckets;
+  /* The tags of the buckets, zero for empty ones.  These are kept
+     apart from the symbols so that probing reads a dense array.  */
+  unsigned int *tags;
   struct symbol **buckets;
 };
 
@@ -140,6 +146,7 @@ struct dictionary_hashed_expandable
 {
   /* How many buckets we currently have.  */
   int nbuckets;
+  unsigned int *tags;
   struct symbol **buckets;
   /* How many syms we currently have; we need this so we will know
      when to add more buckets.  */
@@ -183,6 +190,8 @@ struct dictionary
 /* These can be used for DICT_HASHED_EXPANDABLE, too.  */
 
 #define DICT_HASHED_NBUCKETS(d)		(d)->data.hashed.nbuckets
+#define DICT_HASHED_TAGS(d)		(d)->data.hashed.tags
+#define DICT_HASHED_TAG(d,i)		DICT_HASHED_TAGS (d) [i]
 #define DICT_HASHED_BUCKETS(d)		(d)->data.hashed.buckets
 #define DICT_HASHED_BUCKET(d,i)		DICT_HASHED_BUCKETS (d) [i]
 
@@ -202,9 +211,16 @@ struct dictionary
 #define DICT_EXPANDABLE_INITIAL_CAPACITY 10
 
 /* This calculates the number of buckets we'll use in a hashtable,
-   given the number of symbols that it will contain.  */
+   given the number of symbols that it will contain.  There is always
+   at least one empty bucket, which ends every probe sequence, and the
+   table is at most 3/4 full.  */
 
-#define DICT_HASHTABLE_SIZE(n)	((n)/5 + 1)
+#define DICT_HASHTABLE_SIZE(n)	((n) + (n)/3 + 1)
+
+/* The tag stored in a bucket for a name whose hash is HASH.  Tags are
+   never zero, so that zero can mark the empty buckets.  */
+
+#define DICT_HASH_TAG(hash)	((hash) == 0 ? 1 : (hash))
 
 /* Accessor macros for dict_iterators; they're here rather than
    dictionary.h because code elsewhere should treat dict_iterators as
@@ -215,9 +231,6 @@ struct dictionary
 /* For linear dictionaries, the index of the last symbol returned; for
    hashed dictionaries, the bucket of the last symbol returned.  */
 #define DICT_ITERATOR_INDEX(iter)		(iter)->index
-/* For hashed dictionaries, this points to the last symbol returned;
-   otherwise, this is unused.  */
-#define DICT_ITERATOR_CURRENT(iter)		(iter)->current
 
 /* Declarations of functions for vectors.  */
 
@@ -344,6 +357,9 @@ static struct symbol *iterator_hashed_advance (struct dict_iterator *iter);
 static void insert_symbol_hashed (struct dictionary *dict,
 				  struct symbol *sym);
 
+static void insert_tagged_symbol (struct dictionary *dict,
+				  unsigned int tag, struct symbol *sym);
+
 static void expand_hashtable (struct dictionary *dict);
 
 /* The creation functions.  */
@@ -357,8 +373,8 @@ dict_create_hashed (struct obstack *obstack,
 		    const struct pending *symbol_list)
 {
   struct dictionary *retval;
-  int nsyms = 0, nbuckets, i;
-  struct symbol **buckets;
+  int nsyms = 0, nbuckets, i, j;
+  struct symbol **syms;
   const struct pending *list_counter;
 
   retval = XOBNEW (obstack, struct dictionary);
@@ -373,20 +389,25 @@ dict_create_hashed (struct obstack *obstack,
     }
   nbuckets = DICT_HASHTABLE_SIZE (nsyms);
   DICT_HASHED_NBUCKETS (retval) = nbuckets;
-  buckets = XOBNEWVEC (obstack, struct symbol *, nbuckets);
-  memset (buckets, 0, nbuckets * sizeof (struct symbol *));
-  DICT_HASHED_BUCKETS (retval) = buckets;
-
-  /* Now fill the buckets.  */
-  for (list_counter = symbol_list;
+  DICT_HASHED_TAGS (retval) = XOBNEWVEC (obstack, unsigned int, nbuckets);
+  memset (DICT_HASHED_TAGS (retval), 0, nbuckets * sizeof (unsigned int));
+  DICT_HASHED_BUCKETS (retval) = XOBNEWVEC (obstack, struct symbol *,
+					    nbuckets);
+
+  /* Now fill the buckets.  The symbols with the same name are found
+     in the order they are inserted, so insert them in the original
+     order of the symbols, which SYMBOL_LIST holds backwards.  */
+  syms = XNEWVEC (struct symbol *, nsyms);
+  for (list_counter = symbol_list, j = nsyms - 1;
        list_counter != NULL;
        list_counter = list_counter->next)
     {
-      for (i = list_counter->nsyms - 1; i >= 0; --i)
-	{
-	  insert_symbol_hashed (retval, list_counter->symbol[i]);
-	}
+      for (i = list_counter->nsyms - 1; i >= 0; --i, --j)
+	syms[j] = list_counter->symbol[i];
     }
+  for (i = 0; i < nsyms; ++i)
+    insert_symbol_hashed (retval, syms[i]);
+  xfree (syms);
 
   return retval;
 }
@@ -403,8 +424,10 @@ dict_create_hashed_expandable (void)
 
   DICT_VECTOR (retval) = &dict_hashed_expandable_vector;
   DICT_HASHED_NBUCKETS (retval) = DICT_EXPANDABLE_INITIAL_CAPACITY;
-  DICT_HASHED_BUCKETS (retval) = XCNEWVEC (struct symbol *,
-					   DICT_EXPANDABLE_INITIAL_CAPACITY);
+  DICT_HASHED_TAGS (retval) = XCNEWVEC (unsigned int,
+					DICT_EXPANDABLE_INITIAL_CAPACITY);
+  DICT_HASHED_BUCKETS (retval) = XNEWVEC (struct symbol *,
+					  DICT_EXPANDABLE_INITIAL_CAPACITY);
   DICT_HASHED_EXPANDABLE_NSYMS (retval) = 0;
 
   return retval;
@@ -612,17 +635,7 @@ iterator_first_hashed (const struct dictionary *dict,
 static struct symbol *
 iterator_next_hashed (struct dict_iterator *iterator)
 {
-  struct symbol *next;
-
-  next = DICT_ITERATOR_CURRENT (iterator)->hash_next;
-  
-  if (next == NULL)
-    return iterator_hashed_advance (iterator);
-  else
-    {
-      DICT_ITERATOR_CURRENT (iterator) = next;
-      return next;
-    }
+  return iterator_hashed_advance (iterator);
 }
 
 static struct symbol *
@@ -634,66 +647,95 @@ iterator_hashed_advance (struct dict_iterator *iterator)
 
   for (i = DICT_ITERATOR_INDEX (iterator) + 1; i < nbuckets; ++i)
     {
-      struct symbol *sym = DICT_HASHED_BUCKET (dict, i);
-      
-      if (sym != NULL)
+      if (DICT_HASHED_TAG (dict, i) != 0)
 	{
 	  DICT_ITERATOR_INDEX (iterator) = i;
-	  DICT_ITERATOR_CURRENT (iterator) = sym;
-	  return sym;
+	  return DICT_HASHED_BUCKET (dict, i);
 	}
     }
 
+  DICT_ITERATOR_INDEX (iterator) = nbuckets;
   return NULL;
 }
 
+/* Starting at bucket INDEX of the dictionary of ITERATOR, look for
+   the first symbol with tag TAG whose name matches NAME according to
+   COMPARE, until reaching an empty bucket.  Return the symbol, or
+   NULL if there is none.  */
+
 static struct symbol *
-iter_match_first_hashed (const struct dictionary *dict, const char *name,
-			 symbol_compare_ftype *compare,
-			 struct dict_iterator *iterator)
+iter_match_hashed_from (unsigned int index, unsigned int tag,
+			const char *name, symbol_compare_ftype *compare,
+			struct dict_iterator *iterator)
 {
-  unsigned int hash_index = dict_hash (name) % DICT_HASHED_NBUCKETS (dict);
-  struct symbol *sym;
-
-  DICT_ITERATOR_DICT (iterator) = dict;
+  const struct dictionary *dict = DICT_ITERATOR_DICT (iterator);
+  unsigned int nbuckets = DICT_HASHED_NBUCKETS (dict);
+  const unsigned int *tags = DICT_HASHED_TAGS (dict);
 
-  /* Loop through the symbols in the given bucket, breaking when SYM
-     first matches.  If SYM never matches, it will be set to NULL;
-     either way, we have the right return value.  */
-  
-  for (sym = DICT_HASHED_BUCKET (dict, hash_index);
-       sym != NULL;
-       sym = sym->hash_next)
+  /* Only the symbols with the same tag can match: names that COMPARE
+     considers equivalent have the same hash.  */
+  for (; tags[index] != 0; index = index + 1 == nbuckets ? 0 : index + 1)
     {
-      /* Warning: the order of arguments to compare matters!  */
-      if (compare (SYMBOL_SEARCH_NAME (sym), name) == 0)
+      if (tags[index] == tag)
 	{
-	  break;
+	  struct symbol *sym = DICT_HASHED_BUCKET (dict, index);
+
+	  /* Warning: the order of arguments to compare matters!  */
+	  if (compare (SYMBOL_SEARCH_NAME (sym), name) == 0)
+	    {
+	      DICT_ITERATOR_INDEX (iterator) = index;
+	      return sym;
+	    }
 	}
-	
     }
 
-  DICT_ITERATOR_CURRENT (iterator) = sym;
-  return sym;
+  return NULL;
+}
+
+static struct symbol *
+iter_match_first_hashed (const struct dictionary *dict, const char *name,
+			 symbol_compare_ftype *compare,
+			 struct dict_iterator *iterator)
+{
+  unsigned int tag = DICT_HASH_TAG (dict_hash (name));
+
+  DICT_ITERATOR_DICT (iterator) = dict;
+
+  return iter_match_hashed_from (tag % DICT_HASHED_NBUCKETS (dict), tag,
+				 name, compare, iterator);
 }
 
 static struct symbol *
 iter_match_next_hashed (const char *name, symbol_compare_ftype *compare,
 			struct dict_iterator *iterator)
 {
-  struct symbol *next;
+  const struct dictionary *dict = DICT_ITERATOR_DICT (iterator);
+  unsigned int index = DICT_ITERATOR_INDEX (iterator);
 
-  for (next = DICT_ITERATOR_CURRENT (iterator)->hash_next;
-       next != NULL;
-       next = next->hash_next)
-    {
-      if (compare (SYMBOL_SEARCH_NAME (next), name) == 0)
-	break;
-    }
+  /* The last symbol returned has the tag of NAME, so there is no need
+     to hash NAME again.  */
+  return iter_match_hashed_from ((index + 1) % DICT_HASHED_NBUCKETS (dict),
+				 DICT_HASHED_TAG (dict, index),
+				 name, compare, iterator);
+}
 
-  DICT_ITERATOR_CURRENT (iterator) = next;
+/* Insert SYM, whose name has the tag TAG, into the first empty bucket
+   of the probe sequence of TAG in DICT.  */
 
-  return next;
+static void
+insert_tagged_symbol (struct dictionary *dict, unsigned int tag,
+		      struct symbol *sym)
+{
+  unsigned int nbuckets = DICT_HASHED_NBUCKETS (dict);
+  unsigned int index;
+
+  for (index = tag % nbuckets;
+       DICT_HASHED_TAG (dict, index) != 0;
+       index = index + 1 == nbuckets ? 0 : index + 1)
+    ;
+
+  DICT_HASHED_TAG (dict, index) = tag;
+  DICT_HASHED_BUCKET (dict, index) = sym;
 }
 
 /* Insert SYM into DICT.  */
@@ -702,13 +744,9 @@ static void
 insert_symbol_hashed (struct dictionary *dict,
 		      struct symbol *sym)
 {
-  unsigned int hash_index;
-  struct symbol **buckets = DICT_HASHED_BUCKETS (dict);
+  unsigned int hash = dict_hash (SYMBOL_SEARCH_NAME (sym));
 
-  hash_index = 
-    dict_hash (SYMBOL_SEARCH_NAME (sym)) % DICT_HASHED_NBUCKETS (dict);
-  sym->hash_next = buckets[hash_index];
-  buckets[hash_index] = sym;
+  insert_tagged_symbol (dict, DICT_HASH_TAG (hash), sym);
 }
 
 static int
@@ -722,6 +760,7 @@ size_hashed (const struct dictionary *dict)
 static void
 free_hashed_expandable (struct dictionary *dict)
 {
+  xfree (DICT_HASHED_TAGS (dict));
   xfree (DICT_HASHED_BUCKETS (dict));
   xfree (dict);
 }
@@ -745,37 +784,43 @@ size_hashed_expandable (const struct dictionary *dict)
   return DICT_HASHED_EXPANDABLE_NSYMS (dict);
 }
 
+/* Grow the hash table of DICT, moving its symbols by their tags
+   rather than hashing their names again.
+
+   Symbols with the same name must stay in the order they were added.
+   In the old table, they follow each other along their probe
+   sequence, which may wrap from the last bucket to the first.  The
+   symbols are therefore moved in probe order: starting at an empty
+   bucket, which no probe sequence goes through, and wrapping around
+   from there.  */
+
 static void
 expand_hashtable (struct dictionary *dict)
 {
   int old_nbuckets = DICT_HASHED_NBUCKETS (dict);
+  unsigned int *old_tags = DICT_HASHED_TAGS (dict);
   struct symbol **old_buckets = DICT_HASHED_BUCKETS (dict);
   int new_nbuckets = 2 * old_nbuckets + 1;
-  struct symbol **new_buckets = XCNEWVEC (struct symbol *, new_nbuckets);
-  int i;
+  int start, i, j;
 
   DICT_HASHED_NBUCKETS (dict) = new_nbuckets;
-  DICT_HASHED_BUCKETS (dict) = new_buckets;
+  DICT_HASHED_TAGS (dict) = XCNEWVEC (unsigned int, new_nbuckets);
+  DICT_HASHED_BUCKETS (dict) = XNEWVEC (struct symbol *, new_nbuckets);
 
-  for (i = 0; i < old_nbuckets; ++i)
-    {
-      struct symbol *sym, *next_sym;
+  /* DICT_HASHTABLE_SIZE keeps the table from ever being full.  */
+  for (start = 0; start < old_nbuckets; ++start)
+    if (old_tags[start] == 0)
+      break;
+  gdb_assert (old_nbuckets == 0 || start < old_nbuckets);
 
-      sym = old_buckets[i];
-      if (sym != NULL) 
-	{
-	  for (next_sym = sym->hash_next;
-	       next_sym != NULL;
-	       next_sym = sym->hash_next)
-	    {
-	      insert_symbol_hashed (dict, sym);
-	      sym = next_sym;
-	    }
-
-	  insert_symbol_hashed (dict, sym);
-	}
+  for (i = 0, j = start; i < old_nbuckets; ++i)
+    {
+      if (old_tags[j] != 0)
+	insert_tagged_symbol (dict, old_tags[j], old_buckets[j]);
+      j = j + 1 == old_nbuckets ? 0 : j + 1;
     }
 
+  xfree (old_tags);
   xfree (old_buckets);
 }
 
@@ -103,10 +103,9 @@ struct dict_iterator
 {
   /* The dictionary that this iterator is associated to.  */
   const struct dictionary *dict;
-  /* The next two members are data that is used in a way that depends
+  /* The position of the last symbol returned, in a way that depends
      on DICT's implementation type.  */
   int index;
-  struct symbol *current;
 };
 
 /* Initialize ITERATOR to point at the first symbol in DICT, and
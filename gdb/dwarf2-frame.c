@@ -38,6 +38,7 @@
 #include "ax.h"
 #include "dwarf2loc.h"
 #include "dwarf2-frame-tailcall.h"
+#include "gdbcmd.h"
 
 struct comp_unit;
 
@@ -125,6 +126,10 @@ struct dwarf2_fde_table
 {
   int num_entries;
   struct dwarf2_fde **entries;
+
+  /* The lowest and highest unrelocated addresses covered by the
+     entries, if there are any.  */
+  CORE_ADDR low, high;
 };
 
 /* A minimal decoding of DWARF2 compilation units.  We only decode
@@ -215,6 +220,11 @@ struct dwarf2_frame_state
   /* The ARM compilers, in DWARF2 or DWARF3 mode, may assume that
      the CFA is defined as REG - OFFSET rather than REG + OFFSET.  */
   int armcc_cfa_offsets_reversed;
+
+  /* The range of PCs, from ROW_START up to but not including ROW_END,
+     for which the CFA programs executed so far would have left the
+     same state.  */
+  CORE_ADDR row_start, row_end;
 };
 
 /* Store the length the expression for the CFA in the `cfa_reg' field,
@@ -426,6 +436,9 @@ execute_cfa_program (struct dwarf2_fde *fde, const gdb_byte *insn_ptr,
       uint64_t utmp, reg;
       int64_t offset;
 
+      if (fs->pc > fs->row_start)
+	fs->row_start = fs->pc;
+
       if ((insn & 0xc0) == DW_CFA_advance_loc)
 	fs->pc += (insn & 0x3f) * fs->code_align;
       else if ((insn & 0xc0) == DW_CFA_offset)
@@ -693,6 +706,9 @@ bad CFI data; mismatched DW_CFA_restore_state at %s"),
 	}
     }
 
+  if (fs->pc > pc && fs->pc < fs->row_end)
+    fs->row_end = fs->pc;
+
   if (fs->initial.reg == NULL)
     {
       /* Don't allow remember/restore between CIE and FDE programs.  */
@@ -895,6 +911,262 @@ dwarf2_frame_find_quirks (struct dwarf2_frame_state *fs,
 }
 
 
+/* A row of the CFI table of an FDE: the rules for computing the CFA
+   and the saved registers over a range of PCs, as left by the CFA
+   programs of the CIE and the FDE.  Rows depend on nothing but the FDE
+   and the PC, so they are cached for the lifetime of the objfile, and
+   unwinding a PC of the same row again, after the frame cache is
+   flushed by a stop or in another thread, does not run the CFA
+   programs again.  An FDE has a fixed number of rows, so the cache
+   cannot grow past the size of the CFI.  */
+
+struct dwarf2_frame_row
+{
+  /* The next row of the same dwarf2_frame_fde_rows.  */
+  struct dwarf2_frame_row *next;
+
+  /* The row applies to the PCs from START up to, but not including,
+     END.  They are relative to the text section of the objfile, so
+     that rows survive relocation.  */
+  CORE_ADDR start, end;
+
+  /* The rules of the row.  REGS.prev is always NULL.  */
+  struct dwarf2_frame_state_reg_info regs;
+
+  /* The PC the CFA programs stopped at, relative to the text
+     section.  */
+  CORE_ADDR row_pc;
+
+  /* The information we care about from the CIE, and the producer
+     quirks; see struct dwarf2_frame_state.  */
+  ULONGEST retaddr_column;
+  int armcc_cfa_offsets_reversed;
+
+  /* If ENTRY_PC_P and the CFA at ENTRY_PC is the stack pointer plus an
+     offset, ENTRY_CFA_SP_OFFSET_P is set and ENTRY_CFA_SP_OFFSET is the
+     offset.  */
+  LONGEST entry_cfa_sp_offset;
+  int entry_cfa_sp_offset_p;
+};
+
+/* The rows of an FDE computed so far, for one architecture and entry
+   point.  */
+
+struct dwarf2_frame_fde_rows
+{
+  /* The key.  ENTRY_PC is relative to the text section of the
+     objfile.  */
+  const struct dwarf2_fde *fde;
+  struct gdbarch *gdbarch;
+  CORE_ADDR entry_pc;
+  int entry_pc_p;
+
+  /* The rows, most recently computed first.  Their ranges do not
+     overlap.  */
+  struct dwarf2_frame_row *rows;
+};
+
+/* Per-objfile data key for the cache of CFI rows.  */
+static const struct objfile_data *dwarf2_frame_rows_data;
+
+/* Hash function for the cache of CFI rows.  */
+
+static hashval_t
+hash_dwarf2_frame_fde_rows (const void *p)
+{
+  const struct dwarf2_frame_fde_rows *rows
+    = (const struct dwarf2_frame_fde_rows *) p;
+  hashval_t h;
+
+  h = htab_hash_pointer (rows->fde);
+  if (rows->entry_pc_p)
+    h = h * 67 + (hashval_t) rows->entry_pc;
+  return h;
+}
+
+/* Equality function for the cache of CFI rows.  */
+
+static int
+eq_dwarf2_frame_fde_rows (const void *a, const void *b)
+{
+  const struct dwarf2_frame_fde_rows *ra
+    = (const struct dwarf2_frame_fde_rows *) a;
+  const struct dwarf2_frame_fde_rows *rb
+    = (const struct dwarf2_frame_fde_rows *) b;
+
+  return (ra->fde == rb->fde
+	  && ra->gdbarch == rb->gdbarch
+	  && ra->entry_pc_p == rb->entry_pc_p
+	  && (!ra->entry_pc_p || ra->entry_pc == rb->entry_pc));
+}
+
+/* Free function for the cache of CFI rows.  */
+
+static void
+free_dwarf2_frame_fde_rows (void *p)
+{
+  struct dwarf2_frame_fde_rows *fde_rows = (struct dwarf2_frame_fde_rows *) p;
+  struct dwarf2_frame_row *row, *next;
+
+  for (row = fde_rows->rows; row != NULL; row = next)
+    {
+      next = row->next;
+      xfree (row->regs.reg);
+      xfree (row);
+    }
+  xfree (fde_rows);
+}
+
+/* The objfile cleanup of the cache of CFI rows.  */
+
+static void
+dwarf2_frame_rows_cleanup (struct objfile *objfile, void *arg)
+{
+  htab_delete ((htab_t) arg);
+}
+
+/* The "maint flush-dwarf-cfi-cache" command.  */
+
+static void
+maintenance_flush_dwarf_cfi_cache (char *args, int from_tty)
+{
+  struct program_space *pspace;
+  struct objfile *objfile;
+
+  ALL_PSPACES (pspace)
+    ALL_PSPACE_OBJFILES (pspace, objfile)
+      {
+	htab_t rows = (htab_t) objfile_data (objfile, dwarf2_frame_rows_data);
+
+	if (rows != NULL)
+	  htab_empty (rows);
+      }
+}
+
+/* Return the row of the CFI table of FDE for PC.  TEXT_OFFSET is the
+   offset of the text section of the objfile of FDE.  If ENTRY_PC_P,
+   ENTRY_PC is the entry point of the function containing PC, and the
+   row also describes the CFA there.  */
+
+static const struct dwarf2_frame_row *
+dwarf2_frame_find_row (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+		       CORE_ADDR text_offset, CORE_ADDR pc,
+		       int entry_pc_p, CORE_ADDR entry_pc)
+{
+  struct objfile *objfile = fde->cie->unit->objfile;
+  struct dwarf2_frame_fde_rows key, *fde_rows;
+  struct dwarf2_frame_row *row;
+  struct dwarf2_frame_state *fs;
+  struct cleanup *old_chain;
+  const gdb_byte *instr;
+  CORE_ADDR rel_pc = pc - text_offset;
+  htab_t rows;
+  void **slot;
+
+  rows = (htab_t) objfile_data (objfile, dwarf2_frame_rows_data);
+  if (rows == NULL)
+    {
+      rows = htab_create_alloc (127, hash_dwarf2_frame_fde_rows,
+				eq_dwarf2_frame_fde_rows,
+				free_dwarf2_frame_fde_rows, xcalloc, xfree);
+      set_objfile_data (objfile, dwarf2_frame_rows_data, rows);
+    }
+
+  memset (&key, 0, sizeof (key));
+  key.fde = fde;
+  key.gdbarch = gdbarch;
+  key.entry_pc_p = entry_pc_p;
+  if (entry_pc_p)
+    key.entry_pc = entry_pc - text_offset;
+
+  slot = htab_find_slot (rows, &key, INSERT);
+  if (*slot == NULL)
+    {
+      fde_rows = XNEW (struct dwarf2_frame_fde_rows);
+      *fde_rows = key;
+      *slot = fde_rows;
+    }
+  fde_rows = (struct dwarf2_frame_fde_rows *) *slot;
+
+  for (row = fde_rows->rows; row != NULL; row = row->next)
+    if (row->start <= rel_pc && rel_pc < row->end)
+      return row;
+
+  /* Allocate and initialize the frame state.  */
+  fs = XCNEW (struct dwarf2_frame_state);
+  old_chain = make_cleanup (dwarf2_frame_state_free, fs);
+  fs->pc = fde->initial_location + text_offset;
+  fs->row_start = fs->pc;
+  fs->row_end = fs->pc + fde->address_range;
+
+  /* Extract any interesting information from the CIE.  */
+  fs->data_align = fde->cie->data_alignment_factor;
+  fs->code_align = fde->cie->code_alignment_factor;
+  fs->retaddr_column = fde->cie->return_address_register;
+
+  /* Check for "quirks" - known bugs in producers.  */
+  dwarf2_frame_find_quirks (fs, fde);
+
+  row = XCNEW (struct dwarf2_frame_row);
+  make_cleanup (xfree, row);
+
+  /* First decode all the insns in the CIE.  */
+  execute_cfa_program (fde, fde->cie->initial_instructions,
+		       fde->cie->end, gdbarch, pc, fs);
+
+  /* Save the initialized register set.  */
+  fs->initial = fs->regs;
+  fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+
+  if (entry_pc_p)
+    {
+      CORE_ADDR row_start = fs->row_start, row_end = fs->row_end;
+
+      /* Decode the insns in the FDE up to the entry PC.  That part
+	 does not depend on PC, so it does not narrow the row.  */
+      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
+				   entry_pc, fs);
+      fs->row_start = row_start;
+      fs->row_end = row_end;
+
+      if (fs->regs.cfa_how == CFA_REG_OFFSET
+	  && (dwarf_reg_to_regnum (gdbarch, fs->regs.cfa_reg)
+	      == gdbarch_sp_regnum (gdbarch)))
+	{
+	  row->entry_cfa_sp_offset = fs->regs.cfa_offset;
+	  row->entry_cfa_sp_offset_p = 1;
+	}
+    }
+  else
+    instr = fde->instructions;
+
+  /* Then decode the insns in the FDE up to our target PC.  */
+  execute_cfa_program (fde, instr, fde->end, gdbarch, pc, fs);
+
+  /* PC may be outside the FDE, if the frame's PC is adjusted.  */
+  if (pc < fs->row_start || pc >= fs->row_end)
+    {
+      fs->row_start = pc;
+      fs->row_end = pc + 1;
+    }
+
+  row->start = fs->row_start - text_offset;
+  row->end = fs->row_end - text_offset;
+  row->regs = fs->regs;
+  row->regs.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+  row->regs.prev = NULL;
+  row->row_pc = fs->pc - text_offset;
+  row->retaddr_column = fs->retaddr_column;
+  row->armcc_cfa_offsets_reversed = fs->armcc_cfa_offsets_reversed;
+
+  discard_cleanups (old_chain);
+  dwarf2_frame_state_free (fs);
+
+  row->next = fde_rows->rows;
+  fde_rows->rows = row;
+  return row;
+}
+
 /* See dwarf2-frame.h.  */
 
 int
@@ -907,57 +1179,35 @@ dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
 {
   struct dwarf2_fde *fde;
   CORE_ADDR text_offset;
-  struct dwarf2_frame_state fs;
-  int addr_size;
-
-  memset (&fs, 0, sizeof (struct dwarf2_frame_state));
-
-  fs.pc = pc;
+  CORE_ADDR fde_pc = pc;
+  const struct dwarf2_frame_row *row;
 
   /* Find the correct FDE.  */
-  fde = dwarf2_frame_find_fde (&fs.pc, &text_offset);
+  fde = dwarf2_frame_find_fde (&fde_pc, &text_offset);
   if (fde == NULL)
     error (_("Could not compute CFA; needed to translate this expression"));
 
-  /* Extract any interesting information from the CIE.  */
-  fs.data_align = fde->cie->data_alignment_factor;
-  fs.code_align = fde->cie->code_alignment_factor;
-  fs.retaddr_column = fde->cie->return_address_register;
-  addr_size = fde->cie->addr_size;
-
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (&fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch, pc, &fs);
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
-  fs.initial.reg = dwarf2_frame_state_copy_regs (&fs.regs);
-
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, fde->instructions, fde->end, gdbarch, pc, &fs);
+  row = dwarf2_frame_find_row (gdbarch, fde, text_offset, pc, 0, 0);
 
   /* Calculate the CFA.  */
-  switch (fs.regs.cfa_how)
+  switch (row->regs.cfa_how)
     {
     case CFA_REG_OFFSET:
       {
-	int regnum = dwarf_reg_to_regnum_or_error (gdbarch, fs.regs.cfa_reg);
+	int regnum = dwarf_reg_to_regnum_or_error (gdbarch, row->regs.cfa_reg);
 
 	*regnum_out = regnum;
-	if (fs.armcc_cfa_offsets_reversed)
-	  *offset_out = -fs.regs.cfa_offset;
+	if (row->armcc_cfa_offsets_reversed)
+	  *offset_out = -row->regs.cfa_offset;
 	else
-	  *offset_out = fs.regs.cfa_offset;
+	  *offset_out = row->regs.cfa_offset;
 	return 1;
       }
 
     case CFA_EXP:
       *text_offset_out = text_offset;
-      *cfa_start_out = fs.regs.cfa_exp;
-      *cfa_end_out = fs.regs.cfa_exp + fs.regs.cfa_exp_len;
+      *cfa_start_out = row->regs.cfa_exp;
+      *cfa_end_out = row->regs.cfa_exp + row->regs.cfa_exp_len;
       return 0;
 
     default:
@@ -1022,15 +1272,15 @@ clear_pointer_cleanup (void *arg)
 static struct dwarf2_frame_cache *
 dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 {
-  struct cleanup *reset_cache_cleanup, *old_chain;
+  struct cleanup *reset_cache_cleanup;
   struct gdbarch *gdbarch = get_frame_arch (this_frame);
   const int num_regs = gdbarch_num_regs (gdbarch)
 		       + gdbarch_num_pseudo_regs (gdbarch);
   struct dwarf2_frame_cache *cache;
-  struct dwarf2_frame_state *fs;
+  const struct dwarf2_frame_row *row;
   struct dwarf2_fde *fde;
-  CORE_ADDR entry_pc;
-  const gdb_byte *instr;
+  CORE_ADDR pc, fde_pc, entry_pc;
+  int entry_pc_p;
 
   if (*this_cache)
     return (struct dwarf2_frame_cache *) *this_cache;
@@ -1041,10 +1291,6 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   *this_cache = cache;
   reset_cache_cleanup = make_cleanup (clear_pointer_cleanup, this_cache);
 
-  /* Allocate and initialize the frame state.  */
-  fs = XCNEW (struct dwarf2_frame_state);
-  old_chain = make_cleanup (dwarf2_frame_state_free, fs);
-
   /* Unwind the PC.
 
      Note that if the next frame is never supposed to return (i.e. a call
@@ -1060,67 +1306,38 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
      get_frame_address_in_block does just this.  It's not clear how
      reliable the method is though; there is the potential for the
      register state pre-call being different to that on return.  */
-  fs->pc = get_frame_address_in_block (this_frame);
+  pc = get_frame_address_in_block (this_frame);
 
   /* Find the correct FDE.  */
-  fde = dwarf2_frame_find_fde (&fs->pc, &cache->text_offset);
+  fde_pc = pc;
+  fde = dwarf2_frame_find_fde (&fde_pc, &cache->text_offset);
   gdb_assert (fde != NULL);
 
-  /* Extract any interesting information from the CIE.  */
-  fs->data_align = fde->cie->data_alignment_factor;
-  fs->code_align = fde->cie->code_alignment_factor;
-  fs->retaddr_column = fde->cie->return_address_register;
   cache->addr_size = fde->cie->addr_size;
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), fs);
-
-  /* Save the initialized register set.  */
-  fs->initial = fs->regs;
-  fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
-
-  if (get_frame_func_if_available (this_frame, &entry_pc))
-    {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
-				   entry_pc, fs);
-
-      if (fs->regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs->regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
-	{
-	  cache->entry_cfa_sp_offset = fs->regs.cfa_offset;
-	  cache->entry_cfa_sp_offset_p = 1;
-	}
-    }
-  else
-    instr = fde->instructions;
-
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), fs);
+  /* Find the CFI rules for PC.  */
+  entry_pc_p = get_frame_func_if_available (this_frame, &entry_pc);
+  row = dwarf2_frame_find_row (gdbarch, fde, cache->text_offset, pc,
+			       entry_pc_p, entry_pc);
+  cache->entry_cfa_sp_offset = row->entry_cfa_sp_offset;
+  cache->entry_cfa_sp_offset_p = row->entry_cfa_sp_offset_p;
 
   TRY
     {
       /* Calculate the CFA.  */
-      switch (fs->regs.cfa_how)
+      switch (row->regs.cfa_how)
 	{
 	case CFA_REG_OFFSET:
-	  cache->cfa = read_addr_from_reg (this_frame, fs->regs.cfa_reg);
-	  if (fs->armcc_cfa_offsets_reversed)
-	    cache->cfa -= fs->regs.cfa_offset;
+	  cache->cfa = read_addr_from_reg (this_frame, row->regs.cfa_reg);
+	  if (row->armcc_cfa_offsets_reversed)
+	    cache->cfa -= row->regs.cfa_offset;
 	  else
-	    cache->cfa += fs->regs.cfa_offset;
+	    cache->cfa += row->regs.cfa_offset;
 	  break;
 
 	case CFA_EXP:
 	  cache->cfa =
-	    execute_stack_op (fs->regs.cfa_exp, fs->regs.cfa_exp_len,
+	    execute_stack_op (row->regs.cfa_exp, row->regs.cfa_exp_len,
 			      cache->addr_size, cache->text_offset,
 			      this_frame, 0, 0);
 	  break;
@@ -1134,7 +1351,6 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
       if (ex.error == NOT_AVAILABLE_ERROR)
 	{
 	  cache->unavailable_retaddr = 1;
-	  do_cleanups (old_chain);
 	  discard_cleanups (reset_cache_cleanup);
 	  return cache;
 	}
@@ -1158,7 +1374,7 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   {
     int column;		/* CFI speak for "register number".  */
 
-    for (column = 0; column < fs->regs.num_regs; column++)
+    for (column = 0; column < row->regs.num_regs; column++)
       {
 	/* Use the GDB register number as the destination index.  */
 	int regnum = dwarf_reg_to_regnum (gdbarch, column);
@@ -1178,16 +1394,16 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 	   problems when a debug info register falls outside of the
 	   table.  We need a way of iterating through all the valid
 	   DWARF2 register numbers.  */
-	if (fs->regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
+	if (row->regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	  {
 	    if (cache->reg[regnum].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	      complaint (&symfile_complaints, _("\
 incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 			 gdbarch_register_name (gdbarch, regnum),
-			 paddress (gdbarch, fs->pc));
+			 paddress (gdbarch, row->row_pc + cache->text_offset));
 	  }
 	else
-	  cache->reg[regnum] = fs->regs.reg[column];
+	  cache->reg[regnum] = row->regs.reg[column];
       }
   }
 
@@ -1201,8 +1417,8 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	if (cache->reg[regnum].how == DWARF2_FRAME_REG_RA
 	    || cache->reg[regnum].how == DWARF2_FRAME_REG_RA_OFFSET)
 	  {
-	    struct dwarf2_frame_state_reg *retaddr_reg =
-	      &fs->regs.reg[fs->retaddr_column];
+	    const struct dwarf2_frame_state_reg *retaddr_reg =
+	      &row->regs.reg[row->retaddr_column];
 
 	    /* It seems rather bizarre to specify an "empty" column as
                the return adress column.  However, this is exactly
@@ -1211,7 +1427,7 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
                register corresponding to the return address column.
                Incidentally, that's how we should treat a return
                address column specifying "same value" too.  */
-	    if (fs->retaddr_column < fs->regs.num_regs
+	    if (row->retaddr_column < row->regs.num_regs
 		&& retaddr_reg->how != DWARF2_FRAME_REG_UNSPECIFIED
 		&& retaddr_reg->how != DWARF2_FRAME_REG_SAME_VALUE)
 	      {
@@ -1224,12 +1440,12 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	      {
 		if (cache->reg[regnum].how == DWARF2_FRAME_REG_RA)
 		  {
-		    cache->reg[regnum].loc.reg = fs->retaddr_column;
+		    cache->reg[regnum].loc.reg = row->retaddr_column;
 		    cache->reg[regnum].how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 		else
 		  {
-		    cache->retaddr_reg.loc.reg = fs->retaddr_column;
+		    cache->retaddr_reg.loc.reg = row->retaddr_column;
 		    cache->retaddr_reg.how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 	      }
@@ -1237,11 +1453,10 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
       }
   }
 
-  if (fs->retaddr_column < fs->regs.num_regs
-      && fs->regs.reg[fs->retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
+  if (row->retaddr_column < row->regs.num_regs
+      && row->regs.reg[row->retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
     cache->undefined_retaddr = 1;
 
-  do_cleanups (old_chain);
   discard_cleanups (reset_cache_cleanup);
   return cache;
 }
@@ -1757,30 +1972,164 @@ bsearch_fde_cmp (const void *key, const void *element)
   return 1;
 }
 
-/* Find the FDE for *PC.  Return a pointer to the FDE, and store the
-   inital location associated with it into *PC.  */
+/* The FDE table of an objfile, as stored in a program space's
+   dwarf2_fde_map.  */
 
-static struct dwarf2_fde *
-dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
+struct dwarf2_fde_map_entry
 {
   struct objfile *objfile;
+  struct dwarf2_fde_table *fde_table;
 
-  ALL_OBJFILES (objfile)
-    {
-      struct dwarf2_fde_table *fde_table;
-      struct dwarf2_fde **p_fde;
-      CORE_ADDR offset;
-      CORE_ADDR seek_pc;
+  /* The offset of the text section of OBJFILE, which applies to the
+     addresses of the FDEs.  */
+  CORE_ADDR offset;
+
+  /* The lowest and highest relocated addresses covered by the FDEs of
+     FDE_TABLE.  */
+  CORE_ADDR low, high;
+};
+
+/* A range of addresses of a dwarf2_fde_map, from START up to the start
+   of the next segment.  */
 
+struct dwarf2_fde_map_segment
+{
+  CORE_ADDR start;
+
+  /* The entries whose FDEs may cover the segment are CANDIDATES[FIRST]
+     to CANDIDATES[FIRST + COUNT - 1] in the map, in objfile order.  */
+  int first;
+  int count;
+};
+
+/* An index of the FDE tables of all the objfiles of a program space,
+   so that finding the FDE for an address takes a single binary search
+   of the map, then usually a single binary search of an FDE table,
+   however many objfiles the program space has.  */
+
+struct dwarf2_fde_map
+{
+  /* Non-zero if the map must be rebuilt before use.  */
+  int dirty;
+
+  /* The value of objfiles_generation when the map was built.  */
+  unsigned int generation;
+
+  /* The objfiles with a non-empty FDE table, in objfile order.  */
+  struct dwarf2_fde_map_entry *entries;
+
+  /* The segments, sorted by start address.  Addresses below the start
+     of the first segment have no FDE.  */
+  int num_segments;
+  struct dwarf2_fde_map_segment *segments;
+
+  /* The candidate entries of all the segments.  */
+  struct dwarf2_fde_map_entry **candidates;
+};
+
+/* Per-program-space data key for the FDE map.  */
+static const struct program_space_data *dwarf2_frame_pspace_data;
+
+/* Free the arrays of MAP.  */
+
+static void
+dwarf2_fde_map_clear (struct dwarf2_fde_map *map)
+{
+  xfree (map->entries);
+  map->entries = NULL;
+  xfree (map->segments);
+  map->segments = NULL;
+  map->num_segments = 0;
+  xfree (map->candidates);
+  map->candidates = NULL;
+  map->dirty = 1;
+}
+
+/* The program space cleanup of the FDE map.  */
+
+static void
+dwarf2_frame_pspace_data_cleanup (struct program_space *pspace, void *arg)
+{
+  struct dwarf2_fde_map *map = (struct dwarf2_fde_map *) arg;
+
+  dwarf2_fde_map_clear (map);
+  xfree (map);
+}
+
+/* Return the FDE table of OBJFILE, reading it if needed.  */
+
+static struct dwarf2_fde_table *
+dwarf2_frame_fde_table (struct objfile *objfile)
+{
+  struct dwarf2_fde_table *fde_table;
+
+  fde_table = ((struct dwarf2_fde_table *)
+	       objfile_data (objfile, dwarf2_frame_objfile_data));
+  if (fde_table == NULL)
+    {
+      dwarf2_build_frame_info (objfile);
       fde_table = ((struct dwarf2_fde_table *)
 		   objfile_data (objfile, dwarf2_frame_objfile_data));
-      if (fde_table == NULL)
-	{
-	  dwarf2_build_frame_info (objfile);
-	  fde_table = ((struct dwarf2_fde_table *)
-		       objfile_data (objfile, dwarf2_frame_objfile_data));
-	}
-      gdb_assert (fde_table != NULL);
+    }
+  gdb_assert (fde_table != NULL);
+
+  return fde_table;
+}
+
+/* qsort comparison function for the boundaries of the segments.  */
+
+static int
+dwarf2_fde_map_addr_cmp (const void *a, const void *b)
+{
+  CORE_ADDR aa = *(const CORE_ADDR *) a;
+  CORE_ADDR bb = *(const CORE_ADDR *) b;
+
+  if (aa < bb)
+    return -1;
+  return aa > bb;
+}
+
+/* qsort comparison function for entries, by lowest address.  */
+
+static int
+dwarf2_fde_map_entry_cmp (const void *a, const void *b)
+{
+  const struct dwarf2_fde_map_entry *aa
+    = *(const struct dwarf2_fde_map_entry * const *) a;
+  const struct dwarf2_fde_map_entry *bb
+    = *(const struct dwarf2_fde_map_entry * const *) b;
+
+  return dwarf2_fde_map_addr_cmp (&aa->low, &bb->low);
+}
+
+/* Rebuild MAP from the FDE tables of the objfiles of the current
+   program space, reading those which have not been read yet.  */
+
+static void
+dwarf2_fde_map_build (struct dwarf2_fde_map *map)
+{
+  struct cleanup *back_to;
+  struct objfile *objfile;
+  struct dwarf2_fde_map_entry *entries, **by_low, **active, **candidates;
+  struct dwarf2_fde_map_segment *segments;
+  CORE_ADDR *bounds;
+  int num_objfiles = 0, num_entries = 0, num_bounds = 0;
+  int num_active = 0, num_candidates = 0, num_segments = 0, next_low = 0;
+  int i, j;
+
+  dwarf2_fde_map_clear (map);
+
+  ALL_OBJFILES (objfile)
+    num_objfiles++;
+
+  entries = XNEWVEC (struct dwarf2_fde_map_entry, num_objfiles);
+  back_to = make_cleanup (xfree, entries);
+
+  ALL_OBJFILES (objfile)
+    {
+      struct dwarf2_fde_table *fde_table = dwarf2_frame_fde_table (objfile);
+      struct dwarf2_fde_map_entry *entry;
+      CORE_ADDR offset;
 
       if (fde_table->num_entries == 0)
 	continue;
@@ -1788,19 +2137,154 @@ dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
       gdb_assert (objfile->section_offsets);
       offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
 
-      gdb_assert (fde_table->num_entries > 0);
-      if (*pc < offset + fde_table->entries[0]->initial_location)
-        continue;
+      entry = &entries[num_entries++];
+      entry->objfile = objfile;
+      entry->fde_table = fde_table;
+      entry->offset = offset;
+      entry->low = offset + fde_table->low;
+      entry->high = offset + fde_table->high;
+    }
 
-      seek_pc = *pc - offset;
+  /* A segment starts at the lowest address of each entry, and after
+     the highest one.  */
+  bounds = XNEWVEC (CORE_ADDR, 2 * num_entries);
+  make_cleanup (xfree, bounds);
+  by_low = XNEWVEC (struct dwarf2_fde_map_entry *, num_entries);
+  make_cleanup (xfree, by_low);
+  for (i = 0; i < num_entries; i++)
+    {
+      bounds[num_bounds++] = entries[i].low;
+      if (entries[i].high + 1 != 0)
+	bounds[num_bounds++] = entries[i].high + 1;
+      by_low[i] = &entries[i];
+    }
+  qsort (bounds, num_bounds, sizeof (bounds[0]), dwarf2_fde_map_addr_cmp);
+  qsort (by_low, num_entries, sizeof (by_low[0]), dwarf2_fde_map_entry_cmp);
+
+  segments = XNEWVEC (struct dwarf2_fde_map_segment, num_bounds);
+  make_cleanup (xfree, segments);
+  active = XNEWVEC (struct dwarf2_fde_map_entry *, num_entries);
+  make_cleanup (xfree, active);
+  candidates = NULL;
+  make_cleanup (free_current_contents, &candidates);
+
+  /* Sweep the bounds in increasing order, maintaining in ACTIVE the
+     entries covering the current segment, in objfile order.  Entries
+     seldom overlap, so ACTIVE seldom holds more than one entry.  */
+  for (i = 0; i < num_bounds; i++)
+    {
+      CORE_ADDR start = bounds[i];
+      struct dwarf2_fde_map_segment *segment;
+      int k;
+
+      if (i > 0 && bounds[i - 1] == start)
+	continue;
+
+      for (j = k = 0; j < num_active; j++)
+	if (active[j]->high >= start)
+	  active[k++] = active[j];
+      num_active = k;
+
+      for (; next_low < num_entries && by_low[next_low]->low <= start;
+	   next_low++)
+	{
+	  for (k = num_active; k > 0 && active[k - 1] > by_low[next_low]; k--)
+	    active[k] = active[k - 1];
+	  active[k] = by_low[next_low];
+	  num_active++;
+	}
+
+      segment = &segments[num_segments++];
+      segment->start = start;
+      segment->first = num_candidates;
+      segment->count = num_active;
+      candidates = XRESIZEVEC (struct dwarf2_fde_map_entry *, candidates,
+			       num_candidates + num_active);
+      for (k = 0; k < num_active; k++)
+	candidates[num_candidates++] = active[k];
+    }
+
+  discard_cleanups (back_to);
+  xfree (bounds);
+  xfree (by_low);
+  xfree (active);
+
+  map->entries = entries;
+  map->segments = segments;
+  map->num_segments = num_segments;
+  map->candidates = candidates;
+  map->generation = objfiles_generation (current_program_space);
+  map->dirty = 0;
+}
+
+/* Return the FDE map of the current program space, (re)building it if
+   needed.  */
+
+static struct dwarf2_fde_map *
+dwarf2_frame_fde_map (void)
+{
+  struct dwarf2_fde_map *map;
+
+  map = ((struct dwarf2_fde_map *)
+	 program_space_data (current_program_space, dwarf2_frame_pspace_data));
+  if (map == NULL)
+    {
+      map = XCNEW (struct dwarf2_fde_map);
+      map->dirty = 1;
+      set_program_space_data (current_program_space,
+			      dwarf2_frame_pspace_data, map);
+    }
+
+  if (map->dirty
+      || map->generation != objfiles_generation (current_program_space))
+    dwarf2_fde_map_build (map);
+
+  return map;
+}
+
+/* Find the FDE for *PC.  Return a pointer to the FDE, and store the
+   inital location associated with it into *PC.  */
+
+static struct dwarf2_fde *
+dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
+{
+  struct dwarf2_fde_map *map = dwarf2_frame_fde_map ();
+  struct dwarf2_fde_map_segment *segment;
+  int lo, hi, i;
+
+  /* Find the last segment starting at or before *PC.  */
+  lo = 0;
+  hi = map->num_segments;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (map->segments[mid].start <= *pc)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  if (lo == 0)
+    return NULL;
+  segment = &map->segments[lo - 1];
+
+  for (i = 0; i < segment->count; i++)
+    {
+      struct dwarf2_fde_map_entry *entry
+	= map->candidates[segment->first + i];
+      struct dwarf2_fde_table *fde_table = entry->fde_table;
+      struct dwarf2_fde **p_fde;
+      CORE_ADDR seek_pc;
+
+      seek_pc = *pc - entry->offset;
       p_fde = ((struct dwarf2_fde **)
 	       bsearch (&seek_pc, fde_table->entries, fde_table->num_entries,
                         sizeof (fde_table->entries[0]), bsearch_fde_cmp));
       if (p_fde != NULL)
         {
-          *pc = (*p_fde)->initial_location + offset;
+          *pc = (*p_fde)->initial_location + entry->offset;
 	  if (out_offset)
-	    *out_offset = offset;
+	    *out_offset = entry->offset;
           return *p_fde;
         }
     }
@@ -2269,6 +2753,7 @@ dwarf2_build_frame_info (struct objfile *objfile)
   struct dwarf2_cie_table cie_table;
   struct dwarf2_fde_table fde_table;
   struct dwarf2_fde_table *fde_table2;
+  struct dwarf2_fde_map *map;
 
   cie_table.num_entries = 0;
   cie_table.entries = NULL;
@@ -2401,6 +2886,8 @@ dwarf2_build_frame_info (struct objfile *objfile)
     {
       fde_table2->entries = NULL;
       fde_table2->num_entries = 0;
+      fde_table2->low = 0;
+      fde_table2->high = 0;
     }
   else
     {
@@ -2453,6 +2940,18 @@ dwarf2_build_frame_info (struct objfile *objfile)
 	      && fde_prev->initial_location == fde->initial_location)
 	    continue;
 
+	  /* The table is sorted by start address; the highest address
+	     can be covered by any entry.  */
+	  if (fde_table2->num_entries == 0)
+	    {
+	      fde_table2->low = fde->initial_location;
+	      fde_table2->high = fde->initial_location;
+	    }
+	  if (fde->initial_location + fde->address_range - 1
+	      > fde_table2->high)
+	    fde_table2->high = (fde->initial_location
+				+ fde->address_range - 1);
+
 	  obstack_grow (&objfile->objfile_obstack, &fde_table.entries[i],
 			sizeof (fde_table.entries[0]));
 	  ++fde_table2->num_entries;
@@ -2466,6 +2965,12 @@ dwarf2_build_frame_info (struct objfile *objfile)
     }
 
   set_objfile_data (objfile, dwarf2_frame_objfile_data, fde_table2);
+
+  /* The FDE map of the program space may not know of this table.  */
+  map = ((struct dwarf2_fde_map *)
+	 program_space_data (objfile->pspace, dwarf2_frame_pspace_data));
+  if (map != NULL)
+    map->dirty = 1;
 }
 
 /* Provide a prototype to silence -Wmissing-prototypes.  */
@@ -2476,4 +2981,15 @@ _initialize_dwarf2_frame (void)
 {
   dwarf2_frame_data = gdbarch_data_register_pre_init (dwarf2_frame_init);
   dwarf2_frame_objfile_data = register_objfile_data ();
+  dwarf2_frame_rows_data
+    = register_objfile_data_with_cleanup (NULL, dwarf2_frame_rows_cleanup);
+
+  add_cmd ("flush-dwarf-cfi-cache", class_maintenance,
+	   maintenance_flush_dwarf_cfi_cache,
+	   _("Flush the DWARF call frame information rows cached for "
+	     "each objfile."),
+	   &maintenancelist);
+  dwarf2_frame_pspace_data
+    = register_program_space_data_with_cleanup (NULL,
+						dwarf2_frame_pspace_data_cleanup);
 }
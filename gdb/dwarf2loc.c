@@ -40,6 +40,7 @@
 #include "compile/compile.h"
 
 extern int dwarf_always_disassemble;
+extern int dwarf_compiled_locations;
 
 extern const struct dwarf_expr_context_funcs dwarf_expr_ctx_funcs;
 
@@ -2224,6 +2225,381 @@ const struct dwarf_expr_context_funcs dwarf_expr_ctx_funcs =
   dwarf_expr_get_obj_addr
 };
 
+/* The forms of location expressions which dwarf2_evaluate_loc_desc_full
+   evaluates directly, without running the DWARF expression
+   interpreter.  */
+
+enum dwarf2_compiled_loc_kind
+{
+  /* Any other expression, left to the interpreter.  */
+  DWARF2_COMPILED_LOC_INTERPRET,
+
+  /* DW_OP_regN or DW_OP_regx: the object is in register REG.  */
+  DWARF2_COMPILED_LOC_REG,
+
+  /* DW_OP_bregN or DW_OP_bregx: the object is in memory, at the
+     address in register REG plus OFFSET.  */
+  DWARF2_COMPILED_LOC_BREG,
+
+  /* DW_OP_fbreg: the object is in memory, at the frame base plus
+     OFFSET.  */
+  DWARF2_COMPILED_LOC_FBREG,
+
+  /* DW_OP_addr: the object is in memory, at ADDRESS plus the text
+     offset of the objfile.  */
+  DWARF2_COMPILED_LOC_ADDR,
+
+  /* DW_OP_call_frame_cfa: the CFA.  Only used for frame bases.  */
+  DWARF2_COMPILED_LOC_CFA
+};
+
+/* A location expression, translated once for all by
+   dwarf2_find_compiled_loc.  */
+
+struct dwarf2_compiled_loc
+{
+  /* The expression.  */
+  const gdb_byte *data;
+  size_t size;
+
+  enum dwarf2_compiled_loc_kind kind;
+  ULONGEST reg;
+  LONGEST offset;
+  CORE_ADDR address;
+};
+
+/* Per-objfile data key for the translated location expressions.  */
+static const struct objfile_data *dwarf2_compiled_loc_data;
+
+/* Hash function for the translated location expressions.  */
+
+static hashval_t
+hash_dwarf2_compiled_loc (const void *p)
+{
+  const struct dwarf2_compiled_loc *loc
+    = (const struct dwarf2_compiled_loc *) p;
+
+  return htab_hash_pointer (loc->data);
+}
+
+/* Equality function for the translated location expressions.  */
+
+static int
+eq_dwarf2_compiled_loc (const void *a, const void *b)
+{
+  const struct dwarf2_compiled_loc *la
+    = (const struct dwarf2_compiled_loc *) a;
+  const struct dwarf2_compiled_loc *lb
+    = (const struct dwarf2_compiled_loc *) b;
+
+  return la->data == lb->data && la->size == lb->size;
+}
+
+/* The objfile cleanup of the translated location expressions, which
+   are themselves on the objfile obstack.  */
+
+static void
+dwarf2_compiled_loc_cleanup (struct objfile *objfile, void *arg)
+{
+  htab_delete ((htab_t) arg);
+}
+
+/* Translate LOC->DATA, of LOC->SIZE bytes, into LOC.  GDBARCH and
+   ADDR_SIZE describe the objfile of the expression.  */
+
+static void
+dwarf2_compile_loc (struct dwarf2_compiled_loc *loc,
+		    struct gdbarch *gdbarch, int addr_size)
+{
+  const gdb_byte *op_ptr = loc->data;
+  const gdb_byte *op_end = loc->data + loc->size;
+  uint64_t uoffset = 0;
+  int64_t offset = 0;
+  gdb_byte op;
+
+  loc->kind = DWARF2_COMPILED_LOC_INTERPRET;
+  if (loc->size == 0)
+    return;
+
+  op = *op_ptr++;
+  if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+    {
+      loc->kind = DWARF2_COMPILED_LOC_REG;
+      loc->reg = op - DW_OP_reg0;
+    }
+  else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+    {
+      op_ptr = gdb_read_sleb128 (op_ptr, op_end, &offset);
+      loc->kind = DWARF2_COMPILED_LOC_BREG;
+      loc->reg = op - DW_OP_breg0;
+      loc->offset = offset;
+    }
+  else
+    switch (op)
+      {
+      case DW_OP_regx:
+	op_ptr = gdb_read_uleb128 (op_ptr, op_end, &uoffset);
+	loc->kind = DWARF2_COMPILED_LOC_REG;
+	loc->reg = uoffset;
+	break;
+
+      case DW_OP_bregx:
+	op_ptr = gdb_read_uleb128 (op_ptr, op_end, &uoffset);
+	if (op_ptr != NULL)
+	  op_ptr = gdb_read_sleb128 (op_ptr, op_end, &offset);
+	loc->kind = DWARF2_COMPILED_LOC_BREG;
+	loc->reg = uoffset;
+	loc->offset = offset;
+	break;
+
+      case DW_OP_fbreg:
+	op_ptr = gdb_read_sleb128 (op_ptr, op_end, &offset);
+	loc->kind = DWARF2_COMPILED_LOC_FBREG;
+	loc->offset = offset;
+	break;
+
+      case DW_OP_addr:
+	if (op_end - op_ptr < addr_size)
+	  return;
+	loc->kind = DWARF2_COMPILED_LOC_ADDR;
+	loc->address = extract_unsigned_integer (op_ptr, addr_size,
+						 gdbarch_byte_order (gdbarch));
+	op_ptr += addr_size;
+	break;
+
+      case DW_OP_call_frame_cfa:
+	loc->kind = DWARF2_COMPILED_LOC_CFA;
+	break;
+      }
+
+  /* The whole expression must be a single operation.  */
+  if (op_ptr != op_end || loc->reg > INT_MAX)
+    loc->kind = DWARF2_COMPILED_LOC_INTERPRET;
+}
+
+/* Return the translation of the location expression DATA, of SIZE
+   bytes, from OBJFILE.  ADDR_SIZE is the size of addresses in the
+   expression.  */
+
+static const struct dwarf2_compiled_loc *
+dwarf2_find_compiled_loc (struct objfile *objfile, const gdb_byte *data,
+			  size_t size, int addr_size)
+{
+  struct dwarf2_compiled_loc key, *loc;
+  htab_t locs;
+  void **slot;
+
+  locs = (htab_t) objfile_data (objfile, dwarf2_compiled_loc_data);
+  if (locs == NULL)
+    {
+      locs = htab_create_alloc (127, hash_dwarf2_compiled_loc,
+				eq_dwarf2_compiled_loc, NULL,
+				xcalloc, xfree);
+      set_objfile_data (objfile, dwarf2_compiled_loc_data, locs);
+    }
+
+  key.data = data;
+  key.size = size;
+  slot = htab_find_slot (locs, &key, INSERT);
+  if (*slot != NULL)
+    return (const struct dwarf2_compiled_loc *) *slot;
+
+  loc = OBSTACK_ZALLOC (&objfile->objfile_obstack,
+			struct dwarf2_compiled_loc);
+  loc->data = data;
+  loc->size = size;
+  dwarf2_compile_loc (loc, get_objfile_arch (objfile), addr_size);
+  *slot = loc;
+
+  return loc;
+}
+
+/* Return the value of TYPE, at BYTE_OFFSET within DWARF register
+   DWARF_REGNUM of FRAME.  */
+
+static struct value *
+dwarf2_register_loc_value (struct type *type, struct frame_info *frame,
+			   int dwarf_regnum, LONGEST byte_offset)
+{
+  struct gdbarch *arch = get_frame_arch (frame);
+  int gdb_regnum = dwarf_reg_to_regnum_or_error (arch, dwarf_regnum);
+  struct value *retval;
+
+  if (byte_offset != 0)
+    error (_("cannot use offset on synthetic pointer to register"));
+  retval = value_from_register (type, gdb_regnum, frame);
+  if (value_optimized_out (retval))
+    {
+      struct value *tmp;
+
+      /* This means the register has undefined value / was
+	 not saved.  As we're computing the location of some
+	 variable etc. in the program, not a value for
+	 inspecting a register ($pc, $sp, etc.), return a
+	 generic optimized out value instead, so that we show
+	 <optimized out> instead of <not saved>.  */
+      tmp = allocate_value (type);
+      value_contents_copy (tmp, 0, retval, 0, TYPE_LENGTH (type));
+      retval = tmp;
+    }
+
+  return retval;
+}
+
+/* Return ADDRESS, the location of an object of TYPE computed by a
+   DWARF expression for GDBARCH, converted from a pointer to an
+   address.  */
+
+static CORE_ADDR
+dwarf2_loc_pointer_to_address (struct type *type, struct gdbarch *gdbarch,
+			       CORE_ADDR address)
+{
+  struct type *ptr_type;
+
+  /* DW_OP_deref_size (and possibly other operations too) may
+     create a pointer instead of an address.  Ideally, the
+     pointer to address conversion would be performed as part
+     of those operations, but the type of the object to
+     which the address refers is not known at the time of
+     the operation.  Therefore, we do the conversion here
+     since the type is readily available.  */
+
+  switch (TYPE_CODE (type))
+    {
+      case TYPE_CODE_FUNC:
+      case TYPE_CODE_METHOD:
+	ptr_type = builtin_type (gdbarch)->builtin_func_ptr;
+	break;
+      default:
+	ptr_type = builtin_type (gdbarch)->builtin_data_ptr;
+	break;
+    }
+  return value_as_address (value_from_pointer (ptr_type, address));
+}
+
+/* Try to compute the value of TYPE in FRAME described by DATA, SIZE,
+   PER_CU and BYTE_OFFSET as dwarf2_evaluate_loc_desc_full does, for
+   the simple expressions which dwarf2_find_compiled_loc translates.
+   Return NULL if the expression has another form.  */
+
+static struct value *
+dwarf2_evaluate_compiled_loc (struct type *type, struct frame_info *frame,
+			      const gdb_byte *data, size_t size,
+			      struct dwarf2_per_cu_data *per_cu,
+			      LONGEST byte_offset)
+{
+  struct objfile *objfile = dwarf2_per_cu_objfile (per_cu);
+  struct gdbarch *gdbarch = get_objfile_arch (objfile);
+  int addr_size = dwarf2_per_cu_addr_size (per_cu);
+  const struct dwarf2_compiled_loc *loc, *base = NULL;
+  CORE_ADDR address = 0;
+  struct value *retval;
+
+  /* The interpreter truncates addresses to ADDR_SIZE bytes, and lets
+     the architecture convert them; only handle the usual case.  */
+  if (gdbarch_integer_to_address_p (gdbarch)
+      || (addr_size != 2 && addr_size != 4 && addr_size != 8))
+    return NULL;
+
+  loc = dwarf2_find_compiled_loc (objfile, data, size, addr_size);
+  switch (loc->kind)
+    {
+    case DWARF2_COMPILED_LOC_REG:
+      if (frame == NULL)
+	return NULL;
+      return dwarf2_register_loc_value (type, frame, loc->reg, byte_offset);
+
+    case DWARF2_COMPILED_LOC_BREG:
+      if (frame == NULL)
+	return NULL;
+      break;
+
+    case DWARF2_COMPILED_LOC_FBREG:
+      {
+	struct dwarf_expr_baton baton;
+	const gdb_byte *base_data;
+	size_t base_size;
+
+	if (frame == NULL)
+	  return NULL;
+	baton.frame = frame;
+	baton.per_cu = per_cu;
+	baton.obj_address = 0;
+	dwarf_expr_frame_base (&baton, &base_data, &base_size);
+	base = dwarf2_find_compiled_loc (objfile, base_data, base_size,
+					 addr_size);
+	if (base->kind != DWARF2_COMPILED_LOC_REG
+	    && base->kind != DWARF2_COMPILED_LOC_BREG
+	    && base->kind != DWARF2_COMPILED_LOC_CFA)
+	  return NULL;
+      }
+      break;
+
+    case DWARF2_COMPILED_LOC_ADDR:
+      break;
+
+    default:
+      return NULL;
+    }
+
+  TRY
+    {
+      switch (loc->kind)
+	{
+	case DWARF2_COMPILED_LOC_BREG:
+	  address = (address_from_register
+		     (dwarf_reg_to_regnum_or_error (get_frame_arch (frame),
+						    loc->reg),
+		      frame)
+		     + loc->offset);
+	  break;
+
+	case DWARF2_COMPILED_LOC_FBREG:
+	  if (base->kind == DWARF2_COMPILED_LOC_CFA)
+	    address = dwarf2_frame_cfa (frame);
+	  else
+	    {
+	      address = (address_from_register
+			 (dwarf_reg_to_regnum_or_error (get_frame_arch (frame),
+							base->reg),
+			  frame));
+	      if (base->kind == DWARF2_COMPILED_LOC_BREG)
+		address += base->offset;
+	    }
+	  address += loc->offset;
+	  break;
+
+	case DWARF2_COMPILED_LOC_ADDR:
+	  address = loc->address + dwarf2_per_cu_text_offset (per_cu);
+	  break;
+
+	default:
+	  gdb_assert_not_reached ("unexpected compiled location");
+	}
+    }
+  CATCH (ex, RETURN_MASK_ERROR)
+    {
+      if (ex.error == NOT_AVAILABLE_ERROR)
+	{
+	  retval = allocate_value (type);
+	  mark_value_bytes_unavailable (retval, 0, TYPE_LENGTH (type));
+	  return retval;
+	}
+      throw_exception (ex);
+    }
+  END_CATCH
+
+  if (addr_size < (int) sizeof (CORE_ADDR))
+    address &= ((CORE_ADDR) 1 << (8 * addr_size)) - 1;
+
+  address = dwarf2_loc_pointer_to_address (type, gdbarch, address);
+  retval = value_at_lazy (type, address + byte_offset);
+  if (loc->kind == DWARF2_COMPILED_LOC_FBREG)
+    set_value_stack (retval, 1);
+
+  return retval;
+}
+
 /* Evaluate a location description, starting at DATA and with length
    SIZE, to find the current location of variable of TYPE in the
    context of FRAME.  BYTE_OFFSET is applied after the contents are
@@ -2247,6 +2623,16 @@ dwarf2_evaluate_loc_desc_full (struct type *type, struct frame_info *frame,
   if (size == 0)
     return allocate_optimized_out_value (type);
 
+  /* Most variables live at a constant offset from a register or the
+     frame base; their value needs no interpreter.  */
+  if (dwarf_compiled_locations)
+    {
+      retval = dwarf2_evaluate_compiled_loc (type, frame, data, size,
+					     per_cu, byte_offset);
+      if (retval != NULL)
+	return retval;
+    }
+
   baton.frame = frame;
   baton.per_cu = per_cu;
   baton.obj_address = 0;
@@ -2314,58 +2700,23 @@ dwarf2_evaluate_loc_desc_full (struct type *type, struct frame_info *frame,
 	{
 	case DWARF_VALUE_REGISTER:
 	  {
-	    struct gdbarch *arch = get_frame_arch (frame);
 	    int dwarf_regnum
 	      = longest_to_int (value_as_long (dwarf_expr_fetch (ctx, 0)));
-	    int gdb_regnum = dwarf_reg_to_regnum_or_error (arch, dwarf_regnum);
 
 	    if (byte_offset != 0)
 	      error (_("cannot use offset on synthetic pointer to register"));
 	    do_cleanups (value_chain);
-	    retval = value_from_register (type, gdb_regnum, frame);
-	    if (value_optimized_out (retval))
-	      {
-		struct value *tmp;
-
-		/* This means the register has undefined value / was
-		   not saved.  As we're computing the location of some
-		   variable etc. in the program, not a value for
-		   inspecting a register ($pc, $sp, etc.), return a
-		   generic optimized out value instead, so that we show
-		   <optimized out> instead of <not saved>.  */
-		do_cleanups (value_chain);
-		tmp = allocate_value (type);
-		value_contents_copy (tmp, 0, retval, 0, TYPE_LENGTH (type));
-		retval = tmp;
-	      }
+	    retval = dwarf2_register_loc_value (type, frame, dwarf_regnum, 0);
 	  }
 	  break;
 
 	case DWARF_VALUE_MEMORY:
 	  {
-	    struct type *ptr_type;
 	    CORE_ADDR address = dwarf_expr_fetch_address (ctx, 0);
 	    int in_stack_memory = dwarf_expr_fetch_in_stack_memory (ctx, 0);
 
-	    /* DW_OP_deref_size (and possibly other operations too) may
-	       create a pointer instead of an address.  Ideally, the
-	       pointer to address conversion would be performed as part
-	       of those operations, but the type of the object to
-	       which the address refers is not known at the time of
-	       the operation.  Therefore, we do the conversion here
-	       since the type is readily available.  */
-
-	    switch (TYPE_CODE (type))
-	      {
-		case TYPE_CODE_FUNC:
-		case TYPE_CODE_METHOD:
-		  ptr_type = builtin_type (ctx->gdbarch)->builtin_func_ptr;
-		  break;
-		default:
-		  ptr_type = builtin_type (ctx->gdbarch)->builtin_data_ptr;
-		  break;
-	      }
-	    address = value_as_address (value_from_pointer (ptr_type, address));
+	    address = dwarf2_loc_pointer_to_address (type, ctx->gdbarch,
+						     address);
 
 	    do_cleanups (value_chain);
 	    retval = value_at_lazy (type, address + byte_offset);
@@ -4644,4 +4995,7 @@ _initialize_dwarf2loc (void)
 			     NULL,
 			     show_entry_values_debug,
 			     &setdebuglist, &showdebuglist);
+
+  dwarf2_compiled_loc_data
+    = register_objfile_data_with_cleanup (NULL, dwarf2_compiled_loc_cleanup);
 }
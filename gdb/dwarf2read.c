@@ -70,6 +70,8 @@
 #include "filestuff.h"
 #include "build-id.h"
 #include "namespace.h"
+#include "trigram.h"
+#include "worker-threads.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -198,6 +200,10 @@ struct mapped_index
 
   /* A pointer to the constant pool.  */
   const char *constant_pool;
+
+  /* A trigram index of the names of the symbol table slots, built the
+     first time a symbol search needs it, or NULL.  */
+  struct trigram_index *trigrams;
 };
 
 typedef struct dwarf2_per_cu_data *dwarf2_per_cu_ptr;
@@ -269,6 +275,14 @@ struct dwarf2_per_objfile
      they can be freed later.  */
   struct dwarf2_per_cu_data *read_in_chain;
 
+  /* A table of the compilation units whose DIEs were read in by worker
+     threads, and whose symtabs are about to be expanded; see
+     dwarf2_preload_comp_units.  The elements are the dwarf2_cu
+     objects, which are not in READ_IN_CHAIN, and whose per_cu->cu
+     field is not set until they are used.  NULL if the table hasn't
+     been allocated yet.  */
+  htab_t preloaded_cus;
+
   /* A table mapping DW_AT_dwo_name values to struct dwo_file objects.
      This is NULL if the table hasn't been allocated yet.  */
   htab_t dwo_files;
@@ -1429,6 +1443,9 @@ static void add_partial_subprogram (struct partial_die_info *pdi,
 static void dwarf2_read_symtab (struct partial_symtab *,
 				struct objfile *);
 
+static int dwarf2_prepare_read_symtabs (struct partial_symtab **, int,
+					struct objfile *);
+
 static void psymtab_to_symtab_1 (struct partial_symtab *);
 
 static struct abbrev_info *abbrev_table_lookup_abbrev
@@ -1857,6 +1874,21 @@ static void init_cutu_and_read_dies_simple
   (struct dwarf2_per_cu_data *this_cu,
    die_reader_func_ftype *die_reader_func, void *data);
 
+static void init_cu_die_reader (struct die_reader_specs *reader,
+				struct dwarf2_cu *cu,
+				struct dwarf2_section_info *section,
+				struct dwo_file *dwo_file);
+
+static struct dwarf2_section_info *get_abbrev_section_for_cu
+  (struct dwarf2_per_cu_data *this_cu);
+
+static unsigned int get_cu_length (const struct comp_unit_head *header);
+
+static void load_full_comp_unit_reader (const struct die_reader_specs *reader,
+					const gdb_byte *info_ptr,
+					struct die_info *comp_unit_die,
+					int has_children, void *data);
+
 static htab_t allocate_signatured_type_table (struct objfile *objfile);
 
 static htab_t allocate_dwo_unit_table (struct objfile *objfile);
@@ -2675,6 +2707,328 @@ load_cu (struct dwarf2_per_cu_data *per_cu)
   dwarf2_find_base_address (per_cu->cu->dies, per_cu->cu);
 }
 
+/* The number of compilation units that dwarf2_preload_comp_units
+   reads per worker thread at once.  Preloaded DIE trees are not
+   aged like the cached ones, so bound the memory they use.  */
+#define DWARF2_PRELOAD_BATCH_PER_THREAD 4
+
+/* Return the number of compilation units to preload at once, or 0 if
+   they should not be preloaded.  */
+
+static int
+dwarf2_preload_batch_size (void)
+{
+  int nthreads = worker_thread_count ();
+
+  /* Reading DIEs in parallel would scramble the debug output.  */
+  if (nthreads < 2 || dwarf_die_debug)
+    return 0;
+  return nthreads * DWARF2_PRELOAD_BATCH_PER_THREAD;
+}
+
+/* Hash and equality functions for preloaded_cus: the table is keyed
+   by the per_cu of the dwarf2_cu objects it holds.  */
+
+static hashval_t
+hash_preloaded_cu (const void *item)
+{
+  const struct dwarf2_cu *cu = (const struct dwarf2_cu *) item;
+
+  return htab_hash_pointer (cu->per_cu);
+}
+
+static int
+eq_preloaded_cu (const void *item_lhs, const void *item_rhs)
+{
+  const struct dwarf2_cu *cu = (const struct dwarf2_cu *) item_lhs;
+
+  return cu->per_cu == item_rhs;
+}
+
+/* Free CU, a preloaded compilation unit.  Unlike free_heap_comp_unit,
+   this doesn't touch CU->per_cu->cu, which doesn't refer to CU.  */
+
+static void
+free_preloaded_comp_unit (struct dwarf2_cu *cu)
+{
+  if (cu->abbrev_table != NULL)
+    dwarf2_free_abbrev_table (cu);
+  obstack_free (&cu->comp_unit_obstack, NULL);
+  xfree (cu);
+}
+
+/* htab_traverse callback for dwarf2_free_preloaded_comp_units.  */
+
+static int
+free_preloaded_comp_unit_trav (void **slot, void *info)
+{
+  free_preloaded_comp_unit ((struct dwarf2_cu *) *slot);
+  return 1;
+}
+
+/* Free the preloaded compilation units that were not used.  */
+
+static void
+dwarf2_free_preloaded_comp_units (void *ignore)
+{
+  htab_t preloaded_cus = dwarf2_per_objfile->preloaded_cus;
+
+  if (preloaded_cus == NULL || htab_elements (preloaded_cus) == 0)
+    return;
+
+  htab_traverse_noresize (preloaded_cus, free_preloaded_comp_unit_trav, NULL);
+  htab_empty (preloaded_cus);
+}
+
+/* Read the DIEs of CU, like load_cu does, without modifying anything
+   but CU itself: this runs in a worker thread.  Return zero if CU
+   needs anything more, such as a DWO file or other compilation units,
+   in which case load_cu must read it in the main thread.  */
+
+static int
+read_preloaded_comp_unit (struct dwarf2_cu *cu)
+{
+  struct dwarf2_per_cu_data *this_cu = cu->per_cu;
+  struct dwarf2_section_info *section = this_cu->section;
+  bfd *abfd = get_section_bfd_owner (section);
+  const gdb_byte *begin_info_ptr, *info_ptr;
+  struct die_reader_specs reader;
+  struct die_info *comp_unit_die;
+  int has_children;
+  enum language pretend_language = language_minimal;
+
+  begin_info_ptr = info_ptr = section->buffer + this_cu->offset.sect_off;
+  info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+					    get_abbrev_section_for_cu (this_cu),
+					    info_ptr, 0);
+  if (this_cu->offset.sect_off != cu->header.offset.sect_off
+      || this_cu->length != get_cu_length (&cu->header))
+    return 0;
+
+  /* Skip dummy compilation units.  */
+  if (info_ptr >= begin_info_ptr + this_cu->length
+      || peek_abbrev_code (abfd, info_ptr) == 0)
+    return 0;
+
+  dwarf2_read_abbrevs (cu, get_abbrev_section_for_cu (this_cu));
+
+  init_cu_die_reader (&reader, cu, section, NULL);
+  info_ptr = read_full_die (&reader, &comp_unit_die, info_ptr, &has_children);
+
+  /* Following these attributes would look at other units.  */
+  if (dwarf2_attr_no_follow (comp_unit_die, DW_AT_GNU_dwo_name) != NULL
+      || dwarf2_attr_no_follow (comp_unit_die, DW_AT_specification) != NULL
+      || dwarf2_attr_no_follow (comp_unit_die, DW_AT_abstract_origin) != NULL)
+    return 0;
+
+  load_full_comp_unit_reader (&reader, info_ptr, comp_unit_die, has_children,
+			      &pretend_language);
+  dwarf2_find_base_address (cu->dies, cu);
+  dwarf2_free_abbrev_table (cu);
+  return 1;
+}
+
+/* The data passed to dwarf2_preload_comp_unit.  */
+
+struct preload_comp_units_data
+{
+  /* The compilation units to read.  */
+  struct dwarf2_per_cu_data **per_cus;
+
+  /* Where to store the dwarf2_cu of each of PER_CUS, or NULL if it
+     could not be preloaded.  */
+  struct dwarf2_cu **cus;
+};
+
+/* parallel_for_each callback reading the Ith compilation unit of
+   DATA, a struct preload_comp_units_data.  */
+
+static void
+dwarf2_preload_comp_unit (int i, void *data)
+{
+  struct preload_comp_units_data *preload
+    = (struct preload_comp_units_data *) data;
+  struct dwarf2_per_cu_data *per_cu = preload->per_cus[i];
+  struct dwarf2_cu *cu = XNEW (struct dwarf2_cu);
+  int ok = 0;
+
+  /* The DIE reader expects PER_CU->cu to be set; nothing else looks
+     at it while the units are preloaded.  */
+  init_one_comp_unit (cu, per_cu);
+
+  TRY
+    {
+      ok = read_preloaded_comp_unit (cu);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      ok = 0;
+    }
+  END_CATCH
+
+  per_cu->cu = NULL;
+  if (!ok)
+    {
+      free_preloaded_comp_unit (cu);
+      cu = NULL;
+    }
+  preload->cus[i] = cu;
+}
+
+/* Return non-zero if PER_CU is a compilation unit that
+   dwarf2_preload_comp_units can read.  */
+
+static int
+dwarf2_preloadable_cu_p (struct dwarf2_per_cu_data *per_cu)
+{
+  if (per_cu->is_debug_types
+      || IS_TYPE_UNIT_GROUP (per_cu)
+      || per_cu->reading_dwo_directly
+      || per_cu->cu != NULL)
+    return 0;
+
+  if (dwarf2_per_objfile->using_index
+      ? per_cu->v.quick->compunit_symtab != NULL
+      : (per_cu->v.psymtab == NULL || per_cu->v.psymtab->readin))
+    return 0;
+
+  return (dwarf2_per_objfile->preloaded_cus == NULL
+	  || htab_find_with_hash (dwarf2_per_objfile->preloaded_cus, per_cu,
+				  htab_hash_pointer (per_cu)) == NULL);
+}
+
+/* Read the DIEs of the COUNT compilation units PER_CUS, which are
+   about to be expanded, using worker threads.  The DIEs are kept
+   in preloaded_cus until dw2_do_instantiate_symtab uses them.
+   Units that cannot be read this way are skipped; they are read as
+   usual when they are expanded.  dw2_setup must have been already
+   called.  */
+
+static void
+dwarf2_preload_comp_units (struct dwarf2_per_cu_data **per_cus, int count)
+{
+  struct objfile *objfile = dwarf2_per_objfile->objfile;
+  struct preload_comp_units_data preload;
+  struct cleanup *cleanups;
+  VEC (dwarf2_per_cu_ptr) *todo = NULL;
+  htab_t seen;
+  int i, n, sections_ok = 1;
+
+  if (dwarf2_preload_batch_size () == 0)
+    return;
+
+  cleanups = make_cleanup (VEC_cleanup (dwarf2_per_cu_ptr), &todo);
+  seen = htab_create_alloc (count, htab_hash_pointer, htab_eq_pointer,
+			    NULL, xcalloc, xfree);
+  make_cleanup_htab_delete (seen);
+  for (i = 0; i < count; ++i)
+    {
+      void **slot;
+
+      if (!dwarf2_preloadable_cu_p (per_cus[i]))
+	continue;
+      slot = htab_find_slot (seen, per_cus[i], INSERT);
+      if (*slot != NULL)
+	continue;
+      *slot = per_cus[i];
+      VEC_safe_push (dwarf2_per_cu_ptr, todo, per_cus[i]);
+    }
+
+  n = VEC_length (dwarf2_per_cu_ptr, todo);
+  if (n < 2)
+    {
+      do_cleanups (cleanups);
+      return;
+    }
+
+  /* Worker threads must not read sections in, or open the dwz file,
+     so do it now.  */
+  TRY
+    {
+      struct dwz_file *dwz;
+
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->abbrev);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+      dwarf2_read_section (objfile, &dwarf2_per_objfile->addr);
+      for (i = 0; i < n; ++i)
+	{
+	  struct dwarf2_per_cu_data *per_cu
+	    = VEC_index (dwarf2_per_cu_ptr, todo, i);
+
+	  dwarf2_read_section (objfile, per_cu->section);
+	}
+
+      dwz = dwarf2_get_dwz_file ();
+      if (dwz != NULL)
+	{
+	  dwarf2_read_section (objfile, &dwz->info);
+	  dwarf2_read_section (objfile, &dwz->abbrev);
+	  dwarf2_read_section (objfile, &dwz->str);
+	}
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      sections_ok = 0;
+    }
+  END_CATCH
+
+  if (sections_ok)
+    {
+      preload.per_cus = VEC_address (dwarf2_per_cu_ptr, todo);
+      preload.cus = XNEWVEC (struct dwarf2_cu *, n);
+      make_cleanup (xfree, preload.cus);
+
+      parallel_for_each (n, dwarf2_preload_comp_unit, &preload);
+
+      if (dwarf2_per_objfile->preloaded_cus == NULL)
+	dwarf2_per_objfile->preloaded_cus
+	  = htab_create_alloc (n, hash_preloaded_cu, eq_preloaded_cu,
+			       NULL, xcalloc, xfree);
+      for (i = 0; i < n; ++i)
+	{
+	  struct dwarf2_cu *cu = preload.cus[i];
+	  void **slot;
+
+	  if (cu == NULL)
+	    continue;
+	  slot = htab_find_slot_with_hash (dwarf2_per_objfile->preloaded_cus,
+					   cu->per_cu,
+					   htab_hash_pointer (cu->per_cu),
+					   INSERT);
+	  gdb_assert (*slot == NULL);
+	  *slot = cu;
+	}
+    }
+
+  do_cleanups (cleanups);
+}
+
+/* If the DIEs of PER_CU were preloaded, make them PER_CU->cu, as
+   load_cu would, and return non-zero.  Otherwise return zero.  */
+
+static int
+take_preloaded_comp_unit (struct dwarf2_per_cu_data *per_cu)
+{
+  htab_t preloaded_cus = dwarf2_per_objfile->preloaded_cus;
+  struct dwarf2_cu *cu;
+  void **slot;
+
+  if (preloaded_cus == NULL || per_cu->cu != NULL)
+    return 0;
+
+  slot = htab_find_slot_with_hash (preloaded_cus, per_cu,
+				   htab_hash_pointer (per_cu), NO_INSERT);
+  if (slot == NULL)
+    return 0;
+  cu = (struct dwarf2_cu *) *slot;
+  htab_clear_slot (preloaded_cus, slot);
+
+  per_cu->cu = cu;
+  cu->read_in_chain = dwarf2_per_objfile->read_in_chain;
+  dwarf2_per_objfile->read_in_chain = per_cu;
+  return 1;
+}
+
 /* Read in the symbols for PER_CU.  */
 
 static void
@@ -2694,7 +3048,8 @@ dw2_do_instantiate_symtab (struct dwarf2_per_cu_data *per_cu)
       : (per_cu->v.psymtab == NULL || !per_cu->v.psymtab->readin))
     {
       queue_comp_unit (per_cu, language_minimal);
-      load_cu (per_cu);
+      if (!take_preloaded_comp_unit (per_cu))
+	load_cu (per_cu);
 
       /* If we just loaded a CU from a DWO, and we're working with an index
 	 that may badly handle TUs, load all the TUs in that DWO as well.
@@ -2738,6 +3093,45 @@ dw2_instantiate_symtab (struct dwarf2_per_cu_data *per_cu)
   return per_cu->v.quick->compunit_symtab;
 }
 
+/* Ensure that the symbols for the COUNT units PER_CUS have been read
+   in, reading the DIEs of several of them at once with worker
+   threads.  If EXPANSION_NOTIFY is not NULL, call it with DATA for
+   each symtab this expands, in the order of PER_CUS.  */
+
+static void
+dw2_instantiate_symtabs (struct dwarf2_per_cu_data **per_cus, int count,
+			 expand_symtabs_exp_notify_ftype *expansion_notify,
+			 void *data)
+{
+  struct cleanup *back_to;
+  int batch_size = dwarf2_preload_batch_size ();
+  int i;
+
+  back_to = make_cleanup (dwarf2_free_preloaded_comp_units, NULL);
+  for (i = 0; i < count; ++i)
+    {
+      struct dwarf2_per_cu_data *per_cu = per_cus[i];
+      int symtab_was_null = (per_cu->v.quick->compunit_symtab == NULL);
+
+      QUIT;
+
+      if (batch_size > 0 && i % batch_size == 0)
+	{
+	  dwarf2_free_preloaded_comp_units (NULL);
+	  dwarf2_preload_comp_units (per_cus + i,
+				     min (batch_size, count - i));
+	}
+
+      dw2_instantiate_symtab (per_cu);
+
+      if (expansion_notify != NULL
+	  && symtab_was_null
+	  && per_cu->v.quick->compunit_symtab != NULL)
+	expansion_notify (per_cu->v.quick->compunit_symtab, data);
+    }
+  do_cleanups (back_to);
+}
+
 /* Return the CU/TU given its index.
 
    This is intended for loops like:
@@ -3233,6 +3627,7 @@ dwarf2_read_index (struct objfile *objfile)
 
   map = XOBNEW (&objfile->objfile_obstack, struct mapped_index);
   *map = local_map;
+  map->trigrams = NULL;
 
   dwarf2_per_objfile->index_table = map;
   dwarf2_per_objfile->using_index = 1;
@@ -3788,16 +4183,25 @@ static void
 dw2_expand_all_symtabs (struct objfile *objfile)
 {
   int i;
+  struct cleanup *cleanup;
+  VEC (dwarf2_per_cu_ptr) *per_cus = NULL;
 
   dw2_setup (objfile);
 
+  cleanup = make_cleanup (VEC_cleanup (dwarf2_per_cu_ptr), &per_cus);
   for (i = 0; i < (dwarf2_per_objfile->n_comp_units
 		   + dwarf2_per_objfile->n_type_units); ++i)
     {
       struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
 
-      dw2_instantiate_symtab (per_cu);
+      if (per_cu->v.quick->compunit_symtab == NULL)
+	VEC_safe_push (dwarf2_per_cu_ptr, per_cus, per_cu);
     }
+
+  dw2_instantiate_symtabs (VEC_address (dwarf2_per_cu_ptr, per_cus),
+			   VEC_length (dwarf2_per_cu_ptr, per_cus),
+			   NULL, NULL);
+  do_cleanups (cleanup);
 }
 
 static void
@@ -3854,18 +4258,52 @@ dw2_map_matching_symbols (struct objfile *objfile,
      does not look for non-Ada symbols this function should just return.  */
 }
 
+/* Return the trigram index of the names in the symbol table of INDEX,
+   building it if needed.  */
+
+static const struct trigram_index *
+dw2_trigram_index (struct mapped_index *index)
+{
+  struct trigram_index_builder *builder;
+  offset_type iter;
+
+  if (index->trigrams != NULL)
+    return index->trigrams;
+
+  builder = trigram_index_builder_new ();
+  for (iter = 0; iter < index->symbol_table_slots; ++iter)
+    {
+      offset_type idx = 2 * iter;
+
+      if (index->symbol_table[idx] == 0 && index->symbol_table[idx + 1] == 0)
+	continue;
+
+      trigram_index_builder_add (builder, iter,
+				 (index->constant_pool
+				  + MAYBE_SWAP (index->symbol_table[idx])));
+    }
+
+  index->trigrams = trigram_index_builder_finish (builder);
+  return index->trigrams;
+}
+
 static void
 dw2_expand_symtabs_matching
   (struct objfile *objfile,
    expand_symtabs_file_matcher_ftype *file_matcher,
    expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+   const struct trigram_query *query,
    expand_symtabs_exp_notify_ftype *expansion_notify,
    enum search_domain kind,
    void *data)
 {
   int i;
-  offset_type iter;
+  offset_type iter, num_slots, slot;
   struct mapped_index *index;
+  VEC (int) *slots = NULL;
+  VEC (dwarf2_per_cu_ptr) *per_cus = NULL;
+  htab_t matched;
+  struct cleanup *old_chain;
 
   dw2_setup (objfile);
 
@@ -3953,15 +4391,32 @@ dw2_expand_symtabs_matching
       do_cleanups (cleanup);
     }
 
-  for (iter = 0; iter < index->symbol_table_slots; ++iter)
+  /* Only consider the names that may match QUERY, if any.  */
+  old_chain = make_cleanup (VEC_cleanup (int), &slots);
+  make_cleanup (VEC_cleanup (dwarf2_per_cu_ptr), &per_cus);
+  matched = htab_create_alloc (10, htab_hash_pointer, htab_eq_pointer,
+			       NULL, xcalloc, xfree);
+  make_cleanup_htab_delete (matched);
+  if (query != NULL)
     {
-      offset_type idx = 2 * iter;
+      trigram_index_lookup (dw2_trigram_index (index), query, &slots);
+      num_slots = VEC_length (int, slots);
+    }
+  else
+    num_slots = index->symbol_table_slots;
+
+  for (slot = 0; slot < num_slots; ++slot)
+    {
+      offset_type idx;
       const char *name;
       offset_type *vec, vec_len, vec_idx;
       int global_seen = 0;
 
       QUIT;
 
+      iter = query != NULL ? VEC_index (int, slots, slot) : slot;
+      idx = 2 * iter;
+
       if (index->symbol_table[idx] == 0 && index->symbol_table[idx + 1] == 0)
 	continue;
 
@@ -4034,23 +4489,27 @@ dw2_expand_symtabs_matching
 	    }
 
 	  per_cu = dw2_get_cutu (cu_index);
-	  if (file_matcher == NULL || per_cu->v.quick->mark)
+	  if ((file_matcher == NULL || per_cu->v.quick->mark)
+	      && per_cu->v.quick->compunit_symtab == NULL)
 	    {
-	      int symtab_was_null =
-		(per_cu->v.quick->compunit_symtab == NULL);
-
-	      dw2_instantiate_symtab (per_cu);
+	      void **cu_slot = htab_find_slot (matched, per_cu, INSERT);
 
-	      if (expansion_notify != NULL
-		  && symtab_was_null
-		  && per_cu->v.quick->compunit_symtab != NULL)
+	      if (*cu_slot == NULL)
 		{
-		  expansion_notify (per_cu->v.quick->compunit_symtab,
-				    data);
+		  *cu_slot = per_cu;
+		  VEC_safe_push (dwarf2_per_cu_ptr, per_cus, per_cu);
 		}
 	    }
 	}
     }
+
+  /* Expand the units in the order they were matched, all at once so
+     that their DIEs can be read in parallel.  */
+  dw2_instantiate_symtabs (VEC_address (dwarf2_per_cu_ptr, per_cus),
+			   VEC_length (dwarf2_per_cu_ptr, per_cus),
+			   expansion_notify, data);
+
+  do_cleanups (old_chain);
 }
 
 /* A helper for dw2_find_pc_sect_compunit_symtab which finds the most specific
@@ -4520,6 +4979,7 @@ dwarf2_create_include_psymtab (const char *name, struct partial_symtab *pst,
   subpst->n_static_syms = 0;
   subpst->compunit_symtab = NULL;
   subpst->read_symtab = pst->read_symtab;
+  subpst->prepare_read_symtabs = pst->prepare_read_symtabs;
   subpst->readin = 0;
 
   /* No private part is necessary for include psymtabs.  This property
@@ -5912,6 +6372,7 @@ create_partial_symtab (struct dwarf2_per_cu_data *per_cu, const char *name)
   /* This is the glue that links PST into GDB's symbol API.  */
   pst->read_symtab_private = per_cu;
   pst->read_symtab = dwarf2_read_symtab;
+  pst->prepare_read_symtabs = dwarf2_prepare_read_symtabs;
   per_cu->v.psymtab = pst;
 
   return pst;
@@ -7450,6 +7911,40 @@ dwarf2_read_symtab (struct partial_symtab *self,
 
   process_cu_includes ();
 }
+
+/* Prepare the reading in of the first of the COUNT psymtabs PSTS, by
+   reading the DIEs of their compilation units in parallel.  Return
+   how many psymtabs were prepared.  */
+
+static int
+dwarf2_prepare_read_symtabs (struct partial_symtab **psts, int count,
+			     struct objfile *objfile)
+{
+  struct dwarf2_per_cu_data **per_cus;
+  struct cleanup *cleanup;
+  int i, n = 0;
+
+  count = min (count, dwarf2_preload_batch_size ());
+  if (count < 2)
+    return 1;
+
+  /* Restore our global data.  */
+  dwarf2_per_objfile
+    = (struct dwarf2_per_objfile *) objfile_data (objfile,
+						  dwarf2_objfile_data_key);
+
+  per_cus = XNEWVEC (struct dwarf2_per_cu_data *, count);
+  cleanup = make_cleanup (xfree, per_cus);
+  for (i = 0; i < count; ++i)
+    if (psts[i]->read_symtab_private != NULL)
+      per_cus[n++] = (struct dwarf2_per_cu_data *) psts[i]->read_symtab_private;
+
+  /* Units preloaded earlier but not read in are not needed anymore.  */
+  dwarf2_free_preloaded_comp_units (NULL);
+  dwarf2_preload_comp_units (per_cus, n);
+  do_cleanups (cleanup);
+  return count;
+}
 
 /* Reading in full CUs.  */
 
@@ -18683,8 +19178,12 @@ new_symbol_full (struct die_info *die, struct type *type, struct dwarf2_cu *cu,
 
       if (suppress_add)
 	{
-	  sym->hash_next = objfile->template_symbols;
-	  objfile->template_symbols = sym;
+	  struct template_symbol_list *node
+	    = XOBNEW (&objfile->objfile_obstack, struct template_symbol_list);
+
+	  node->symbol = sym;
+	  node->next = objfile->template_symbols;
+	  objfile->template_symbols = node;
 	  list_to_add = NULL;
 	}
 
@@ -22259,6 +22758,11 @@ dwarf2_free_objfile (struct objfile *objfile)
 
   /* Cached DIE trees use xmalloc and the comp_unit_obstack.  */
   free_cached_comp_units (NULL);
+  if (dwarf2_per_objfile->preloaded_cus != NULL)
+    {
+      dwarf2_free_preloaded_comp_units (NULL);
+      htab_delete (dwarf2_per_objfile->preloaded_cus);
+    }
 
   if (dwarf2_per_objfile->quick_file_names_table)
     htab_delete (dwarf2_per_objfile->quick_file_names_table);
@@ -22591,6 +23095,9 @@ dwarf2_per_objfile_free (struct objfile *objfile, void *d)
 
   if (data->dwz_file && data->dwz_file->dwz_bfd)
     gdb_bfd_unref (data->dwz_file->dwz_bfd);
+
+  if (data->index_table != NULL)
+    trigram_index_free (data->index_table->trigrams);
 }
 
 
@@ -23145,10 +23652,11 @@ symbol_kind (struct partial_symbol *psym)
     }
 }
 
-/* Add a list of partial symbols to SYMTAB.  */
+/* Add a list of partial symbols of OBJFILE to SYMTAB.  */
 
 static void
-write_psymbols (struct mapped_symtab *symtab,
+write_psymbols (struct objfile *objfile,
+		struct mapped_symtab *symtab,
 		htab_t psyms_seen,
 		struct partial_symbol **psymp,
 		int count,
@@ -23160,7 +23668,7 @@ write_psymbols (struct mapped_symtab *symtab,
       struct partial_symbol *psym = *psymp;
       void **slot;
 
-      if (SYMBOL_LANGUAGE (psym) == language_ada)
+      if (PSYMBOL_LANGUAGE (psym) == language_ada)
 	error (_("Ada is not currently supported by the index"));
 
       /* Only add a given psymbol once.  */
@@ -23170,7 +23678,7 @@ write_psymbols (struct mapped_symtab *symtab,
 	  gdb_index_symbol_kind kind = symbol_kind (psym);
 
 	  *slot = psym;
-	  add_index_entry (symtab, SYMBOL_SEARCH_NAME (psym),
+	  add_index_entry (symtab, psymbol_search_name (objfile, psym),
 			   is_static, kind, cu_index);
 	}
     }
@@ -23220,13 +23728,15 @@ write_one_signatured_type (void **slot, void *d)
   struct partial_symtab *psymtab = entry->per_cu.v.psymtab;
   gdb_byte val[8];
 
-  write_psymbols (info->symtab,
+  write_psymbols (info->objfile,
+		  info->symtab,
 		  info->psyms_seen,
 		  info->objfile->global_psymbols.list
 		  + psymtab->globals_offset,
 		  psymtab->n_global_syms, info->cu_index,
 		  0);
-  write_psymbols (info->symtab,
+  write_psymbols (info->objfile,
+		  info->symtab,
 		  info->psyms_seen,
 		  info->objfile->static_psymbols.list
 		  + psymtab->statics_offset,
@@ -23264,12 +23774,14 @@ recursively_write_psymbols (struct objfile *objfile,
       recursively_write_psymbols (objfile, psymtab->dependencies[i],
 				  symtab, psyms_seen, cu_index);
 
-  write_psymbols (symtab,
+  write_psymbols (objfile,
+		  symtab,
 		  psyms_seen,
 		  objfile->global_psymbols.list + psymtab->globals_offset,
 		  psymtab->n_global_syms, cu_index,
 		  0);
-  write_psymbols (symtab,
+  write_psymbols (objfile,
+		  symtab,
 		  psyms_seen,
 		  objfile->static_psymbols.list + psymtab->statics_offset,
 		  psymtab->n_static_syms, cu_index,
@@ -23507,6 +24019,20 @@ save_gdb_index_command (char *arg, int from_tty)
 
 int dwarf_always_disassemble;
 
+/* If nonzero, simple location expressions are evaluated without the
+   DWARF expression interpreter; see dwarf2loc.c.  */
+int dwarf_compiled_locations = 1;
+
+static void
+show_dwarf_compiled_locations (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("Whether to evaluate simple DWARF location "
+		      "expressions without the interpreter is %s.\n"),
+		    value);
+}
+
 static void
 show_dwarf_always_disassemble (struct ui_file *file, int from_tty,
 			       struct cmd_list_element *c, const char *value)
@@ -23572,6 +24098,19 @@ conversational style, when possible."),
 			   &set_dwarf_cmdlist,
 			   &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("compiled-locations", class_obscure,
+			   &dwarf_compiled_locations, _("\
+Set whether simple DWARF location expressions bypass the interpreter."), _("\
+Show whether simple DWARF location expressions bypass the interpreter."), _("\
+When enabled, location expressions made of a single register, register\n\
+offset, frame base offset or address operation are evaluated directly.\n\
+When disabled, every location expression goes through the DWARF\n\
+expression interpreter.  The results must be the same."),
+			   NULL,
+			   show_dwarf_compiled_locations,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
   add_setshow_zuinteger_cmd ("dwarf-read", no_class, &dwarf_read_debug, _("\
 Set debugging of the DWARF reader."), _("\
 Show debugging of the DWARF reader."), _("\
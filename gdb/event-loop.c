@@ -30,10 +30,20 @@
 #endif
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+#ifdef HAVE_SYS_TIMERFD_H
+#include <sys/timerfd.h>
+#endif
+
 #include <sys/types.h>
 #include "gdb_sys_time.h"
 #include "gdb_select.h"
 #include "observer.h"
+#include "gdbcmd.h"
+#include "filestuff.h"
+#include <fcntl.h>
 
 /* Tell create_file_handler what events we are interested in.
    This is used by the select version of the event loop.  */
@@ -87,6 +97,7 @@ typedef struct file_handler
     handler_func *proc;		/* Procedure to call when fd is ready.  */
     gdb_client_data client_data;	/* Argument to pass to proc.  */
     int error;			/* Was an error detected on this fd?  */
+    unsigned int epoll_tag;	/* Tag of the current epoll registration.  */
     struct file_handler *next_file;	/* Next registered file descriptor.  */
   }
 file_handler;
@@ -137,11 +148,19 @@ async_event_handler;
 
 /* Gdb_notifier is just a list of file descriptors gdb is interested in.
    These are the input file descriptor, and the target file
-   descriptor.  We have two flavors of the notifier, one for platforms
-   that have the POLL function, the other for those that don't, and
-   only support SELECT.  Each of the elements in the gdb_notifier list is
-   basically a description of what kind of events gdb is interested
-   in, for each fd.  */
+   descriptor.  We have three flavors of the notifier: one for
+   platforms that have EPOLL, one for those that have the POLL
+   function, and one for those that only support SELECT.  Each of the
+   elements in the gdb_notifier list is basically a description of
+   what kind of events gdb is interested in, for each fd.
+
+   The epoll flavor is a variant of the poll one: the masks are the
+   same POLLIN etc., but the kernel keeps the set of descriptors, so
+   waiting for an event costs the same however many descriptors are
+   monitored.  Timers are then delivered through a timerfd, if
+   available.  Not all files can be monitored with epoll (e.g.,
+   regular files can't); if one such is registered, the notifier falls
+   back to poll for good.  */
 
 /* As of 1999-04-30 only the input file descriptor is registered with the
    event loop.  */
@@ -155,6 +174,21 @@ async_event_handler;
 
 static unsigned char use_poll = USE_POLL;
 
+/* Do we use epoll?  This is only ever set along with USE_POLL.  It is
+   cleared if epoll turns out not to be usable.  */
+#if defined (HAVE_POLL) && defined (HAVE_SYS_EPOLL_H)
+#define USE_EPOLL 1
+#else
+#define USE_EPOLL 0
+#endif
+
+static unsigned char use_epoll = USE_EPOLL;
+
+/* If not NULL, the only file handler whose events are handled; the
+   events of the others are left pending.  Used by "maint
+   check-file-handler-reuse".  */
+static file_handler *only_file_handler;
+
 #ifdef USE_WIN32API
 #include <windows.h>
 #include <io.h>
@@ -187,6 +221,30 @@ static struct
     int poll_timeout;
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+    /* The epoll instance, valid if EPOLL_CREATED.  */
+    int epoll_fd;
+    int epoll_created;
+
+    /* The timerfd armed for the first timer in TIMER_LIST, valid if
+       TIMER_FD_CREATED.  Without it, timers are polled like with
+       poll.  */
+    int timer_fd;
+    int timer_fd_created;
+
+    /* The file handlers, indexed by file descriptor, so that the
+       handler of a ready descriptor is found without walking the
+       list.  */
+    file_handler **epoll_handlers;
+    int num_epoll_handlers;
+
+    /* The tag of the last epoll registration.  Each registration
+       passes its tag to epoll along with the descriptor, so that
+       events from a stale registration can be told apart; the timerfd
+       uses tag 0.  */
+    unsigned int epoll_last_tag;
+#endif
+
     /* Masks to be used in the next call to select.
        Bits are set in response to calls to create_file_handler.  */
     fd_set check_masks[3];
@@ -260,6 +318,7 @@ static int check_async_event_handlers (void);
 static int gdb_wait_for_event (int);
 static int update_wait_timeout (void);
 static int poll_timers (void);
+static int run_expired_timer (void);
 
 
 /* Process one high level event.  If nothing is ready at this time,
@@ -381,6 +440,311 @@ start_event_loop (void)
 }
 
 
+#ifdef HAVE_SYS_EPOLL_H
+
+/* Return the epoll events corresponding to the poll events MASK.  */
+
+static uint32_t
+poll_to_epoll_events (int mask)
+{
+  uint32_t events = 0;
+
+  if (mask & POLLIN)
+    events |= EPOLLIN;
+  if (mask & POLLPRI)
+    events |= EPOLLPRI;
+  if (mask & POLLOUT)
+    events |= EPOLLOUT;
+  return events;
+}
+
+/* Return the poll events corresponding to the epoll events
+   EVENTS.  */
+
+static int
+epoll_to_poll_events (uint32_t events)
+{
+  int mask = 0;
+
+  if (events & EPOLLIN)
+    mask |= POLLIN;
+  if (events & EPOLLPRI)
+    mask |= POLLPRI;
+  if (events & EPOLLOUT)
+    mask |= POLLOUT;
+  if (events & EPOLLERR)
+    mask |= POLLERR;
+  if (events & EPOLLHUP)
+    mask |= POLLHUP;
+  return mask;
+}
+
+/* Return the epoll data for descriptor FD, registered with TAG.  */
+
+static uint64_t
+epoll_data (int fd, unsigned int tag)
+{
+  return ((uint64_t) tag << 32) | (uint32_t) fd;
+}
+
+#endif /* HAVE_SYS_EPOLL_H */
+
+/* Return true if timers are delivered through the timerfd.  */
+
+static int
+timer_fd_in_use (void)
+{
+#if defined (HAVE_SYS_EPOLL_H) && defined (HAVE_SYS_TIMERFD_H)
+  return use_epoll && gdb_notifier.timer_fd_created;
+#else
+  return 0;
+#endif
+}
+
+/* Arm the timerfd for the first timer in TIMER_LIST, or disarm it if
+   there is none.  */
+
+static void
+update_timer_fd (void)
+{
+#if defined (HAVE_SYS_EPOLL_H) && defined (HAVE_SYS_TIMERFD_H)
+  struct itimerspec spec;
+
+  if (!timer_fd_in_use ())
+    return;
+
+  memset (&spec, 0, sizeof (spec));
+  if (timer_list.first_timer != NULL)
+    {
+      spec.it_value.tv_sec = timer_list.first_timer->when.tv_sec;
+      spec.it_value.tv_nsec = timer_list.first_timer->when.tv_usec * 1000;
+
+      /* An all-zero value would disarm the timerfd.  */
+      if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+	spec.it_value.tv_nsec = 1;
+    }
+
+  if (timerfd_settime (gdb_notifier.timer_fd, TFD_TIMER_ABSTIME,
+		       &spec, NULL) != 0)
+    perror_with_name (("timerfd_settime"));
+#endif
+}
+
+#if defined (HAVE_SYS_EPOLL_H) && defined (HAVE_SYS_TIMERFD_H)
+
+/* Start monitoring the timerfd with epoll.  Return false if that
+   fails.  */
+
+static int
+epoll_add_timer_fd (void)
+{
+  struct epoll_event event;
+
+  memset (&event, 0, sizeof (event));
+  event.events = EPOLLIN;
+  event.data.u64 = epoll_data (gdb_notifier.timer_fd, 0);
+  return epoll_ctl (gdb_notifier.epoll_fd, EPOLL_CTL_ADD,
+		    gdb_notifier.timer_fd, &event) == 0;
+}
+
+#endif
+
+/* Create the epoll instance, and the timerfd if possible.  Clear
+   USE_EPOLL if epoll is not usable.  */
+
+static void
+create_epoll_notifier (void)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  gdb_notifier.epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+  if (gdb_notifier.epoll_fd < 0)
+    {
+      use_epoll = 0;
+      return;
+    }
+  gdb_notifier.epoll_created = 1;
+
+#ifdef HAVE_SYS_TIMERFD_H
+  gdb_notifier.timer_fd = timerfd_create (CLOCK_REALTIME,
+					  TFD_NONBLOCK | TFD_CLOEXEC);
+  if (gdb_notifier.timer_fd >= 0)
+    {
+      if (epoll_add_timer_fd ())
+	{
+	  gdb_notifier.timer_fd_created = 1;
+	  update_timer_fd ();
+	}
+      else
+	close (gdb_notifier.timer_fd);
+    }
+#endif /* HAVE_SYS_TIMERFD_H */
+#else
+  internal_error (__FILE__, __LINE__,
+		  _("use_epoll without HAVE_SYS_EPOLL_H"));
+#endif /* HAVE_SYS_EPOLL_H */
+}
+
+/* Start monitoring FILE_PTR's descriptor for the poll events MASK
+   with epoll, or update its registration if the descriptor is
+   already monitored.  Return false if epoll can't monitor it.  */
+
+static int
+epoll_add_file_handler (file_handler *file_ptr, int mask)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  struct epoll_event event;
+  int fd = file_ptr->fd;
+
+  /* Tag 0 is the timerfd's.  */
+  if (++gdb_notifier.epoll_last_tag == 0)
+    ++gdb_notifier.epoll_last_tag;
+  file_ptr->epoll_tag = gdb_notifier.epoll_last_tag;
+
+  memset (&event, 0, sizeof (event));
+  event.events = poll_to_epoll_events (mask);
+  event.data.u64 = epoll_data (fd, file_ptr->epoll_tag);
+  if (epoll_ctl (gdb_notifier.epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0
+      && (errno != EEXIST
+	  || epoll_ctl (gdb_notifier.epoll_fd, EPOLL_CTL_MOD,
+			fd, &event) != 0))
+    return 0;
+
+  if (fd >= gdb_notifier.num_epoll_handlers)
+    {
+      int old_num = gdb_notifier.num_epoll_handlers;
+      int new_num = max (fd + 1, 2 * old_num);
+
+      gdb_notifier.epoll_handlers
+	= XRESIZEVEC (file_handler *, gdb_notifier.epoll_handlers, new_num);
+      memset (gdb_notifier.epoll_handlers + old_num, 0,
+	      (new_num - old_num) * sizeof (file_handler *));
+      gdb_notifier.num_epoll_handlers = new_num;
+    }
+  gdb_notifier.epoll_handlers[fd] = file_ptr;
+  return 1;
+#else
+  internal_error (__FILE__, __LINE__,
+		  _("use_epoll without HAVE_SYS_EPOLL_H"));
+#endif /* HAVE_SYS_EPOLL_H */
+}
+
+/* Stop monitoring FD with epoll.  */
+
+static void
+epoll_delete_file_handler (int fd)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  /* This fails if FD was already closed, which removed it.  */
+  epoll_ctl (gdb_notifier.epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+  if (fd < gdb_notifier.num_epoll_handlers)
+    gdb_notifier.epoll_handlers[fd] = NULL;
+#else
+  internal_error (__FILE__, __LINE__,
+		  _("use_epoll without HAVE_SYS_EPOLL_H"));
+#endif /* HAVE_SYS_EPOLL_H */
+}
+
+/* Add FD to the array of pollfd structures, monitoring the poll
+   events MASK.  */
+
+static void
+add_poll_fd (int fd, int mask)
+{
+#ifdef HAVE_POLL
+  gdb_notifier.num_fds++;
+  if (gdb_notifier.poll_fds)
+    gdb_notifier.poll_fds =
+      (struct pollfd *) xrealloc (gdb_notifier.poll_fds,
+				  (gdb_notifier.num_fds
+				   * sizeof (struct pollfd)));
+  else
+    gdb_notifier.poll_fds =
+      XNEW (struct pollfd);
+  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->fd = fd;
+  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->events = mask;
+  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->revents = 0;
+#else
+  internal_error (__FILE__, __LINE__,
+		  _("use_poll without HAVE_POLL"));
+#endif /* HAVE_POLL */
+}
+
+/* Stop using epoll, after a file descriptor that it can't monitor
+   was registered, and monitor the file handlers other than SKIP with
+   poll instead.  */
+
+static void
+fall_back_from_epoll (file_handler *skip)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  file_handler *file_ptr;
+
+  close (gdb_notifier.epoll_fd);
+  gdb_notifier.epoll_created = 0;
+  if (gdb_notifier.timer_fd_created)
+    {
+      close (gdb_notifier.timer_fd);
+      gdb_notifier.timer_fd_created = 0;
+    }
+  xfree (gdb_notifier.epoll_handlers);
+  gdb_notifier.epoll_handlers = NULL;
+  gdb_notifier.num_epoll_handlers = 0;
+  use_epoll = 0;
+
+  gdb_notifier.num_fds = 0;
+  for (file_ptr = gdb_notifier.first_file_handler; file_ptr != NULL;
+       file_ptr = file_ptr->next_file)
+    if (file_ptr != skip)
+      add_poll_fd (file_ptr->fd, file_ptr->mask);
+#else
+  internal_error (__FILE__, __LINE__,
+		  _("use_epoll without HAVE_SYS_EPOLL_H"));
+#endif /* HAVE_SYS_EPOLL_H */
+}
+
+/* Replace the epoll instance with a new one monitoring the current
+   file handlers.  epoll tracks open files, not descriptor numbers: a
+   descriptor closed without delete_file_handler stays registered for
+   as long as its file is open through another descriptor, and there
+   is no other way to remove that registration.  */
+
+static void
+rebuild_epoll_notifier (void)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  file_handler *file_ptr;
+  int epoll_fd;
+
+  epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+  if (epoll_fd < 0)
+    {
+      fall_back_from_epoll (NULL);
+      return;
+    }
+  close (gdb_notifier.epoll_fd);
+  gdb_notifier.epoll_fd = epoll_fd;
+
+#ifdef HAVE_SYS_TIMERFD_H
+  if (gdb_notifier.timer_fd_created && !epoll_add_timer_fd ())
+    {
+      close (gdb_notifier.timer_fd);
+      gdb_notifier.timer_fd_created = 0;
+    }
+#endif
+
+  for (file_ptr = gdb_notifier.first_file_handler; file_ptr != NULL;
+       file_ptr = file_ptr->next_file)
+    if (!epoll_add_file_handler (file_ptr, file_ptr->mask))
+      {
+	fall_back_from_epoll (NULL);
+	return;
+      }
+#else
+  internal_error (__FILE__, __LINE__,
+		  _("use_epoll without HAVE_SYS_EPOLL_H"));
+#endif /* HAVE_SYS_EPOLL_H */
+}
+
 /* Wrapper function for create_file_handler, so that the caller
    doesn't have to know implementation details about the use of poll
    vs. select.  */
@@ -402,12 +766,17 @@ add_file_handler (int fd, handler_func * proc, gdb_client_data client_data)
       fds.fd = fd;
       fds.events = POLLIN;
       if (poll (&fds, 1, 0) == 1 && (fds.revents & POLLNVAL))
-	use_poll = 0;
+	{
+	  use_poll = 0;
+	  use_epoll = 0;
+	}
 #else
       internal_error (__FILE__, __LINE__,
 		      _("use_poll without HAVE_POLL"));
 #endif /* HAVE_POLL */
     }
+  if (use_epoll && !gdb_notifier.epoll_created)
+    create_epoll_notifier ();
   if (use_poll)
     {
 #ifdef HAVE_POLL
@@ -461,26 +830,13 @@ create_file_handler (int fd, int mask, handler_func * proc,
       file_ptr->next_file = gdb_notifier.first_file_handler;
       gdb_notifier.first_file_handler = file_ptr;
 
-      if (use_poll)
-	{
-#ifdef HAVE_POLL
-	  gdb_notifier.num_fds++;
-	  if (gdb_notifier.poll_fds)
-	    gdb_notifier.poll_fds =
-	      (struct pollfd *) xrealloc (gdb_notifier.poll_fds,
-					  (gdb_notifier.num_fds
-					   * sizeof (struct pollfd)));
-	  else
-	    gdb_notifier.poll_fds =
-	      XNEW (struct pollfd);
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->fd = fd;
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->events = mask;
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->revents = 0;
-#else
-	  internal_error (__FILE__, __LINE__,
-			  _("use_poll without HAVE_POLL"));
-#endif /* HAVE_POLL */
-	}
+      if (use_epoll && !epoll_add_file_handler (file_ptr, mask))
+	fall_back_from_epoll (file_ptr);
+
+      if (use_epoll)
+	gdb_notifier.num_fds++;
+      else if (use_poll)
+	add_poll_fd (fd, mask);
       else
 	{
 	  if (mask & GDB_READABLE)
@@ -502,6 +858,15 @@ create_file_handler (int fd, int mask, handler_func * proc,
 	    gdb_notifier.num_fds = fd + 1;
 	}
     }
+  else if (use_epoll)
+    {
+      /* FD may have been closed and reused for another file since it
+	 was registered.  Register it again; this just updates the
+	 registration if FD still refers to the same file.  */
+      file_ptr->mask = mask;
+      if (!epoll_add_file_handler (file_ptr, mask))
+	fall_back_from_epoll (NULL);
+    }
 
   file_ptr->proc = proc;
   file_ptr->client_data = client_data;
@@ -557,7 +922,12 @@ delete_file_handler (int fd)
   if (file_ptr == NULL)
     return;
 
-  if (use_poll)
+  if (use_epoll)
+    {
+      epoll_delete_file_handler (fd);
+      gdb_notifier.num_fds--;
+    }
+  else if (use_poll)
     {
 #ifdef HAVE_POLL
       /* Create a new poll_fds array by copying every fd's information
@@ -651,6 +1021,7 @@ handle_file_event (file_handler *file_ptr, int ready_mask)
   int error_mask;
 #endif
 
+  if (only_file_handler == NULL || file_ptr == only_file_handler)
     {
 	{
 	  /* With poll, the ready_mask could have any of three events
@@ -710,6 +1081,81 @@ handle_file_event (file_handler *file_ptr, int ready_mask)
     }
 }
 
+/* Wait for new events with epoll, like gdb_wait_for_event.  */
+
+static int
+epoll_wait_for_event (int block)
+{
+#ifdef HAVE_SYS_EPOLL_H
+  struct epoll_event event;
+  file_handler *file_ptr;
+  unsigned int tag;
+  int num_found;
+  int timeout;
+  int fd;
+
+  if (!block)
+    timeout = 0;
+  else if (timer_fd_in_use ())
+    timeout = -1;
+  else
+    timeout = gdb_notifier.timeout_valid ? gdb_notifier.poll_timeout : -1;
+
+  /* Take a single event.  With level-triggered notification, the
+     kernel moves a descriptor that is returned to the end of its
+     ready list, which serves ready descriptors round-robin, like the
+     poll variant does.  */
+  num_found = epoll_wait (gdb_notifier.epoll_fd, &event, 1, timeout);
+
+  /* Don't print anything if we get out of epoll_wait because of a
+     signal.  */
+  if (num_found == -1 && errno != EINTR)
+    perror_with_name (("epoll_wait"));
+
+  if (num_found <= 0)
+    return 0;
+
+  fd = (int) (uint32_t) event.data.u64;
+  tag = event.data.u64 >> 32;
+
+  if (timer_fd_in_use () && tag == 0 && fd == gdb_notifier.timer_fd)
+    {
+      uint64_t expirations;
+      int res;
+
+      /* Consume the expiration, so that the timerfd isn't ready
+	 until it is armed again.  */
+      if (read (gdb_notifier.timer_fd, &expirations,
+		sizeof (expirations)) < 0
+	  && errno != EAGAIN && errno != EINTR)
+	perror_with_name (("read"));
+
+      res = run_expired_timer ();
+      if (!res)
+	update_timer_fd ();
+      return res;
+    }
+
+  file_ptr = NULL;
+  if (fd < gdb_notifier.num_epoll_handlers)
+    file_ptr = gdb_notifier.epoll_handlers[fd];
+  if (file_ptr == NULL || file_ptr->epoll_tag != tag)
+    {
+      /* The event comes from a registration for a file FD no longer
+	 refers to.  Being level-triggered, it would keep coming
+	 back.  */
+      rebuild_epoll_notifier ();
+      return 0;
+    }
+
+  handle_file_event (file_ptr, epoll_to_poll_events (event.events));
+  return 1;
+#else
+  internal_error (__FILE__, __LINE__,
+		  _("use_epoll without HAVE_SYS_EPOLL_H"));
+#endif /* HAVE_SYS_EPOLL_H */
+}
+
 /* Wait for new events on the monitored file descriptors.  Run the
    event handler if the first descriptor that is detected by the poll.
    If BLOCK and if there are no events, this function will block in
@@ -733,6 +1179,9 @@ gdb_wait_for_event (int block)
   if (block)
     update_wait_timeout ();
 
+  if (use_epoll)
+    return epoll_wait_for_event (block);
+
   if (use_poll)
     {
 #ifdef HAVE_POLL
@@ -1136,6 +1585,8 @@ create_timer (int milliseconds, timer_handler_func * proc,
     }
 
   gdb_notifier.timeout_valid = 0;
+  if (timer_ptr == timer_list.first_timer)
+    update_timer_fd ();
   return timer_ptr->timer_id;
 }
 
@@ -1159,7 +1610,10 @@ delete_timer (int id)
     return;
   /* Get rid of the timer in the timer list.  */
   if (timer_ptr == timer_list.first_timer)
-    timer_list.first_timer = timer_ptr->next;
+    {
+      timer_list.first_timer = timer_ptr->next;
+      update_timer_fd ();
+    }
   else
     {
       for (prev_timer = timer_list.first_timer;
@@ -1237,6 +1691,20 @@ update_wait_timeout (void)
 
 static int
 poll_timers (void)
+{
+  /* With a timerfd, expired timers are reported by epoll_wait like
+     events on file descriptors, without checking the time here.  */
+  if (timer_fd_in_use ())
+    return 0;
+
+  return run_expired_timer ();
+}
+
+/* If the first timer in the timers queue has expired, remove it and
+   call its handler.  Return 1 if a timer was run, otherwise 0.  */
+
+static int
+run_expired_timer (void)
 {
   if (update_wait_timeout ())
     {
@@ -1246,6 +1714,7 @@ poll_timers (void)
 
       /* Get rid of the timer from the beginning of the list.  */
       timer_list.first_timer = timer_ptr->next;
+      update_timer_fd ();
 
       /* Delete the timer before calling the callback, not after, in
 	 case the callback itself decides to try deleting the timer
@@ -1260,3 +1729,130 @@ poll_timers (void)
 
   return 0;
 }
+
+#ifndef USE_WIN32API
+
+/* State of the "maint check-file-handler-reuse" command.  */
+
+struct fd_reuse_check
+{
+  /* The pipes, and a duplicate of the old pipe's read end.  */
+  int old_pipe[2];
+  int new_pipe[2];
+  int old_dup;
+
+  /* The descriptor to read from.  */
+  int fd;
+
+  /* The number of bytes read, and the number of times the handler was
+     called with nothing to read.  */
+  int bytes;
+  int spurious;
+};
+
+/* File handler for the "maint check-file-handler-reuse" command.  */
+
+static void
+fd_reuse_check_handler (int error, gdb_client_data client_data)
+{
+  struct fd_reuse_check *check = (struct fd_reuse_check *) client_data;
+  char c;
+
+  if (read (check->fd, &c, 1) == 1)
+    check->bytes++;
+  else
+    check->spurious++;
+}
+
+/* Cleanup for the "maint check-file-handler-reuse" command.  */
+
+static void
+fd_reuse_check_cleanup (void *arg)
+{
+  struct fd_reuse_check *check = (struct fd_reuse_check *) arg;
+
+  only_file_handler = NULL;
+  delete_file_handler (check->fd);
+  close (check->fd);
+  close (check->old_dup);
+  close (check->old_pipe[1]);
+  close (check->new_pipe[1]);
+}
+
+/* Implement the "maint check-file-handler-reuse" command.  Register a
+   file handler for a pipe, then close its descriptor behind the event
+   loop's back while the pipe stays open through a duplicate, reuse the
+   descriptor number for another pipe and register it again.  Both
+   pipes are then made readable; the handler must be called for the
+   new pipe, and only for it.  */
+
+static void
+maintenance_check_file_handler_reuse (char *args, int from_tty)
+{
+  struct fd_reuse_check check;
+  struct cleanup *cleanup;
+  file_handler *file_ptr;
+  int i;
+
+  memset (&check, 0, sizeof (check));
+  if (gdb_pipe_cloexec (check.old_pipe) != 0)
+    perror_with_name (("pipe"));
+  if (gdb_pipe_cloexec (check.new_pipe) != 0)
+    {
+      close (check.old_pipe[0]);
+      close (check.old_pipe[1]);
+      perror_with_name (("pipe"));
+    }
+
+  check.fd = check.old_pipe[0];
+  add_file_handler (check.fd, fd_reuse_check_handler, &check);
+
+  check.old_dup = dup (check.fd);
+  dup2 (check.new_pipe[0], check.fd);
+  close (check.new_pipe[0]);
+  fcntl (check.fd, F_SETFL, O_NONBLOCK);
+  add_file_handler (check.fd, fd_reuse_check_handler, &check);
+  cleanup = make_cleanup (fd_reuse_check_cleanup, &check);
+
+  if (write (check.old_pipe[1], "x", 1) != 1
+      || write (check.new_pipe[1], "x", 1) != 1)
+    perror_with_name (("write"));
+
+  /* Leave the events of the other file handlers, such as the one for
+     stdin, pending.  */
+  for (file_ptr = gdb_notifier.first_file_handler; file_ptr != NULL;
+       file_ptr = file_ptr->next_file)
+    if (file_ptr->fd == check.fd)
+      only_file_handler = file_ptr;
+
+  /* Give the handler a few chances to be called for nothing, too.  */
+  for (i = 0; i < 100 && check.bytes == 0; i++)
+    gdb_wait_for_event (0);
+  for (i = 0; i < 10; i++)
+    gdb_wait_for_event (0);
+
+  do_cleanups (cleanup);
+
+  if (check.bytes != 1 || check.spurious != 0)
+    error (_("The file handler read %d bytes and was called %d times "
+	     "with nothing to read."), check.bytes, check.spurious);
+  printf_filtered (_("The file handler follows the reused descriptor.\n"));
+}
+
+#endif /* !USE_WIN32API */
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_event_loop;
+
+void
+_initialize_event_loop (void)
+{
+#ifndef USE_WIN32API
+  add_cmd ("check-file-handler-reuse", class_maintenance,
+	   maintenance_check_file_handler_reuse, _("\
+Check that a file handler follows a reused file descriptor.\n\
+A file handler registered again for a descriptor closed and reused for\n\
+another file must get the events of the new file, not of the old one."),
+	   &maintenancelist);
+#endif
+}
@@ -26,10 +26,15 @@
 #include "ui-out.h"
 #include "serial.h"
 #include "gdbthread.h"
+#include "worker-threads.h"
 
 void
 prepare_to_throw_exception (void)
 {
+  /* The quit flag belongs to the main thread.  */
+  if (worker_thread_p ())
+    return;
+
   clear_quit_flag ();
   immediate_quit = 0;
 }
@@ -30,20 +30,31 @@
 #include "gcore.h"
 #include "cli/cli-decode.h"
 #include <fcntl.h>
+#include <ctype.h>
 #include "regcache.h"
 #include "regset.h"
 #include "gdb_bfd.h"
 #include "readline/tilde.h"
+#include "gdb_sys_time.h"
+#include "vec.h"
+#include "worker-threads.h"
+#include <zlib.h>
 
 /* The largest amount of memory to read from the target at once.  We
    must throttle it to limit the amount of memory used by GDB during
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+/* Blocks of memory of this size that are all zero are not written to
+   the core file, leaving a hole that reads back as zeroes.  On file
+   systems that support sparse files, this saves both time and disk
+   space.  */
+#define ZERO_BLOCK_BYTES 4096
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
-static int gcore_memory_sections (bfd *);
+static int gcore_memory_sections (bfd *, int, struct gcore_copy_stats *);
 
 /* create_gcore_bfd -- helper for gcore_command (exported).
    Open a new bfd core file for output, and return the handle.  */
@@ -63,7 +74,7 @@ create_gcore_bfd (const char *filename)
 /* write_gcore_file_1 -- do the actual work of write_gcore_file.  */
 
 static void
-write_gcore_file_1 (bfd *obfd)
+write_gcore_file_1 (bfd *obfd, int compress, struct gcore_copy_stats *stats)
 {
   struct cleanup *cleanup;
   void *note_data = NULL;
@@ -98,7 +109,7 @@ write_gcore_file_1 (bfd *obfd)
   bfd_set_section_size (obfd, note_sec, note_size);
 
   /* Now create the memory/load sections.  */
-  if (gcore_memory_sections (obfd) == 0)
+  if (gcore_memory_sections (obfd, compress, stats) == 0)
     error (_("gcore: failed to get corefile memory sections from target."));
 
   /* Write out the contents of the note section.  */
@@ -109,18 +120,26 @@ write_gcore_file_1 (bfd *obfd)
 }
 
 /* write_gcore_file -- helper for gcore_command (exported).
-   Compose and write the corefile data to the core file.  */
+   Compose and write the corefile data to the core file.  If COMPRESS
+   is non-zero, write the memory contents compressed (see gcore.h).
+   If STATS is not NULL, record statistics about the memory copied in
+   it.  */
 
 void
-write_gcore_file (bfd *obfd)
+write_gcore_file (bfd *obfd, int compress, struct gcore_copy_stats *stats)
 {
   struct gdb_exception except = exception_none;
+  struct gcore_copy_stats local_stats;
+
+  if (stats == NULL)
+    stats = &local_stats;
+  memset (stats, 0, sizeof (*stats));
 
   target_prepare_to_generate_core ();
 
   TRY
     {
-      write_gcore_file_1 (obfd);
+      write_gcore_file_1 (obfd, compress, stats);
     }
   CATCH (e, RETURN_MASK_ALL)
     {
@@ -154,11 +173,22 @@ gcore_command (char *args, int from_tty)
   struct cleanup *bfd_chain;
   char *corefilename;
   bfd *obfd;
+  struct gcore_copy_stats stats;
+  struct timeval start_time, end_time;
+  int compress = 0;
 
   /* No use generating a corefile without a target process.  */
   if (!target_has_execution)
     noprocess ();
 
+  if (args != NULL
+      && startswith (args, "-z")
+      && (args[2] == '\0' || isspace (args[2])))
+    {
+      compress = 1;
+      args = skip_spaces (args + 2);
+    }
+
   if (args && *args)
     corefilename = tilde_expand (args);
   else
@@ -179,13 +209,23 @@ gcore_command (char *args, int from_tty)
   bfd_chain = make_cleanup (do_bfd_delete_cleanup, obfd);
 
   /* Call worker function.  */
-  write_gcore_file (obfd);
+  gettimeofday (&start_time, NULL);
+  write_gcore_file (obfd, compress, &stats);
 
   /* Succeeded.  */
   discard_cleanups (bfd_chain);
   gdb_bfd_unref (obfd);
+  gettimeofday (&end_time, NULL);
 
   fprintf_filtered (gdb_stdout, "Saved corefile %s\n", corefilename);
+  if (info_verbose)
+    {
+      print_transfer_performance (gdb_stdout, stats.data_count,
+				  stats.write_count, &start_time, &end_time);
+      fprintf_filtered (gdb_stdout,
+			"Skipped writing %s bytes of all-zero memory.\n",
+			pulongest (stats.zero_count));
+    }
   do_cleanups (filename_chain);
 }
 
@@ -398,6 +438,8 @@ make_output_phdrs (bfd *obfd, asection *osec, void *ignored)
     p_type = PT_LOAD;
   else if (startswith (bfd_section_name (obfd, osec), "note"))
     p_type = PT_NOTE;
+  else if (strcmp (bfd_section_name (obfd, osec), ZCORE_SECTION_NAME) == 0)
+    p_type = PT_GDB_ZCORE;
   else
     p_type = PT_NULL;
 
@@ -556,9 +598,73 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* Return non-zero if the SIZE bytes at BUF are all zero.  */
+
+static int
+all_zero_p (const gdb_byte *buf, size_t size)
+{
+  return size == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, size - 1) == 0);
+}
+
+/* Write the SIZE bytes of BUF at OFFSET in section OSEC of OBFD,
+   skipping blocks of ZERO_BLOCK_BYTES that are all zero.  The last
+   block of the section is always written, so that the file extends
+   over the whole section.  Updates STATS.  Returns zero on error.  */
+
+static int
+gcore_write_contents (bfd *obfd, asection *osec, const gdb_byte *buf,
+		      file_ptr offset, bfd_size_type size,
+		      struct gcore_copy_stats *stats)
+{
+  bfd_size_type section_size = bfd_section_size (obfd, osec);
+  bfd_size_type pos = 0;
+
+  stats->data_count += size;
+
+  while (pos < size)
+    {
+      bfd_size_type run_start, block;
+
+      /* Skip all-zero blocks.  */
+      while (pos < size)
+	{
+	  block = min (size - pos, ZERO_BLOCK_BYTES);
+	  if (offset + pos + block == section_size
+	      || !all_zero_p (buf + pos, block))
+	    break;
+	  stats->zero_count += block;
+	  pos += block;
+	}
+
+      /* Collect the following blocks that must be written, and write
+	 them at once.  */
+      run_start = pos;
+      while (pos < size)
+	{
+	  block = min (size - pos, ZERO_BLOCK_BYTES);
+	  if (offset + pos + block != section_size
+	      && all_zero_p (buf + pos, block))
+	    break;
+	  pos += block;
+	}
+
+      if (pos > run_start)
+	{
+	  if (!bfd_set_section_contents (obfd, osec, buf + run_start,
+					 offset + run_start,
+					 pos - run_start))
+	    return 0;
+	  stats->write_count++;
+	}
+    }
+
+  return 1;
+}
+
 static void
-gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
+gcore_copy_callback (bfd *obfd, asection *osec, void *data)
 {
+  struct gcore_copy_stats *stats = (struct gcore_copy_stats *) data;
   bfd_size_type size, total_size = bfd_section_size (obfd, osec);
   file_ptr offset = 0;
   struct cleanup *old_chain = NULL;
@@ -590,7 +696,7 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 		   paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk, offset, size))
+      if (!gcore_write_contents (obfd, osec, memhunk, offset, size, stats))
 	{
 	  warning (_("Failed to write corefile contents (%s)."),
 		   bfd_errmsg (bfd_get_error ()));
@@ -604,24 +710,372 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
   do_cleanups (old_chain);	/* Frees MEMHUNK.  */
 }
 
+/* A memory segment of a compressed core file.  */
+
+typedef struct zcore_segment
+{
+  CORE_ADDR vaddr;
+  ULONGEST size;
+  ULONGEST first_block;
+} zcore_segment_s;
+DEF_VEC_O (zcore_segment_s);
+
+/* A block of a compressed core file.  */
+
+typedef struct zcore_block
+{
+  /* Offset of the block's data from the start of the data area.  */
+  ULONGEST offset;
+  unsigned int size;
+  enum zcore_block_kind kind;
+} zcore_block_s;
+DEF_VEC_O (zcore_block_s);
+
+/* State for writing the memory contents of a core file compressed.  */
+
+struct zcore_writer
+{
+  /* The segments and blocks to write.  They are all known before the
+     file is laid out, so that the header and tables of the compressed
+     segment have a known size; the offset, size and kind of each
+     block are only filled in as the block is written.  */
+  VEC (zcore_segment_s) *segments;
+  VEC (zcore_block_s) *blocks;
+
+  /* The file position of the data area, and the size of the data
+     written to it so far.  */
+  file_ptr data_pos;
+  ULONGEST data_size;
+
+  struct gcore_copy_stats *stats;
+};
+
+/* Cleanup function for a struct zcore_writer.  */
+
+static void
+free_zcore_writer (void *arg)
+{
+  struct zcore_writer *writer = (struct zcore_writer *) arg;
+
+  VEC_free (zcore_segment_s, writer->segments);
+  VEC_free (zcore_block_s, writer->blocks);
+}
+
+/* Callback for bfd_map_over_sections.  Add load section OSEC and its
+   blocks to the zcore_writer DATA, and mark OSEC as having no
+   contents in the file.  */
+
+static void
+gcore_zcore_segment_callback (bfd *obfd, asection *osec, void *data)
+{
+  struct zcore_writer *writer = (struct zcore_writer *) data;
+  bfd_size_type total_size = bfd_section_size (obfd, osec);
+  bfd_size_type offset;
+  zcore_segment_s seg;
+  zcore_block_s block;
+
+  if ((bfd_get_section_flags (obfd, osec) & SEC_LOAD) == 0)
+    return;
+  if (!startswith (bfd_section_name (obfd, osec), "load"))
+    return;
+
+  seg.vaddr = bfd_section_vma (obfd, osec);
+  seg.size = total_size;
+  seg.first_block = VEC_length (zcore_block_s, writer->blocks);
+  VEC_safe_push (zcore_segment_s, writer->segments, &seg);
+
+  memset (&block, 0, sizeof (block));
+  block.kind = ZCORE_BLOCK_ZERO;
+  for (offset = 0; offset < total_size; offset += MAX_COPY_BYTES)
+    VEC_safe_push (zcore_block_s, writer->blocks, &block);
+
+  /* The contents go to the compressed segment instead.  */
+  bfd_set_section_flags (obfd, osec,
+			 bfd_get_section_flags (obfd, osec)
+			 & ~(SEC_LOAD | SEC_HAS_CONTENTS));
+}
+
+/* A block of memory of a compressed core file, read by the main
+   thread and compressed by zcore_compress_buffer.  */
+
+struct zcore_buffer
+{
+  /* The memory read, and its length.  */
+  gdb_byte *mem;
+  bfd_size_type len;
+
+  /* The data to write for the block: ZDATA for ZCORE_BLOCK_ZLIB, MEM
+     for ZCORE_BLOCK_STORED, and nothing for ZCORE_BLOCK_ZERO.  */
+  gdb_byte *zdata;
+  uLongf zlen;
+  enum zcore_block_kind kind;
+};
+
+/* Compress the memory of the struct zcore_buffer at index I of the
+   array DATA.  This only computes, so that blocks can be compressed
+   by worker threads.  */
+
+static void
+zcore_compress_buffer (int i, void *data)
+{
+  struct zcore_buffer *buffer = (struct zcore_buffer *) data + i;
+  uLongf zlen = buffer->zlen;
+
+  if (all_zero_p (buffer->mem, buffer->len))
+    buffer->kind = ZCORE_BLOCK_ZERO;
+  else if (compress2 (buffer->zdata, &zlen, buffer->mem, buffer->len,
+		      Z_BEST_SPEED) == Z_OK
+	   && zlen < buffer->len)
+    {
+      buffer->kind = ZCORE_BLOCK_ZLIB;
+      buffer->zlen = zlen;
+    }
+  else
+    buffer->kind = ZCORE_BLOCK_STORED;
+}
+
+/* Read the memory of segment SEG, compress it block by block, and
+   append the blocks to the data area of the compressed segment being
+   written to OBFD.  Reading the target and writing the file are done
+   by the calling thread, but each batch of blocks read is compressed
+   by the worker threads, one block per thread.  */
+
+static void
+gcore_compress_segment (bfd *obfd, struct zcore_writer *writer,
+			const zcore_segment_s *seg)
+{
+  bfd_size_type size = min (seg->size, MAX_COPY_BYTES);
+  ULONGEST nblocks = (seg->size + MAX_COPY_BYTES - 1) / MAX_COPY_BYTES;
+  ULONGEST first;
+  struct cleanup *old_chain;
+  struct zcore_buffer *buffers;
+  zcore_block_s *block, *end;
+  int nbuffers = worker_thread_count ();
+  int readable = 1;
+  int i;
+
+  if ((ULONGEST) nbuffers > nblocks)
+    nbuffers = nblocks;
+
+  buffers = XCNEWVEC (struct zcore_buffer, nbuffers);
+  old_chain = make_cleanup (xfree, buffers);
+  for (i = 0; i < nbuffers; i++)
+    {
+      buffers[i].mem = (gdb_byte *) xmalloc (size);
+      make_cleanup (xfree, buffers[i].mem);
+      buffers[i].zdata = (gdb_byte *) xmalloc (compressBound (size));
+      make_cleanup (xfree, buffers[i].zdata);
+    }
+
+  block = VEC_address (zcore_block_s, writer->blocks) + seg->first_block;
+  end = block + nblocks;
+  for (first = 0; readable && first < nblocks; first += nbuffers)
+    {
+      int n;
+
+      for (n = 0; n < nbuffers && first + n < nblocks; n++)
+	{
+	  bfd_size_type offset = (first + n) * MAX_COPY_BYTES;
+
+	  buffers[n].len = min (size, seg->size - offset);
+	  if (target_read_memory (seg->vaddr + offset, buffers[n].mem,
+				  buffers[n].len) != 0)
+	    {
+	      /* Like gcore_copy_callback, give up on the rest of the
+		 segment after a failed read; it reads back as
+		 zeroes.  */
+	      warning (_("Memory read failed for corefile "
+			 "section, %s bytes at %s."),
+		       plongest (buffers[n].len),
+		       paddress (target_gdbarch (), seg->vaddr));
+	      readable = 0;
+	      break;
+	    }
+	  buffers[n].zlen = compressBound (size);
+	}
+
+      parallel_for_each (n, zcore_compress_buffer, buffers);
+
+      for (i = 0; i < n; i++, block++)
+	{
+	  const gdb_byte *out;
+
+	  block->offset = writer->data_size;
+	  block->kind = buffers[i].kind;
+	  writer->stats->data_count += buffers[i].len;
+
+	  if (buffers[i].kind == ZCORE_BLOCK_ZERO)
+	    {
+	      writer->stats->zero_count += buffers[i].len;
+	      continue;
+	    }
+	  else if (buffers[i].kind == ZCORE_BLOCK_ZLIB)
+	    out = buffers[i].zdata;
+	  else
+	    {
+	      out = buffers[i].mem;
+	      buffers[i].zlen = buffers[i].len;
+	    }
+
+	  if (bfd_seek (obfd, writer->data_pos + writer->data_size,
+			SEEK_SET) != 0
+	      || bfd_bwrite (out, buffers[i].zlen, obfd) != buffers[i].zlen)
+	    error (_("Failed to write compressed corefile contents (%s)."),
+		   bfd_errmsg (bfd_get_error ()));
+	  block->size = buffers[i].zlen;
+	  writer->data_size += buffers[i].zlen;
+	  writer->stats->write_count++;
+	}
+    }
+
+  /* The blocks after a failed read are left as zeroes.  */
+  for (; block < end; block++)
+    block->offset = writer->data_size;
+
+  do_cleanups (old_chain);
+}
+
+/* Return the size of the header and tables of the compressed segment
+   described by WRITER.  */
+
+static ULONGEST
+zcore_tables_size (struct zcore_writer *writer)
+{
+  return (ZCORE_HEADER_SIZE
+	  + (VEC_length (zcore_segment_s, writer->segments)
+	     * ZCORE_SEGMENT_ENTRY_SIZE)
+	  + (VEC_length (zcore_block_s, writer->blocks)
+	     * ZCORE_BLOCK_ENTRY_SIZE));
+}
+
+/* Write the compressed segment described by WRITER into section ZSEC
+   of OBFD.  The space for the header and tables is reserved first,
+   the blocks are written straight into the file after it, and the
+   header and tables are filled in last.  */
+
+static void
+gcore_write_zcore_section (bfd *obfd, asection *zsec,
+			   struct zcore_writer *writer)
+{
+  ULONGEST tables_size = zcore_tables_size (writer);
+  ULONGEST data_offset = tables_size;
+  struct cleanup *old_chain;
+  gdb_byte *buf, *p;
+  zcore_segment_s *seg;
+  zcore_block_s *block;
+  int ix;
+
+  buf = (gdb_byte *) xzalloc (tables_size);
+  old_chain = make_cleanup (xfree, buf);
+
+  /* This lays out the file.  */
+  if (!bfd_set_section_contents (obfd, zsec, buf, 0, tables_size))
+    error (_("Failed to write corefile contents (%s)."),
+	   bfd_errmsg (bfd_get_error ()));
+  /* The blocks are written past the laid-out end of ZSEC, which must
+     therefore be the last section in the file.  Setting its size
+     checks that.  */
+  if (!bfd_elf_set_last_section_size (obfd, zsec, tables_size))
+    error (_("Failed to place the compressed segment "
+	     "at the end of the corefile."));
+
+  writer->data_pos = zsec->filepos + data_offset;
+  for (ix = 0; VEC_iterate (zcore_segment_s, writer->segments, ix, seg); ++ix)
+    gcore_compress_segment (obfd, writer, seg);
+
+  p = buf;
+  memcpy (p, ZCORE_MAGIC, ZCORE_MAGIC_LEN);
+  bfd_putl32 (ZCORE_VERSION, p + 8);
+  bfd_putl32 (MAX_COPY_BYTES, p + 12);
+  bfd_putl64 (VEC_length (zcore_segment_s, writer->segments), p + 16);
+  bfd_putl64 (VEC_length (zcore_block_s, writer->blocks), p + 24);
+  p += ZCORE_HEADER_SIZE;
+
+  for (ix = 0; VEC_iterate (zcore_segment_s, writer->segments, ix, seg); ++ix)
+    {
+      bfd_putl64 (seg->vaddr, p);
+      bfd_putl64 (seg->size, p + 8);
+      bfd_putl64 (seg->first_block, p + 16);
+      p += ZCORE_SEGMENT_ENTRY_SIZE;
+    }
+
+  for (ix = 0; VEC_iterate (zcore_block_s, writer->blocks, ix, block); ++ix)
+    {
+      bfd_putl64 (data_offset + block->offset, p);
+      bfd_putl32 (block->size, p + 8);
+      bfd_putl32 (block->kind, p + 12);
+      p += ZCORE_BLOCK_ENTRY_SIZE;
+    }
+
+  if (!bfd_set_section_contents (obfd, zsec, buf, 0, tables_size))
+    error (_("Failed to write corefile contents (%s)."),
+	   bfd_errmsg (bfd_get_error ()));
+
+  /* BFD needs the sizes of all sections when it lays out the file,
+     before the compressed size is known; but ZSEC is the last section
+     in the file, so it can grow once its contents are written.  */
+  if (!bfd_elf_set_last_section_size (obfd, zsec,
+				      tables_size + writer->data_size))
+    error (_("Failed to write corefile contents (%s)."),
+	   bfd_errmsg (bfd_get_error ()));
+
+  do_cleanups (old_chain);
+}
+
 static int
-gcore_memory_sections (bfd *obfd)
+gcore_memory_sections (bfd *obfd, int compress,
+		       struct gcore_copy_stats *stats)
 {
+  struct zcore_writer writer;
+  struct cleanup *old_chain;
+  asection *zsec = NULL;
+
+  memset (&writer, 0, sizeof (writer));
+  writer.stats = stats;
+  old_chain = make_cleanup (free_zcore_writer, &writer);
+
   /* Try gdbarch method first, then fall back to target method.  */
   if (!gdbarch_find_memory_regions_p (target_gdbarch ())
       || gdbarch_find_memory_regions (target_gdbarch (),
 				      gcore_create_callback, obfd) != 0)
     {
       if (target_find_memory_regions (gcore_create_callback, obfd) != 0)
-	return 0;			/* FIXME: error return/msg?  */
+	{
+	  do_cleanups (old_chain);
+	  return 0;			/* FIXME: error return/msg?  */
+	}
+    }
+
+  /* The compressed segment starts out with just its header and
+     tables, and grows as the blocks are written.  */
+  if (compress)
+    {
+      if (bfd_get_flavour (obfd) != bfd_target_elf_flavour)
+	error (_("Compressed core files can only be written in ELF."));
+
+      bfd_map_over_sections (obfd, gcore_zcore_segment_callback, &writer);
+
+      zsec = bfd_make_section_anyway_with_flags (obfd, ZCORE_SECTION_NAME,
+						 SEC_HAS_CONTENTS
+						 | SEC_READONLY);
+      if (zsec == NULL)
+	error (_("Failed to create compressed section for corefile: %s"),
+	       bfd_errmsg (bfd_get_error ()));
+      bfd_set_section_vma (obfd, zsec, 0);
+      bfd_set_section_alignment (obfd, zsec, 0);
+      bfd_set_section_size (obfd, zsec, zcore_tables_size (&writer));
     }
 
   /* Record phdrs for section-to-segment mapping.  */
   bfd_map_over_sections (obfd, make_output_phdrs, NULL);
 
   /* Copy memory region contents.  */
-  bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
+  if (compress)
+    gcore_write_zcore_section (obfd, zsec, &writer);
+  else
+    bfd_map_over_sections (obfd, gcore_copy_callback, stats);
 
+  do_cleanups (old_chain);
   return 1;
 }
 
@@ -633,7 +1087,10 @@ _initialize_gcore (void)
 {
   add_com ("generate-core-file", class_files, gcore_command, _("\
 Save a core file with the current state of the debugged process.\n\
-Argument is optional filename.  Default filename is 'core.<process_id>'."));
+Usage: generate-core-file [-z] [FILENAME]\n\
+Default filename is 'core.<process_id>'.\n\
+With -z, the memory contents are written compressed; such core files\n\
+can only be read back by GDB."));
 
   add_com_alias ("gcore", "generate-core-file", class_files, 1);
 }
@@ -20,8 +20,76 @@
 #if !defined (GCORE_H)
 #define GCORE_H 1
 
+/* Statistics about the memory copied into a core file.  */
+
+struct gcore_copy_stats
+{
+  /* The number of bytes of memory copied, including the ones
+     skipped below.  */
+  ULONGEST data_count;
+
+  /* The number of those bytes that were all-zero blocks, left as
+     holes in the file instead of being written.  */
+  ULONGEST zero_count;
+
+  /* The number of writes done to the file.  */
+  unsigned long write_count;
+};
+
+/* Compressed core files, as written by "gcore -z".  The contents of
+   the memory segments are not stored in the load segments, which are
+   written without file contents, but in one extra segment, compressed
+   in blocks that can each be decompressed on their own.  That segment
+   holds, with all numbers little-endian:
+
+   - a header: the magic string ZCORE_MAGIC, the 4-byte format
+     version, the 4-byte block size, the 8-byte number of memory
+     segments and the 8-byte number of blocks;
+
+   - for each memory segment, its 8-byte address, 8-byte size and the
+     8-byte index of its first block, the blocks of a segment being
+     consecutive;
+
+   - for each block, the 8-byte offset of its data from the start of
+     the segment, the 4-byte size of the data and the 4-byte kind of
+     the block, one of enum zcore_block_kind;
+
+   - the data of the blocks.
+
+   Tools that do not know about the format see the memory segments as
+   having no contents.  */
+
+/* The ELF program header type of that segment.  This is in the range
+   reserved for OS-specific types, and is not used by any system.  */
+#define PT_GDB_ZCORE 0x6f474442
+
+/* The name of the section gcore creates for that segment.  Readers
+   find the segment by its magic string instead, since BFD does not
+   keep the name in the core file.  */
+#define ZCORE_SECTION_NAME "gdbzcore"
+
+#define ZCORE_MAGIC "GDBZCORE"
+#define ZCORE_MAGIC_LEN 8
+#define ZCORE_VERSION 1
+#define ZCORE_HEADER_SIZE 32
+#define ZCORE_SEGMENT_ENTRY_SIZE 24
+#define ZCORE_BLOCK_ENTRY_SIZE 16
+
+enum zcore_block_kind
+{
+  /* The block is all zero, and has no data.  */
+  ZCORE_BLOCK_ZERO = 0,
+
+  /* The data is the block itself.  */
+  ZCORE_BLOCK_STORED = 1,
+
+  /* The data is the block compressed with zlib.  */
+  ZCORE_BLOCK_ZLIB = 2
+};
+
 extern bfd *create_gcore_bfd (const char *filename);
-extern void write_gcore_file (bfd *obfd);
+extern void write_gcore_file (bfd *obfd, int compress,
+			      struct gcore_copy_stats *stats);
 extern bfd *load_corefile (char *filename, int from_tty);
 extern int objfile_find_memory_regions (struct target_ops *self,
 					find_memory_region_ftype func,
@@ -24,6 +24,8 @@
 #include "hashtab.h"
 #include "filestuff.h"
 #include "vec.h"
+#include "worker-threads.h"
+#include <zlib.h>
 #ifdef HAVE_MMAP
 #include <sys/mman.h>
 #ifndef MAP_FAILED
@@ -33,6 +35,8 @@
 #include "target.h"
 #include "gdb/fileio.h"
 #include "inferior.h"
+#include "objfiles.h"
+#include "completer.h"
 
 typedef bfd *bfdp;
 DEF_VEC_P (bfdp);
@@ -50,6 +54,9 @@ struct gdb_bfd_section_data
   void *data;
   /* If the data was mmapped, this is the map address.  */
   void *map_addr;
+  /* Non-zero if the map is anonymous memory holding the decompressed
+     contents of the section, rather than a map of the file.  */
+  int decompressed;
 };
 
 /* A hash table holding every BFD that gdb knows about.  This is not
@@ -642,6 +649,446 @@ get_section_descriptor (asection *section)
   return result;
 }
 
+/* Return the size of the compression header of SECTP, a compressed
+   section: SHF_COMPRESSED sections start with an ELF compression
+   header, .zdebug sections with "ZLIB" and the size.  */
+
+static int
+compression_header_size (asection *sectp)
+{
+  int header_size = bfd_get_compression_header_size (sectp->owner, sectp);
+
+  return header_size == 0 ? 12 : header_size;
+}
+
+/* The number of compressed bytes gdb_bfd_stream_decompress_section
+   reads from the file at a time.  */
+#define GDB_BFD_DECOMPRESS_BLOCK_SIZE (256 * 1024)
+
+/* Decompress the contents of SECTP, a compressed section, into BUF,
+   which is SIZE bytes long.  Unlike bfd_get_full_section_contents,
+   this reads the compressed contents block by block, instead of
+   holding all of them in memory along with the decompressed ones.
+   Return non-zero on success.  */
+
+static int
+gdb_bfd_stream_decompress_section (asection *sectp, gdb_byte *buf,
+				   bfd_size_type size)
+{
+  bfd *abfd = sectp->owner;
+  file_ptr pos, end;
+  bfd_size_type done = 0;
+  int header_size;
+  gdb_byte *block;
+  z_stream strm;
+  int rc;
+
+  header_size = compression_header_size (sectp);
+  if (sectp->compressed_size <= (bfd_size_type) header_size)
+    return 0;
+  pos = sectp->filepos + header_size;
+  end = sectp->filepos + sectp->compressed_size;
+
+  block = (gdb_byte *) xmalloc (GDB_BFD_DECOMPRESS_BLOCK_SIZE);
+  memset (&strm, 0, sizeof (strm));
+  rc = inflateInit (&strm);
+
+  /* The section may hold several compressed streams one after the
+     other.  */
+  while (rc == Z_OK && done < size)
+    {
+      uInt avail_out;
+
+      if (strm.avail_in == 0)
+	{
+	  bfd_size_type count = end - pos;
+
+	  if (count == 0)
+	    break;
+	  if (count > GDB_BFD_DECOMPRESS_BLOCK_SIZE)
+	    count = GDB_BFD_DECOMPRESS_BLOCK_SIZE;
+	  if (bfd_seek (abfd, pos, SEEK_SET) != 0
+	      || bfd_bread (block, count, abfd) != count)
+	    break;
+	  pos += count;
+	  strm.next_in = block;
+	  strm.avail_in = count;
+	}
+
+      /* zlib counts bytes in uInts, which sections may not fit in.  */
+      avail_out = (size - done > (1 << 30)) ? (1 << 30) : size - done;
+      strm.next_out = buf + done;
+      strm.avail_out = avail_out;
+      rc = inflate (&strm, Z_NO_FLUSH);
+      done += avail_out - strm.avail_out;
+      if (rc == Z_STREAM_END && done < size)
+	rc = inflateReset (&strm);
+    }
+  inflateEnd (&strm);
+  xfree (block);
+
+  return (rc == Z_OK || rc == Z_STREAM_END) && done == size;
+}
+
+/* Compressed debug sections can be compressed in chunks, that is, as
+   a sequence of independent zlib streams, each holding the same
+   number of bytes of the section except the last.  This is
+   still a valid compressed section, but a reader that knows where
+   each stream starts can decompress them in parallel.  The
+   .gdb_zchunks section records this, in little-endian order:
+
+   - a 4-byte version number, GDB_ZCHUNKS_VERSION;
+   - a 4-byte count of the compressed sections described;
+   - for each of these sections, aligned on 8 bytes: the 4-byte size
+     of its name, including the terminating NUL, the name itself,
+     padding to 8 bytes, then 8-byte values: the size of the section
+     in the file, its uncompressed size, the chunk size, the number
+     of chunks, and the offset of each chunk from the end of the
+     compression header.
+
+   "save compressed-debug-sections" writes such sections.  */
+
+#define GDB_ZCHUNKS_SECTION_NAME ".gdb_zchunks"
+#define GDB_ZCHUNKS_VERSION 1
+#define GDB_ZCHUNK_SIZE (1024 * 1024)
+
+/* The largest chunk size GDB accepts.  Chunks are decompressed with a
+   single call to inflate, whose sizes are uInts.  */
+#define GDB_ZCHUNK_SIZE_MAX (1 << 30)
+
+/* The chunk size "save compressed-debug-sections" uses.  */
+
+static unsigned int zchunk_size = GDB_ZCHUNK_SIZE;
+
+/* Implement the "maint set compressed-debug-chunk-size" command.  */
+
+static void
+set_zchunk_size (char *args, int from_tty, struct cmd_list_element *c)
+{
+  if (zchunk_size == 0 || zchunk_size > GDB_ZCHUNK_SIZE_MAX)
+    {
+      zchunk_size = GDB_ZCHUNK_SIZE;
+      error (_("The chunk size must be between 1 and %d bytes; "
+	       "resetting it to %d bytes."),
+	     GDB_ZCHUNK_SIZE_MAX, GDB_ZCHUNK_SIZE);
+    }
+}
+
+/* Implement the "maint show compressed-debug-chunk-size" command.  */
+
+static void
+show_zchunk_size (struct ui_file *file, int from_tty,
+		  struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Debug sections are saved compressed in "
+			    "chunks of %s bytes.\n"), value);
+}
+
+/* When non-zero, report the sections decompressed in chunks.  */
+
+static unsigned int debug_zchunks;
+
+static void
+show_zchunks_debug (struct ui_file *file, int from_tty,
+		    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Compressed chunks debugging is %s.\n"), value);
+}
+
+/* The chunks of a compressed section, from its .gdb_zchunks
+   entry.  */
+
+struct section_chunks
+{
+  /* The number of uncompressed bytes in each chunk but the last.  */
+  ULONGEST chunk_size;
+
+  /* The number of chunks.  */
+  ULONGEST n_chunks;
+
+  /* The N_CHUNKS 8-byte offsets of the chunks, in the contents of
+     .gdb_zchunks.  */
+  const gdb_byte *offsets;
+};
+
+/* Return the offset of the Ith chunk described by CHUNKS.  */
+
+static ULONGEST
+section_chunk_offset (const struct section_chunks *chunks, ULONGEST i)
+{
+  return extract_unsigned_integer (chunks->offsets + 8 * i, 8,
+				   BFD_ENDIAN_LITTLE);
+}
+
+/* Look for the description of the chunks of SECTP, a compressed
+   section, in INDEX, the INDEX_SIZE bytes of a .gdb_zchunks section.
+   If it is there, and matches SECTP, fill in *CHUNKS and return
+   non-zero.  */
+
+static int
+find_section_chunks (asection *sectp, const gdb_byte *index,
+		     bfd_size_type index_size, struct section_chunks *chunks)
+{
+  bfd_size_type pos = 8, data_size;
+  ULONGEST count, i;
+
+  if (index_size < 8
+      || extract_unsigned_integer (index, 4, BFD_ENDIAN_LITTLE)
+	 != GDB_ZCHUNKS_VERSION)
+    return 0;
+  count = extract_unsigned_integer (index + 4, 4, BFD_ENDIAN_LITTLE);
+  data_size = sectp->compressed_size - compression_header_size (sectp);
+
+  for (i = 0; i < count; ++i)
+    {
+      ULONGEST name_len, compressed_size, size, j;
+      const char *name;
+
+      if (index_size - pos < 4)
+	return 0;
+      name_len = extract_unsigned_integer (index + pos, 4, BFD_ENDIAN_LITTLE);
+      pos += 4;
+      if (name_len == 0 || index_size - pos < name_len)
+	return 0;
+      name = (const char *) index + pos;
+      if (name[name_len - 1] != '\0')
+	return 0;
+      pos = align_up (pos + name_len, 8);
+      if (pos > index_size || index_size - pos < 32)
+	return 0;
+
+      compressed_size = extract_unsigned_integer (index + pos, 8,
+						  BFD_ENDIAN_LITTLE);
+      size = extract_unsigned_integer (index + pos + 8, 8, BFD_ENDIAN_LITTLE);
+      chunks->chunk_size = extract_unsigned_integer (index + pos + 16, 8,
+						     BFD_ENDIAN_LITTLE);
+      chunks->n_chunks = extract_unsigned_integer (index + pos + 24, 8,
+						   BFD_ENDIAN_LITTLE);
+      pos += 32;
+      if (chunks->n_chunks > (index_size - pos) / 8)
+	return 0;
+      chunks->offsets = index + pos;
+      pos += 8 * chunks->n_chunks;
+
+      if (strcmp (name, bfd_get_section_name (sectp->owner, sectp)) != 0)
+	continue;
+
+      /* Check that the entry describes this section, and not the one
+	 a tool rewrote since.  */
+      if (compressed_size != sectp->compressed_size
+	  || size != bfd_get_section_size (sectp)
+	  || chunks->chunk_size == 0
+	  || chunks->chunk_size > GDB_ZCHUNK_SIZE_MAX
+	  || chunks->n_chunks != ((size + chunks->chunk_size - 1)
+				  / chunks->chunk_size)
+	  || chunks->n_chunks == 0
+	  || section_chunk_offset (chunks, 0) != 0)
+	return 0;
+      for (j = 1; j < chunks->n_chunks; ++j)
+	if (section_chunk_offset (chunks, j)
+	    <= section_chunk_offset (chunks, j - 1))
+	  return 0;
+      return section_chunk_offset (chunks, chunks->n_chunks - 1) < data_size;
+    }
+
+  return 0;
+}
+
+/* The data passed to decompress_one_chunk.  */
+
+struct chunks_decompression
+{
+  /* The chunks to decompress.  */
+  const struct section_chunks *chunks;
+
+  /* The compressed data, following the compression header, and its
+     size.  */
+  const gdb_byte *data;
+  bfd_size_type data_size;
+
+  /* Where to decompress the section, and its size.  */
+  gdb_byte *buf;
+  bfd_size_type size;
+
+  /* Set to non-zero for each chunk decompressed successfully.  */
+  char *chunk_ok;
+};
+
+/* parallel_for_each callback decompressing the Ith chunk of DATA, a
+   struct chunks_decompression.  */
+
+static void
+decompress_one_chunk (int i, void *data)
+{
+  struct chunks_decompression *work = (struct chunks_decompression *) data;
+  const struct section_chunks *chunks = work->chunks;
+  ULONGEST start, end, out_start;
+  z_stream strm;
+  int rc;
+
+  start = section_chunk_offset (chunks, i);
+  end = (i + 1 < chunks->n_chunks
+	 ? section_chunk_offset (chunks, i + 1) : work->data_size);
+  out_start = i * chunks->chunk_size;
+
+  memset (&strm, 0, sizeof (strm));
+  strm.next_in = (Bytef *) work->data + start;
+  strm.avail_in = end - start;
+  strm.next_out = work->buf + out_start;
+  strm.avail_out = min (chunks->chunk_size, work->size - out_start);
+  rc = inflateInit (&strm);
+  if (rc == Z_OK)
+    {
+      rc = inflate (&strm, Z_FINISH);
+      inflateEnd (&strm);
+    }
+  work->chunk_ok[i] = (rc == Z_STREAM_END
+		       && strm.avail_in == 0
+		       && strm.avail_out == 0);
+}
+
+/* If SECTP, a compressed section, was compressed in chunks, decompress
+   them in parallel into BUF, which is SIZE bytes long, and return
+   non-zero.  Otherwise, or if there is a single thread to do it,
+   return zero.  */
+
+static int
+gdb_bfd_decompress_chunks (asection *sectp, gdb_byte *buf,
+			   bfd_size_type size)
+{
+  int ok = 0;
+#ifdef HAVE_MMAP
+  bfd *abfd = sectp->owner;
+  asection *index_sect;
+  bfd_byte *index = NULL;
+  struct section_chunks chunks;
+  struct chunks_decompression work;
+  struct cleanup *cleanup;
+  void *map_addr;
+  bfd_size_type map_len;
+  int header_size;
+  ULONGEST i;
+
+  if (worker_thread_count () < 2)
+    return 0;
+
+  index_sect = bfd_get_section_by_name (abfd, GDB_ZCHUNKS_SECTION_NAME);
+  if (index_sect == NULL
+      || !bfd_malloc_and_get_section (abfd, index_sect, &index))
+    return 0;
+  cleanup = make_cleanup (xfree, index);
+
+  if (!find_section_chunks (sectp, index, bfd_get_section_size (index_sect),
+			    &chunks)
+      || chunks.n_chunks < 2
+      || chunks.n_chunks > INT_MAX)
+    {
+      do_cleanups (cleanup);
+      return 0;
+    }
+
+  /* Map the compressed contents, which worker threads can then read
+     without going through BFD.  */
+  header_size = compression_header_size (sectp);
+  work.data = (const gdb_byte *) bfd_mmap (abfd, 0, sectp->compressed_size,
+					   PROT_READ, MAP_PRIVATE,
+					   sectp->filepos, &map_addr,
+					   &map_len);
+  if ((caddr_t) work.data == MAP_FAILED)
+    {
+      do_cleanups (cleanup);
+      return 0;
+    }
+
+  work.chunks = &chunks;
+  work.data += header_size;
+  work.data_size = sectp->compressed_size - header_size;
+  work.buf = buf;
+  work.size = size;
+  work.chunk_ok = (char *) xcalloc (chunks.n_chunks, 1);
+  make_cleanup (xfree, work.chunk_ok);
+
+  parallel_for_each (chunks.n_chunks, decompress_one_chunk, &work);
+  munmap (map_addr, map_len);
+
+  ok = 1;
+  for (i = 0; i < chunks.n_chunks; ++i)
+    if (!work.chunk_ok[i])
+      ok = 0;
+
+  if (ok && debug_zchunks)
+    fprintf_unfiltered (gdb_stdlog,
+			"Decompressed section %s of %s in %s chunks\n",
+			bfd_get_section_name (abfd, sectp),
+			bfd_get_filename (abfd), pulongest (chunks.n_chunks));
+
+  do_cleanups (cleanup);
+#endif /* HAVE_MMAP */
+  return ok;
+}
+
+/* Decompress the contents of SECTP, a section that BFD decompresses,
+   into BUF, which is SIZE bytes long.  Return non-zero on success.  */
+
+static int
+gdb_bfd_decompress_section (asection *sectp, gdb_byte *buf,
+			    bfd_size_type size)
+{
+  if (sectp->compress_status != DECOMPRESS_SECTION_SIZED
+      || sectp->contents != NULL)
+    return 0;
+
+  return (gdb_bfd_decompress_chunks (sectp, buf, size)
+	  || gdb_bfd_stream_decompress_section (sectp, buf, size));
+}
+
+/* Store the decompressed contents of SECTP, a compressed section, in
+   DESCRIPTOR.  Return non-zero on success.  The contents go into
+   anonymous memory that is returned to the system when the BFD is
+   closed.  */
+
+static int
+gdb_bfd_map_compressed_section (asection *sectp,
+				struct gdb_bfd_section_data *descriptor)
+{
+  bfd_size_type size = bfd_get_section_size (sectp);
+  gdb_byte *buf;
+
+  if (size == 0)
+    return 0;
+
+#if defined (HAVE_MMAP) && defined (MAP_ANONYMOUS)
+  buf = (gdb_byte *) mmap (NULL, size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if ((caddr_t) buf != MAP_FAILED)
+    {
+      if (!gdb_bfd_decompress_section (sectp, buf, size))
+	{
+	  munmap (buf, size);
+	  return 0;
+	}
+
+      mprotect (buf, size, PROT_READ);
+      descriptor->map_addr = buf;
+      descriptor->map_len = size;
+      descriptor->decompressed = 1;
+      descriptor->size = size;
+      descriptor->data = buf;
+      return 1;
+    }
+#endif /* HAVE_MMAP && MAP_ANONYMOUS */
+
+  buf = (gdb_byte *) xmalloc (size);
+  if (!gdb_bfd_decompress_section (sectp, buf, size))
+    {
+      xfree (buf);
+      return 0;
+    }
+  descriptor->size = size;
+  descriptor->data = buf;
+  return 1;
+}
+
 /* See gdb_bfd.h.  */
 
 const gdb_byte *
@@ -662,8 +1109,13 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
   if (descriptor->data != NULL)
     goto done;
 
+  if (bfd_is_section_compressed (abfd, sectp))
+    {
+      if (gdb_bfd_map_compressed_section (sectp, descriptor))
+	goto done;
+    }
 #ifdef HAVE_MMAP
-  if (!bfd_is_section_compressed (abfd, sectp))
+  else
     {
       /* The page size, used when mmapping.  */
       static int pagesize;
@@ -671,10 +1123,12 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
       if (pagesize == 0)
 	pagesize = getpagesize ();
 
-      /* Only try to mmap sections which are large enough: we don't want
-	 to waste space due to fragmentation.  */
+      /* Map the file instead of copying it, so that the kernel can
+	 share the contents with the page cache, and page them in and
+	 out as GDB uses them.  Sections smaller than a page are cheaper
+	 to copy.  */
 
-      if (bfd_get_section_size (sectp) > 4 * pagesize)
+      if (bfd_get_section_size (sectp) >= pagesize)
 	{
 	  descriptor->size = bfd_get_section_size (sectp);
 	  descriptor->data = bfd_mmap (abfd, 0, descriptor->size, PROT_READ,
@@ -697,8 +1151,8 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
     }
 #endif /* HAVE_MMAP */
 
-  /* Handle compressed sections, or ordinary uncompressed sections in
-     the no-mmap case.  */
+  /* Handle small sections, and the sections that could not be mapped
+     or decompressed block by block.  */
 
   descriptor->size = bfd_get_section_size (sectp);
   descriptor->data = NULL;
@@ -953,6 +1407,73 @@ gdb_bfd_requires_relocations (bfd *abfd)
 
 
 
+/* The memory used by the section contents of a BFD, as computed by
+   add_section_memory_usage.  */
+
+struct section_memory_usage
+{
+  /* The number of bytes of section contents mapped from the file.  */
+  ULONGEST mapped;
+
+  /* The number of bytes of section contents in memory: the mapped
+     pages that are resident, and the contents read or decompressed
+     into GDB's memory.  */
+  ULONGEST resident;
+};
+
+/* Return the number of bytes of the LEN bytes mapped at ADDR that are
+   resident in memory.  */
+
+static ULONGEST
+resident_map_bytes (void *addr, bfd_size_type len)
+{
+#if defined (HAVE_MMAP) && defined (HAVE_MINCORE)
+  size_t pagesize = getpagesize ();
+  size_t npages = (len + pagesize - 1) / pagesize;
+  unsigned char *vec = (unsigned char *) xmalloc (npages);
+  ULONGEST result = 0;
+  size_t i;
+
+  if (mincore ((char *) addr, len, vec) != 0)
+    result = len;
+  else
+    {
+      for (i = 0; i < npages; ++i)
+	if ((vec[i] & 1) != 0)
+	  result += pagesize;
+      if (result > len)
+	result = len;
+    }
+  xfree (vec);
+  return result;
+#else
+  return len;
+#endif
+}
+
+/* A bfd_map_over_sections callback adding the memory used by the
+   contents of SECTP to DATA, a struct section_memory_usage.  */
+
+static void
+add_section_memory_usage (bfd *abfd, asection *sectp, void *data)
+{
+  struct section_memory_usage *usage = (struct section_memory_usage *) data;
+  struct gdb_bfd_section_data *sect
+    = (struct gdb_bfd_section_data *) bfd_get_section_userdata (abfd, sectp);
+
+  if (sect == NULL || sect->data == NULL)
+    return;
+
+  if (sect->map_addr == NULL)
+    usage->resident += sect->size;
+  else
+    {
+      if (!sect->decompressed)
+	usage->mapped += sect->size;
+      usage->resident += resident_map_bytes (sect->map_addr, sect->map_len);
+    }
+}
+
 /* A callback for htab_traverse that prints a single BFD.  */
 
 static int
@@ -961,11 +1482,17 @@ print_one_bfd (void **slot, void *data)
   bfd *abfd = (struct bfd *) *slot;
   struct gdb_bfd_data *gdata = (struct gdb_bfd_data *) bfd_usrdata (abfd);
   struct ui_out *uiout = (struct ui_out *) data;
+  struct section_memory_usage usage;
   struct cleanup *inner;
 
+  memset (&usage, 0, sizeof (usage));
+  bfd_map_over_sections (abfd, add_section_memory_usage, &usage);
+
   inner = make_cleanup_ui_out_tuple_begin_end (uiout, NULL);
   ui_out_field_int (uiout, "refcount", gdata->refc);
   ui_out_field_string (uiout, "addr", host_address_to_string (abfd));
+  ui_out_field_string (uiout, "mapped", pulongest (usage.mapped));
+  ui_out_field_string (uiout, "resident", pulongest (usage.resident));
   ui_out_field_string (uiout, "filename", bfd_get_filename (abfd));
   ui_out_text (uiout, "\n");
   do_cleanups (inner);
@@ -981,9 +1508,11 @@ maintenance_info_bfds (char *arg, int from_tty)
   struct cleanup *cleanup;
   struct ui_out *uiout = current_uiout;
 
-  cleanup = make_cleanup_ui_out_table_begin_end (uiout, 3, -1, "bfds");
+  cleanup = make_cleanup_ui_out_table_begin_end (uiout, 5, -1, "bfds");
   ui_out_table_header (uiout, 10, ui_left, "refcount", "Refcount");
   ui_out_table_header (uiout, 18, ui_left, "addr", "Address");
+  ui_out_table_header (uiout, 10, ui_right, "mapped", "Mapped");
+  ui_out_table_header (uiout, 10, ui_right, "resident", "Resident");
   ui_out_table_header (uiout, 40, ui_left, "filename", "Filename");
 
   ui_out_table_body (uiout);
@@ -992,19 +1521,307 @@ maintenance_info_bfds (char *arg, int from_tty)
   do_cleanups (cleanup);
 }
 
+/* The data passed to compress_one_chunk.  */
+
+struct chunks_compression
+{
+  /* The section contents, their size, and the chunk size.  */
+  const gdb_byte *contents;
+  bfd_size_type size;
+  bfd_size_type chunk_size;
+
+  /* For each chunk, a buffer for its compressed contents, and the
+     size of these contents; the size of the buffer on entry.  */
+  gdb_byte **bufs;
+  uLongf *lens;
+
+  /* Set to non-zero for each chunk compressed successfully.  */
+  char *chunk_ok;
+};
+
+/* parallel_for_each callback compressing the Ith chunk of DATA, a
+   struct chunks_compression.  */
+
+static void
+compress_one_chunk (int i, void *data)
+{
+  struct chunks_compression *work = (struct chunks_compression *) data;
+  bfd_size_type start = (bfd_size_type) i * work->chunk_size;
+  bfd_size_type len = min (work->chunk_size, work->size - start);
+
+  work->chunk_ok[i] = (compress (work->bufs[i], &work->lens[i],
+				 work->contents + start, len) == Z_OK);
+}
+
+/* Free the chunk buffers of WORK, a struct chunks_compression.  */
+
+static void
+free_chunks_compression (void *p)
+{
+  struct chunks_compression *work = (struct chunks_compression *) p;
+  int i;
+
+  for (i = 0; work->bufs[i] != NULL; ++i)
+    xfree (work->bufs[i]);
+  xfree (work->bufs);
+  xfree (work->lens);
+  xfree (work->chunk_ok);
+}
+
+/* Helper for unlink cleanups.  */
+
+static void
+unlink_if_set (void *p)
+{
+  char **filename = (char **) p;
+
+  if (*filename != NULL)
+    unlink (*filename);
+}
+
+/* Compress SECTP, a debug section of ABFD, in chunks, into the file
+   BASENAME followed by the name of the compressed section.  Append
+   its .gdb_zchunks entry to INDEX.  */
+
+static void
+write_compressed_section (bfd *abfd, asection *sectp, const char *basename,
+			  struct obstack *index)
+{
+  const char *name = bfd_get_section_name (abfd, sectp);
+  const char *zname;
+  char *filename, *cleanup_filename;
+  bfd_byte *contents = NULL;
+  bfd_size_type size;
+  struct chunks_compression work;
+  struct cleanup *cleanup;
+  int n_chunks, i;
+  ULONGEST offset;
+  gdb_byte val[8];
+  FILE *out_file;
+
+  if (!bfd_get_full_section_contents (abfd, sectp, &contents))
+    error (_("Can't read section `%s': %s"), name,
+	   bfd_errmsg (bfd_get_error ()));
+  cleanup = make_cleanup (free_current_contents, &contents);
+
+  /* BFD decompresses sections when opening files for GDB, but keeps
+     their names.  */
+  size = bfd_get_section_size (sectp);
+  if (startswith (name, ".zdebug_"))
+    zname = name;
+  else
+    {
+      zname = concat (".z", name + 1, (char *) NULL);
+      make_cleanup (xfree, (char *) zname);
+    }
+
+  /* Compress all the chunks in parallel.  */
+  n_chunks = (size + zchunk_size - 1) / zchunk_size;
+  work.contents = contents;
+  work.size = size;
+  work.chunk_size = zchunk_size;
+  work.bufs = XCNEWVEC (gdb_byte *, n_chunks + 1);
+  work.lens = XNEWVEC (uLongf, n_chunks);
+  work.chunk_ok = (char *) xcalloc (n_chunks, 1);
+  make_cleanup (free_chunks_compression, &work);
+  for (i = 0; i < n_chunks; ++i)
+    {
+      work.lens[i] = compressBound (work.chunk_size);
+      work.bufs[i] = (gdb_byte *) xmalloc (work.lens[i]);
+    }
+  parallel_for_each (n_chunks, compress_one_chunk, &work);
+  for (i = 0; i < n_chunks; ++i)
+    if (!work.chunk_ok[i])
+      error (_("Can't compress section `%s'"), name);
+
+  filename = concat (basename, zname, (char *) NULL);
+  make_cleanup (xfree, filename);
+  out_file = gdb_fopen_cloexec (filename, "wb");
+  if (out_file == NULL)
+    error (_("Can't open `%s' for writing"), filename);
+  make_cleanup_fclose (out_file);
+  cleanup_filename = filename;
+  make_cleanup (unlink_if_set, &cleanup_filename);
+
+  /* The .zdebug header: "ZLIB" and the big-endian uncompressed
+     size.  */
+  memcpy (val, "ZLIB", 4);
+  if (fwrite (val, 4, 1, out_file) != 1)
+    error (_("couldn't write data to file"));
+  store_unsigned_integer (val, 8, BFD_ENDIAN_BIG, size);
+  if (fwrite (val, 8, 1, out_file) != 1)
+    error (_("couldn't write data to file"));
+  offset = 0;
+  for (i = 0; i < n_chunks; ++i)
+    {
+      if (fwrite (work.bufs[i], work.lens[i], 1, out_file) != 1)
+	error (_("couldn't write data to file"));
+      offset += work.lens[i];
+    }
+
+  store_unsigned_integer (val, 4, BFD_ENDIAN_LITTLE, strlen (zname) + 1);
+  obstack_grow (index, val, 4);
+  obstack_grow (index, zname, strlen (zname) + 1);
+  memset (val, 0, 8);
+  obstack_grow (index, val,
+		align_up (obstack_object_size (index), 8)
+		- obstack_object_size (index));
+  store_unsigned_integer (val, 8, BFD_ENDIAN_LITTLE, 12 + offset);
+  obstack_grow (index, val, 8);
+  store_unsigned_integer (val, 8, BFD_ENDIAN_LITTLE, size);
+  obstack_grow (index, val, 8);
+  store_unsigned_integer (val, 8, BFD_ENDIAN_LITTLE, work.chunk_size);
+  obstack_grow (index, val, 8);
+  store_unsigned_integer (val, 8, BFD_ENDIAN_LITTLE, n_chunks);
+  obstack_grow (index, val, 8);
+  offset = 0;
+  for (i = 0; i < n_chunks; ++i)
+    {
+      store_unsigned_integer (val, 8, BFD_ENDIAN_LITTLE, offset);
+      obstack_grow (index, val, 8);
+      offset += work.lens[i];
+    }
+
+  /* Keep the file.  */
+  cleanup_filename = NULL;
+  do_cleanups (cleanup);
+}
+
+/* Write the debug sections of ABFD, compressed in chunks, to files in
+   DIR, along with their .gdb_zchunks section.  */
+
+static void
+write_compressed_sections (bfd *abfd, const char *dir)
+{
+  struct cleanup *cleanup;
+  char *basename, *filename, *cleanup_filename;
+  struct obstack index;
+  gdb_byte *index_data;
+  asection *sectp;
+  gdb_byte val[4];
+  int count = 0;
+  FILE *out_file;
+
+  /* Relocatable files have their debug sections relocated when read,
+     and GDB could not reliably tell the contents it should keep.  */
+  if (gdb_bfd_requires_relocations (abfd))
+    error (_("Cannot compress the sections of a relocatable file"));
+
+  basename = concat (dir, SLASH_STRING, lbasename (bfd_get_filename (abfd)),
+		     (char *) NULL);
+  cleanup = make_cleanup (xfree, basename);
+  obstack_init (&index);
+  make_cleanup_obstack_free (&index);
+
+  /* Leave room for the header.  */
+  memset (val, 0, 4);
+  obstack_grow (&index, val, 4);
+  obstack_grow (&index, val, 4);
+
+  for (sectp = abfd->sections; sectp != NULL; sectp = sectp->next)
+    {
+      const char *name = bfd_get_section_name (abfd, sectp);
+
+      if ((bfd_get_section_flags (abfd, sectp)
+	   & (SEC_DEBUGGING | SEC_HAS_CONTENTS | SEC_ALLOC | SEC_RELOC))
+	  != (SEC_DEBUGGING | SEC_HAS_CONTENTS)
+	  || bfd_get_section_size (sectp) == 0
+	  || !(startswith (name, ".debug_") || startswith (name, ".zdebug_")))
+	continue;
+
+      write_compressed_section (abfd, sectp, basename, &index);
+      ++count;
+    }
+
+  if (count == 0)
+    {
+      do_cleanups (cleanup);
+      return;
+    }
+
+  index_data = (gdb_byte *) obstack_base (&index);
+  store_unsigned_integer (index_data, 4, BFD_ENDIAN_LITTLE,
+			  GDB_ZCHUNKS_VERSION);
+  store_unsigned_integer (index_data + 4, 4, BFD_ENDIAN_LITTLE, count);
+
+  filename = concat (basename, GDB_ZCHUNKS_SECTION_NAME, (char *) NULL);
+  make_cleanup (xfree, filename);
+  out_file = gdb_fopen_cloexec (filename, "wb");
+  if (out_file == NULL)
+    error (_("Can't open `%s' for writing"), filename);
+  make_cleanup_fclose (out_file);
+  cleanup_filename = filename;
+  make_cleanup (unlink_if_set, &cleanup_filename);
+
+  if (fwrite (index_data, obstack_object_size (&index), 1, out_file) != 1)
+    error (_("couldn't write data to file"));
+
+  /* Keep the file.  */
+  cleanup_filename = NULL;
+  do_cleanups (cleanup);
+}
+
+/* Implement the 'save compressed-debug-sections' command.  */
+
+static void
+save_compressed_debug_sections_command (char *arg, int from_tty)
+{
+  struct objfile *objfile;
+
+  if (arg == NULL || *arg == '\0')
+    error (_("usage: save compressed-debug-sections DIRECTORY"));
+
+  ALL_OBJFILES (objfile)
+  {
+    struct stat st;
+
+    /* If the objfile does not correspond to an actual file, skip it.  */
+    if (stat (objfile_name (objfile), &st) < 0)
+      continue;
+
+    TRY
+      {
+	write_compressed_sections (objfile->obfd, arg);
+      }
+    CATCH (except, RETURN_MASK_ERROR)
+      {
+	exception_fprintf (gdb_stderr, except,
+			   _("Error while compressing sections of `%s': "),
+			   objfile_name (objfile));
+      }
+    END_CATCH
+  }
+}
+
 /* -Wmissing-prototypes */
 extern initialize_file_ftype _initialize_gdb_bfd;
 
 void
 _initialize_gdb_bfd (void)
 {
+  struct cmd_list_element *c;
+
   all_bfds = htab_create_alloc (10, htab_hash_pointer, htab_eq_pointer,
 				NULL, xcalloc, xfree);
 
   add_cmd ("bfds", class_maintenance, maintenance_info_bfds, _("\
-List the BFDs that are currently open."),
+List the BFDs that are currently open.\n\
+For each BFD, this shows how many bytes of section contents GDB maps\n\
+from the file, and how many bytes of section contents are resident\n\
+in memory."),
 	   &maintenanceinfolist);
 
+  c = add_cmd ("compressed-debug-sections", class_files,
+	       save_compressed_debug_sections_command, _("\
+Save the debug sections of the program, compressed in chunks.\n\
+Usage: save compressed-debug-sections DIRECTORY\n\
+For each object file, this writes in DIRECTORY a file per debug section,\n\
+named after the object file and the compressed section, and a file\n\
+with the .gdb_zchunks section that lets GDB decompress the chunks in\n\
+parallel."),
+	       &save_cmdlist);
+  set_cmd_completer (c, filename_completer);
+
   add_setshow_boolean_cmd ("bfd-sharing", no_class,
 			   &bfd_sharing, _("\
 Set whether gdb will share bfds that appear to be the same file."), _("\
@@ -1025,4 +1842,26 @@ When non-zero, bfd cache specific debugging is enabled."),
 			     NULL,
 			     &show_bfd_cache_debug,
 			     &setdebuglist, &showdebuglist);
+
+  add_setshow_zuinteger_cmd ("zchunks", class_maintenance,
+			     &debug_zchunks, _("\
+Set compressed chunks debugging."), _("\
+Show compressed chunks debugging."), _("\
+When non-zero, GDB reports each debug section it decompresses in\n\
+chunks in parallel, as described by a .gdb_zchunks section."),
+			     NULL,
+			     &show_zchunks_debug,
+			     &setdebuglist, &showdebuglist);
+
+  add_setshow_zuinteger_cmd ("compressed-debug-chunk-size",
+			     class_maintenance, &zchunk_size, _("\
+Set the chunk size of the debug sections saved compressed."), _("\
+Show the chunk size of the debug sections saved compressed."), _("\
+\"save compressed-debug-sections\" compresses each chunk of this many\n\
+bytes of a debug section on its own.  Smaller chunks let more of them\n\
+be decompressed in parallel, but compress less well."),
+			     set_zchunk_size,
+			     show_zchunk_size,
+			     &maintenance_set_cmdlist,
+			     &maintenance_show_cmdlist);
 }
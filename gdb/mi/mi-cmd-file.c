@@ -68,6 +68,8 @@ print_partial_file_name (const char *filename, const char *fullname,
 {
   struct ui_out *uiout = current_uiout;
 
+  QUIT;
+
   ui_out_begin (uiout, ui_out_type_tuple, NULL);
 
   ui_out_field_string (uiout, "file", filename);
@@ -95,6 +97,8 @@ mi_cmd_file_list_exec_source_files (char *command, char **argv, int argc)
   /* Look at all of the file symtabs.  */
   ALL_FILETABS (objfile, cu, s)
   {
+    QUIT;
+
     ui_out_begin (uiout, ui_out_type_tuple, NULL);
 
     ui_out_field_string (uiout, "file", symtab_to_filename_for_display (s));
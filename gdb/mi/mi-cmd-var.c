@@ -439,6 +439,7 @@ mi_cmd_var_list_children (char *command, char **argv, int argc)
 	{
 	  struct cleanup *cleanup_child;
 
+	  QUIT;
 	  cleanup_child = make_cleanup_ui_out_tuple_begin_end (uiout, "child");
 	  print_varobj (child, print_values, 1 /* print expression */);
 	  do_cleanups (cleanup_child);
@@ -654,6 +655,8 @@ mi_cmd_var_update_iter (struct varobj *var, void *data_pointer)
   struct mi_cmd_var_update *data = (struct mi_cmd_var_update *) data_pointer;
   int thread_id, thread_stopped;
 
+  QUIT;
+
   thread_id = varobj_get_thread_id (var);
 
   if (thread_id == -1
@@ -707,15 +710,19 @@ mi_cmd_var_update (char *command, char **argv, int argc)
   if ((*name == '*' || *name == '@') && (*(name + 1) == '\0'))
     {
       struct mi_cmd_var_update data;
+      struct cleanup *batch_cleanup;
 
       data.only_floating = (*name == '@');
       data.print_values = print_values;
 
       /* varobj_update_one automatically updates all the children of
 	 VAROBJ.  Therefore update each VAROBJ only once by iterating
-	 only the root VAROBJs.  */
+	 only the root VAROBJs.  Read the memory of all of them at
+	 once.  */
 
+      batch_cleanup = varobj_update_batch_begin (NULL);
       all_root_varobjs (mi_cmd_var_update_iter, &data);
+      do_cleanups (batch_cleanup);
     }
   else
     {
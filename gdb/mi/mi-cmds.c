@@ -43,6 +43,12 @@ static struct mi_cmd mi_cmds[] =
   { NAME, {NULL, 0}, MI_FUNC, CALLED }
 #define DEF_MI_CMD_MI(NAME, MI_FUNC) DEF_MI_CMD_MI_1(NAME, MI_FUNC, NULL)
 
+/* Define a MI command of NAME, implemented by function MI_FUNC, that
+   only queries GDB's state.  MI input is read while such a command
+   runs, so that it can be interrupted or cancelled.  */
+#define DEF_MI_CMD_MI_QUERY(NAME, MI_FUNC) \
+  { NAME, {NULL, 0}, MI_FUNC, NULL, 1 }
+
   DEF_MI_CMD_MI ("ada-task-info", mi_cmd_ada_task_info),
   DEF_MI_CMD_MI ("add-inferior", mi_cmd_add_inferior),
   DEF_MI_CMD_CLI_1 ("break-after", "ignore", 1,
@@ -113,8 +119,8 @@ static struct mi_cmd mi_cmds[] =
   DEF_MI_CMD_CLI ("file-exec-file", "exec-file", 1),
   DEF_MI_CMD_MI ("file-list-exec-source-file",
 		 mi_cmd_file_list_exec_source_file),
-  DEF_MI_CMD_MI ("file-list-exec-source-files",
-		 mi_cmd_file_list_exec_source_files),
+  DEF_MI_CMD_MI_QUERY ("file-list-exec-source-files",
+		       mi_cmd_file_list_exec_source_files),
   DEF_MI_CMD_CLI ("file-symbol-file", "symbol-file", 1),
   DEF_MI_CMD_MI ("gdb-exit", mi_cmd_gdb_exit),
   DEF_MI_CMD_CLI_1 ("gdb-set", "set", 1,
@@ -130,15 +136,16 @@ static struct mi_cmd mi_cmds[] =
   DEF_MI_CMD_MI ("list-features", mi_cmd_list_features),
   DEF_MI_CMD_MI ("list-target-features", mi_cmd_list_target_features),
   DEF_MI_CMD_MI ("list-thread-groups", mi_cmd_list_thread_groups),
+  DEF_MI_CMD_MI ("query-cancel", mi_cmd_query_cancel),
   DEF_MI_CMD_MI ("remove-inferior", mi_cmd_remove_inferior),
   DEF_MI_CMD_MI ("stack-info-depth", mi_cmd_stack_info_depth),
   DEF_MI_CMD_MI ("stack-info-frame", mi_cmd_stack_info_frame),
-  DEF_MI_CMD_MI ("stack-list-arguments", mi_cmd_stack_list_args),
-  DEF_MI_CMD_MI ("stack-list-frames", mi_cmd_stack_list_frames),
-  DEF_MI_CMD_MI ("stack-list-locals", mi_cmd_stack_list_locals),
-  DEF_MI_CMD_MI ("stack-list-variables", mi_cmd_stack_list_variables),
+  DEF_MI_CMD_MI_QUERY ("stack-list-arguments", mi_cmd_stack_list_args),
+  DEF_MI_CMD_MI_QUERY ("stack-list-frames", mi_cmd_stack_list_frames),
+  DEF_MI_CMD_MI_QUERY ("stack-list-locals", mi_cmd_stack_list_locals),
+  DEF_MI_CMD_MI_QUERY ("stack-list-variables", mi_cmd_stack_list_variables),
   DEF_MI_CMD_MI ("stack-select-frame", mi_cmd_stack_select_frame),
-  DEF_MI_CMD_MI ("symbol-list-lines", mi_cmd_symbol_list_lines),
+  DEF_MI_CMD_MI_QUERY ("symbol-list-lines", mi_cmd_symbol_list_lines),
   DEF_MI_CMD_CLI ("target-attach", "attach", 1),
   DEF_MI_CMD_MI ("target-detach", mi_cmd_target_detach),
   DEF_MI_CMD_CLI ("target-disconnect", "disconnect", 0),
@@ -168,14 +175,14 @@ static struct mi_cmd mi_cmds[] =
   DEF_MI_CMD_MI ("var-info-expression", mi_cmd_var_info_expression),
   DEF_MI_CMD_MI ("var-info-num-children", mi_cmd_var_info_num_children),
   DEF_MI_CMD_MI ("var-info-type", mi_cmd_var_info_type),
-  DEF_MI_CMD_MI ("var-list-children", mi_cmd_var_list_children),
+  DEF_MI_CMD_MI_QUERY ("var-list-children", mi_cmd_var_list_children),
   DEF_MI_CMD_MI ("var-set-format", mi_cmd_var_set_format),
   DEF_MI_CMD_MI ("var-set-frozen", mi_cmd_var_set_frozen),
   DEF_MI_CMD_MI ("var-set-update-range", mi_cmd_var_set_update_range),
   DEF_MI_CMD_MI ("var-set-visualizer", mi_cmd_var_set_visualizer),
   DEF_MI_CMD_MI ("var-show-attributes", mi_cmd_var_show_attributes),
   DEF_MI_CMD_MI ("var-show-format", mi_cmd_var_show_format),
-  DEF_MI_CMD_MI ("var-update", mi_cmd_var_update),
+  DEF_MI_CMD_MI_QUERY ("var-update", mi_cmd_var_update),
   { NULL, }
 };
 
@@ -80,6 +80,7 @@ extern mi_cmd_argv_ftype mi_cmd_interpreter_exec;
 extern mi_cmd_argv_ftype mi_cmd_list_features;
 extern mi_cmd_argv_ftype mi_cmd_list_target_features;
 extern mi_cmd_argv_ftype mi_cmd_list_thread_groups;
+extern mi_cmd_argv_ftype mi_cmd_query_cancel;
 extern mi_cmd_argv_ftype mi_cmd_remove_inferior;
 extern mi_cmd_argv_ftype mi_cmd_stack_info_depth;
 extern mi_cmd_argv_ftype mi_cmd_stack_info_frame;
@@ -148,6 +149,10 @@ struct mi_cmd
      being executed.  It will be set back to false when command has been
      executed.  */
   int *suppress_notification;
+  /* Non-zero if the command only queries GDB's state.  While such a
+     command runs, MI input is read from QUIT, and -exec-interrupt and
+     -query-cancel are acted on at once.  */
+  int query;
 };
 
 /* Lookup a command in the MI command table.  */
@@ -26,6 +26,8 @@
 
 #include "defs.h"
 #include "mi-console.h"
+#include "mi-main.h"
+#include "gdb_obstack.h"
 static ui_file_fputs_ftype mi_console_file_fputs;
 static ui_file_flush_ftype mi_console_file_flush;
 static ui_file_delete_ftype mi_console_file_delete;
@@ -156,3 +158,227 @@ mi_console_set_raw (struct ui_file *file, struct ui_file *raw)
 
   mi_console->raw = raw;
 }
+
+/* An MI record file is the ui_file that all MI records and console
+   packets are written to.  It normally passes everything straight
+   through to the stream it wraps.  When "set mi-output-buffering" is
+   on, output is instead gathered in memory, and each flush writes the
+   complete lines gathered so far with a single system call.  When
+   "set mi-output-framing" is "length", each of those lines is also
+   preceded by its length in bytes, so that a front end can read a
+   record without scanning it for quoting and newlines.  */
+
+static ui_file_write_ftype mi_record_file_write;
+static ui_file_write_async_safe_ftype mi_record_file_write_async_safe;
+static ui_file_fputs_ftype mi_record_file_fputs;
+static ui_file_flush_ftype mi_record_file_flush;
+static ui_file_isatty_ftype mi_record_file_isatty;
+static ui_file_delete_ftype mi_record_file_delete;
+
+struct mi_record_file
+  {
+    int *magic;
+    struct ui_file *raw;
+
+    /* Output not written to RAW yet.  */
+    char *buffer;
+    long length_buffer;
+    long sizeof_buffer;
+  };
+
+static int mi_record_file_magic;
+
+/* Create a record file that wraps the given output stream RAW.  */
+
+struct ui_file *
+mi_record_file_new (struct ui_file *raw)
+{
+  struct ui_file *ui_file = ui_file_new ();
+  struct mi_record_file *rec = XCNEW (struct mi_record_file);
+
+  rec->magic = &mi_record_file_magic;
+  rec->raw = raw;
+  set_ui_file_data (ui_file, rec, mi_record_file_delete);
+  set_ui_file_write (ui_file, mi_record_file_write);
+  set_ui_file_write_async_safe (ui_file, mi_record_file_write_async_safe);
+  set_ui_file_fputs (ui_file, mi_record_file_fputs);
+  set_ui_file_flush (ui_file, mi_record_file_flush);
+  set_ui_file_isatty (ui_file, mi_record_file_isatty);
+
+  return ui_file;
+}
+
+static struct mi_record_file *
+mi_record_file_data (struct ui_file *file, const char *func)
+{
+  struct mi_record_file *rec
+    = (struct mi_record_file *) ui_file_data (file);
+
+  if (rec->magic != &mi_record_file_magic)
+    internal_error (__FILE__, __LINE__,
+		    _("%s: bad magic number"), func);
+  return rec;
+}
+
+static void
+mi_record_file_delete (struct ui_file *file)
+{
+  struct mi_record_file *rec
+    = mi_record_file_data (file, "mi_record_file_delete");
+
+  xfree (rec->buffer);
+  xfree (rec);
+}
+
+/* Return non-zero if output should be gathered in memory.  */
+
+static int
+mi_record_file_buffering_p (void)
+{
+  return (mi_output_buffering
+	  || mi_output_framing == mi_output_framing_length);
+}
+
+/* Append LENGTH_BUF bytes from BUF to REC's buffer.  */
+
+static void
+mi_record_file_append (struct mi_record_file *rec,
+		       const char *buf, long length_buf)
+{
+  if (rec->length_buffer + length_buf > rec->sizeof_buffer)
+    {
+      rec->sizeof_buffer = max (rec->sizeof_buffer * 2,
+				rec->length_buffer + length_buf);
+      rec->sizeof_buffer = max (rec->sizeof_buffer, 1024);
+      rec->buffer = (char *) xrealloc (rec->buffer, rec->sizeof_buffer);
+    }
+  memcpy (rec->buffer + rec->length_buffer, buf, length_buf);
+  rec->length_buffer += length_buf;
+}
+
+static void
+mi_record_file_write (struct ui_file *file, const char *buf, long length_buf)
+{
+  struct mi_record_file *rec
+    = mi_record_file_data (file, "mi_record_file_write");
+
+  /* Once something is buffered, keep buffering until the next flush
+     so that output stays in order even if the settings change.  */
+  if (rec->length_buffer > 0 || mi_record_file_buffering_p ())
+    mi_record_file_append (rec, buf, length_buf);
+  else
+    ui_file_write (rec->raw, buf, length_buf);
+}
+
+static void
+mi_record_file_fputs (const char *buf, struct ui_file *file)
+{
+  mi_record_file_write (file, buf, strlen (buf));
+}
+
+static void
+mi_record_file_write_async_safe (struct ui_file *file,
+				 const char *buf, long length_buf)
+{
+  struct mi_record_file *rec = (struct mi_record_file *) ui_file_data (file);
+
+  ui_file_write_async_safe (rec->raw, buf, length_buf);
+}
+
+static int
+mi_record_file_isatty (struct ui_file *file)
+{
+  struct mi_record_file *rec
+    = mi_record_file_data (file, "mi_record_file_isatty");
+
+  return ui_file_isatty (rec->raw);
+}
+
+/* Write LENGTH_BUF bytes from BUF to RAW.  If RAW is a stdio file,
+   bypass its buffer and write to the descriptor directly, so that
+   the output goes out with as few system calls as possible.  */
+
+static void
+mi_record_file_emit (struct ui_file *raw, const char *buf, long length_buf)
+{
+  int fd = stdio_file_fd (raw);
+
+  gdb_flush (raw);
+  if (fd < 0)
+    {
+      ui_file_write (raw, buf, length_buf);
+      gdb_flush (raw);
+      return;
+    }
+
+  while (length_buf > 0)
+    {
+      ssize_t n = write (fd, buf, length_buf);
+
+      if (n < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  /* Like stdio_file_write, errors are silently dropped, as
+	     calling error here could recurse.  */
+	  break;
+	}
+      buf += n;
+      length_buf -= n;
+    }
+}
+
+static void
+mi_record_file_flush (struct ui_file *file)
+{
+  struct mi_record_file *rec
+    = mi_record_file_data (file, "mi_record_file_flush");
+  long length;
+
+  if (rec->length_buffer == 0)
+    {
+      gdb_flush (rec->raw);
+      return;
+    }
+
+  /* Only complete lines are written while buffering; a partial line
+     stays in the buffer until the rest of it arrives.  */
+  if (mi_record_file_buffering_p ())
+    {
+      for (length = rec->length_buffer; length > 0; length--)
+	if (rec->buffer[length - 1] == '\n')
+	  break;
+      if (length == 0)
+	return;
+    }
+  else
+    length = rec->length_buffer;
+
+  if (mi_output_framing == mi_output_framing_length)
+    {
+      struct obstack framed;
+      const char *p = rec->buffer;
+      const char *limit = rec->buffer + length;
+
+      obstack_init (&framed);
+      while (p < limit)
+	{
+	  const char *nl = (const char *) memchr (p, '\n', limit - p);
+	  long line = (nl != NULL ? nl + 1 : limit) - p;
+	  char prefix[32];
+
+	  xsnprintf (prefix, sizeof (prefix), "%ld:", line);
+	  obstack_grow (&framed, prefix, strlen (prefix));
+	  obstack_grow (&framed, p, line);
+	  p += line;
+	}
+      mi_record_file_emit (rec->raw, (const char *) obstack_base (&framed),
+			   obstack_object_size (&framed));
+      obstack_free (&framed, NULL);
+    }
+  else
+    mi_record_file_emit (rec->raw, rec->buffer, length);
+
+  memmove (rec->buffer, rec->buffer + length, rec->length_buffer - length);
+  rec->length_buffer -= length;
+}
@@ -27,4 +27,9 @@ extern struct ui_file *mi_console_file_new (struct ui_file *raw,
 extern void mi_console_set_raw (struct ui_file *console,
 				struct ui_file *raw);
 
+/* Create the ui_file that MI records are written to, wrapping RAW.
+   See "set mi-output-buffering" and "set mi-output-framing".  */
+
+extern struct ui_file *mi_record_file_new (struct ui_file *raw);
+
 #endif
@@ -38,6 +38,8 @@
 #include "tracepoint.h"
 #include "cli-out.h"
 #include "thread-fsm.h"
+#include "gdb_select.h"
+#include <ctype.h>
 
 /* These are the interpreter setup, etc. functions for the MI
    interpreter.  */
@@ -88,6 +90,10 @@ static void mi_on_sync_execution_done (void);
 
 static int report_initial_inferior (struct inferior *inf, void *closure);
 
+static void mi_readline (gdb_client_data client_data);
+static void mi_poll_input (void);
+static void mi_schedule_pending_input (void);
+
 static void *
 mi_interpreter_init (struct interp *interp, int top_level)
 {
@@ -98,9 +104,10 @@ mi_interpreter_init (struct interp *interp, int top_level)
   /* Assign the output channel created at startup to its own global,
      so that we can create a console channel that encapsulates and
      prefixes all gdb_output-type bits coming from the rest of the
-     debugger.  */
+     debugger.  Records are written through a record file, which
+     implements MI output buffering and framing.  */
 
-  raw_stdout = gdb_stdout;
+  raw_stdout = mi_record_file_new (gdb_stdout);
 
   /* Create MI console channels, each with a different prefix so they
      can be distinguished.  */
@@ -181,8 +188,9 @@ mi_interpreter_resume (void *data)
 
   /* These overwrite some of the initialization done in
      _intialize_event_loop.  */
-  call_readline = gdb_readline2;
+  call_readline = mi_readline;
   input_handler = mi_execute_command_input_handler;
+  quit_poll_hook = mi_poll_input;
   async_command_editing_p = 0;
   /* FIXME: This is a total hack for now.  PB's use of the MI
      implicitly relies on a bug in the async support which allows
@@ -213,6 +221,7 @@ mi_interpreter_resume (void *data)
 static int
 mi_interpreter_suspend (void *data)
 {
+  quit_poll_hook = NULL;
   gdb_disable_readline ();
   return 1;
 }
@@ -316,6 +325,7 @@ mi_on_sync_execution_done (void)
     {
       fputs_unfiltered ("(gdb) \n", raw_stdout);
       gdb_flush (raw_stdout);
+      mi_schedule_pending_input ();
     }
 }
 
@@ -335,7 +345,251 @@ mi_execute_command_input_handler (char *cmd)
     {
       fputs_unfiltered ("(gdb) \n", raw_stdout);
       gdb_flush (raw_stdout);
+      mi_schedule_pending_input ();
+    }
+}
+
+/* Input read from stdin by mi_poll_input while a query command ran,
+   and not executed yet.  */
+static char *mi_pending_input;
+static size_t mi_pending_input_length;
+static size_t mi_pending_input_size;
+
+/* The length of the prefix of mi_pending_input that mi_poll_input
+   has already looked for commands to execute at once.  */
+static size_t mi_pending_input_scanned;
+
+/* Marked when complete lines of pending input are waiting to be
+   executed.  */
+static struct async_event_handler *mi_pending_input_event;
+
+/* Return the length of the first line in the pending input, including
+   its newline, or 0 if there is no complete line.  */
+
+static size_t
+mi_pending_input_line_length (void)
+{
+  char *nl;
+
+  if (mi_pending_input_length == 0)
+    return 0;
+  nl = (char *) memchr (mi_pending_input, '\n', mi_pending_input_length);
+  return nl != NULL ? nl + 1 - mi_pending_input : 0;
+}
+
+/* Remove the LENGTH bytes at OFFSET from the pending input.  */
+
+static void
+mi_pending_input_remove (size_t offset, size_t length)
+{
+  memmove (mi_pending_input + offset, mi_pending_input + offset + length,
+	   mi_pending_input_length - offset - length);
+  mi_pending_input_length -= length;
+  if (mi_pending_input_scanned > offset)
+    mi_pending_input_scanned -= min (length,
+				     mi_pending_input_scanned - offset);
+}
+
+/* Return a copy of the line of LENGTH bytes at LINE, without its
+   line terminator.  */
+
+static char *
+mi_pending_input_copy_line (const char *line, size_t length)
+{
+  if (length > 0 && line[length - 1] == '\n')
+    length--;
+  if (length > 0 && line[length - 1] == '\r')
+    length--;
+  return savestring (line, length);
+}
+
+/* The async event handler for pending input: execute the next
+   pending line, as if it had just been read from stdin.  */
+
+static void
+mi_pending_input_handler (gdb_client_data client_data)
+{
+  if (sync_execution || call_readline != mi_readline)
+    return;
+
+  mi_readline (NULL);
+}
+
+/* Arrange for pending input to be executed from the event loop, once
+   MI is ready to read its next command.  */
+
+static void
+mi_schedule_pending_input (void)
+{
+  if (mi_pending_input_line_length () == 0)
+    return;
+
+  if (mi_pending_input_event == NULL)
+    mi_pending_input_event
+      = create_async_event_handler (mi_pending_input_handler, NULL);
+  mark_async_event_handler (mi_pending_input_event);
+}
+
+/* The MI implementation of CALL_READLINE.  Like gdb_readline2, but
+   input read by mi_poll_input comes first.  */
+
+static void
+mi_readline (gdb_client_data client_data)
+{
+  size_t length = mi_pending_input_line_length ();
+  char *line;
+  int c;
+
+  if (mi_pending_input_length == 0)
+    {
+      gdb_readline2 (client_data);
+      return;
     }
+
+  /* Complete a partial line with what follows it on stdin.  */
+  while (length == 0)
+    {
+      c = fgetc (instream ? instream : stdin);
+      if (c == EOF)
+	{
+	  length = mi_pending_input_length;
+	  break;
+	}
+      if (mi_pending_input_length == mi_pending_input_size)
+	{
+	  mi_pending_input_size *= 2;
+	  mi_pending_input = (char *) xrealloc (mi_pending_input,
+						mi_pending_input_size);
+	}
+      mi_pending_input[mi_pending_input_length++] = c;
+      if (c == '\n')
+	length = mi_pending_input_length;
+    }
+
+  line = mi_pending_input_copy_line (mi_pending_input, length);
+  mi_pending_input_remove (0, length);
+  (*input_handler) (line);
+}
+
+/* Return non-zero if LINE, of LENGTH bytes, is a command that should
+   be executed at once while a query runs.  Set *CANCEL if it is
+   -query-cancel.  */
+
+static int
+mi_query_input_p (const char *line, size_t length, int *cancel)
+{
+  static const char *const commands[] = { "exec-interrupt", "query-cancel" };
+  const char *end = line + length;
+  int i;
+
+  while (line < end && isdigit (*line))
+    line++;
+  if (line == end || *line != '-')
+    return 0;
+  line++;
+
+  for (i = 0; i < ARRAY_SIZE (commands); i++)
+    {
+      size_t len = strlen (commands[i]);
+
+      if (end - line >= len
+	  && strncmp (line, commands[i], len) == 0
+	  && (end - line == len || isspace (line[len])))
+	{
+	  *cancel = (i == 1);
+	  return 1;
+	}
+    }
+
+  return 0;
+}
+
+/* The QUIT_POLL_HOOK used while MI is the current interpreter.  While
+   a query command runs, read whatever MI input is available.
+   -exec-interrupt and -query-cancel are executed at once; the latter
+   then aborts the query.  Other commands are kept for when the query
+   is done.  */
+
+static void
+mi_poll_input (void)
+{
+  static int polling;
+  static unsigned int count;
+  struct cleanup *old_chain;
+  fd_set readfds;
+  struct timeval timeout;
+  char buf[4096];
+  ssize_t n;
+
+  if (polling || !mi_query_running_p ())
+    return;
+
+  /* QUIT is called very often; only look at stdin once in a while.  */
+  if (++count % 64 != 0)
+    return;
+
+  /* gdb_readline2 only reads stdin unbuffered when it is not a
+     terminal.  Otherwise, there may be input in the stdio buffer
+     that reading the descriptor would skip.  */
+  if (instream != stdin || input_fd < 0 || ISATTY (instream))
+    return;
+
+  FD_ZERO (&readfds);
+  FD_SET (input_fd, &readfds);
+  timeout.tv_sec = 0;
+  timeout.tv_usec = 0;
+  if (gdb_select (input_fd + 1, &readfds, NULL, NULL, &timeout) <= 0)
+    return;
+
+  n = read (input_fd, buf, sizeof (buf));
+  if (n <= 0)
+    return;
+
+  if (mi_pending_input_length + n > mi_pending_input_size)
+    {
+      mi_pending_input_size = max (mi_pending_input_size * 2,
+				   mi_pending_input_length + n);
+      mi_pending_input = (char *) xrealloc (mi_pending_input,
+					    mi_pending_input_size);
+    }
+  memcpy (mi_pending_input + mi_pending_input_length, buf, n);
+  mi_pending_input_length += n;
+
+  old_chain = make_cleanup_restore_integer (&polling);
+  polling = 1;
+
+  while (mi_pending_input_scanned < mi_pending_input_length)
+    {
+      size_t offset = mi_pending_input_scanned;
+      char *line = mi_pending_input + offset;
+      char *nl = (char *) memchr (line, '\n',
+				  mi_pending_input_length - offset);
+      struct cleanup *cmd_chain;
+      size_t length;
+      int cancel = 0;
+      char *cmd;
+
+      if (nl == NULL)
+	break;
+      length = nl + 1 - line;
+
+      if (!mi_query_input_p (line, length, &cancel))
+	{
+	  mi_pending_input_scanned += length;
+	  continue;
+	}
+
+      cmd = mi_pending_input_copy_line (line, length);
+      cmd_chain = make_cleanup (xfree, cmd);
+      mi_pending_input_remove (offset, length);
+      mi_execute_query_input (cmd);
+      do_cleanups (cmd_chain);
+
+      if (cancel)
+	throw_quit (_("Command cancelled."));
+    }
+
+  do_cleanups (old_chain);
 }
 
 static void
@@ -86,6 +86,9 @@ char *current_token;
    command including all option, and make it possible.  */
 static struct mi_parse *current_context;
 
+/* Non-zero while an MI query command runs.  See struct mi_cmd.  */
+static int mi_query_running;
+
 int running_result_record_printed = 1;
 
 /* Flag indicating that the target has proceeded since the last
@@ -143,6 +146,41 @@ mi_async_p (void)
   return mi_async && target_can_async_p ();
 }
 
+/* Whether MI output is gathered in memory and written a line at a
+   time with a single system call.  See mi_record_file_new.  */
+int mi_output_buffering = 0;
+
+static void
+show_mi_output_buffering (struct ui_file *file, int from_tty,
+			  struct cmd_list_element *c,
+			  const char *value)
+{
+  fprintf_filtered (file,
+		    _("Whether MI output is buffered is %s.\n"),
+		    value);
+}
+
+/* How each line of MI output is framed.  */
+const char mi_output_framing_none[] = "none";
+const char mi_output_framing_length[] = "length";
+static const char *const mi_output_framing_enums[] =
+{
+  mi_output_framing_none,
+  mi_output_framing_length,
+  NULL
+};
+const char *mi_output_framing = mi_output_framing_none;
+
+static void
+show_mi_output_framing (struct ui_file *file, int from_tty,
+			struct cmd_list_element *c,
+			const char *value)
+{
+  fprintf_filtered (file,
+		    _("The framing of MI output lines is \"%s\".\n"),
+		    value);
+}
+
 /* Command implementations.  FIXME: Is this libgdb?  No.  This is the MI
    layer that calls libgdb.  Any operation used in the below should be
    formalized.  */
@@ -1879,6 +1917,7 @@ mi_cmd_list_features (char *command, char **argv, int argc)
       ui_out_field_string (uiout, NULL, "info-gdb-mi-command");
       ui_out_field_string (uiout, NULL, "undefined-command-error-code");
       ui_out_field_string (uiout, NULL, "exec-run-start-option");
+      ui_out_field_string (uiout, NULL, "query-cancel");
 
       if (ext_lang_initialized_p (get_ext_lang_defn (EXT_LANG_PYTHON)))
 	ui_out_field_string (uiout, NULL, "python");
@@ -1935,6 +1974,18 @@ get_other_inferior (struct inferior *inf, void *arg)
   return 1;
 }
 
+/* Implement the "-query-cancel" command.  It is acted on when read
+   while a query command runs, see mi-interp.c:mi_poll_input.  When
+   executed normally, no query is running, so there is nothing to
+   cancel.  */
+
+void
+mi_cmd_query_cancel (char *command, char **argv, int argc)
+{
+  if (argc != 0)
+    error (_("-query-cancel: Usage: -query-cancel"));
+}
+
 void
 mi_cmd_remove_inferior (char *command, char **argv, int argc)
 {
@@ -2193,6 +2244,51 @@ mi_execute_command (const char *cmd, int from_tty)
     }
 }
 
+/* See mi-main.h.  */
+
+int
+mi_query_running_p (void)
+{
+  return mi_query_running;
+}
+
+/* See mi-main.h.  */
+
+void
+mi_execute_query_input (const char *cmd)
+{
+  struct cleanup *old_chain;
+  struct ui_out *saved_uiout = current_uiout;
+  struct ui_out *uiout = mi_out_new (mi_version (saved_uiout));
+  char *saved_token = current_token;
+  struct mi_parse *saved_context = current_context;
+  struct mi_timestamp *saved_ts = current_command_ts;
+  int saved_running_result_record_printed = running_result_record_printed;
+  int saved_mi_proceeded = mi_proceeded;
+
+  old_chain = make_cleanup_restore_current_thread ();
+  make_cleanup_restore_integer (&mi_query_running);
+  mi_query_running = 0;
+
+  /* The command's output goes to its own ui_out, so that it does not
+     mix with the partial output of the query.  */
+  current_uiout = uiout;
+  current_token = NULL;
+
+  mi_execute_command (cmd, 0);
+  fputs_unfiltered ("(gdb) \n", raw_stdout);
+  gdb_flush (raw_stdout);
+
+  current_uiout = saved_uiout;
+  ui_out_destroy (uiout);
+  current_token = saved_token;
+  current_context = saved_context;
+  current_command_ts = saved_ts;
+  running_result_record_printed = saved_running_result_record_printed;
+  mi_proceeded = saved_mi_proceeded;
+  do_cleanups (old_chain);
+}
+
 static void
 mi_cmd_execute (struct mi_parse *parse)
 {
@@ -2273,6 +2369,12 @@ mi_cmd_execute (struct mi_parse *parse)
       *parse->cmd->suppress_notification = 1;
     }
 
+  if (parse->cmd->query)
+    {
+      make_cleanup_restore_integer (&mi_query_running);
+      mi_query_running = 1;
+    }
+
   if (parse->cmd->argv_func != NULL)
     {
       parse->cmd->argv_func (parse->command, parse->argv, parse->argc);
@@ -3002,6 +3104,31 @@ Tells GDB whether MI should be in asynchronous mode."),
 			   &setlist,
 			   &showlist);
 
+  add_setshow_boolean_cmd ("mi-output-buffering", class_support,
+			   &mi_output_buffering, _("\
+Set whether MI output is buffered."), _("\
+Show whether MI output is buffered."), _("\
+When on, GDB gathers each line of MI output in memory and writes it\n\
+to its standard output with a single system call, instead of through\n\
+the many small writes made while the record is formatted."),
+			   NULL,
+			   show_mi_output_buffering,
+			   &setlist,
+			   &showlist);
+
+  add_setshow_enum_cmd ("mi-output-framing", class_support,
+			mi_output_framing_enums, &mi_output_framing, _("\
+Set the framing of MI output lines."), _("\
+Show the framing of MI output lines."), _("\
+none    Lines of MI output are written as they are.\n\
+length  Each line of MI output, including its terminating newline, is\n\
+        preceded by its length in bytes, written in decimal and\n\
+        followed by a colon.  This implies \"set mi-output-buffering on\"."),
+			NULL,
+			show_mi_output_framing,
+			&setlist,
+			&showlist);
+
   /* Alias old "target-async" to "mi-async".  */
   c = add_alias_cmd ("target-async", "mi-async", class_run, 0, &setlist);
   deprecate_cmd (c, "set mi-async");
@@ -32,6 +32,23 @@ extern void mi_print_timing_maybe (void);
 
 extern int mi_async_p (void);
 
+/* The "set mi-output-buffering" and "set mi-output-framing"
+   settings.  */
+
+extern int mi_output_buffering;
+extern const char mi_output_framing_none[];
+extern const char mi_output_framing_length[];
+extern const char *mi_output_framing;
+
+/* Return non-zero while an MI query command runs.  */
+
+extern int mi_query_running_p (void);
+
+/* Execute the MI command CMD, read while a query command was running,
+   without disturbing the query's state or output.  */
+
+extern void mi_execute_query_input (const char *cmd);
+
 extern char *current_token;
 
 extern int running_result_record_printed;
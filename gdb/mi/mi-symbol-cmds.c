@@ -55,6 +55,7 @@ mi_cmd_symbol_list_lines (char *command, char **argv, int argc)
   if (SYMTAB_LINETABLE (s) != NULL && SYMTAB_LINETABLE (s)->nitems > 0)
     for (i = 0; i < SYMTAB_LINETABLE (s)->nitems; i++)
     {
+      QUIT;
       cleanup_tuple = make_cleanup_ui_out_tuple_begin_end (uiout, NULL);
       ui_out_field_core_addr (uiout, "pc", gdbarch,
 			      SYMTAB_LINETABLE (s)->item[i].pc);
@@ -51,6 +51,7 @@
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "symbol.h"
+#include "trigram.h"
 
 /* Accumulate the minimal symbols for each objfile in bunches of BUNCH_SIZE.
    At the end, copy them all into one newly allocated location on an objfile's
@@ -1328,6 +1329,8 @@ install_minimal_symbols (struct objfile *objfile)
 
       objfile->per_bfd->minimal_symbol_count = mcount;
       objfile->per_bfd->msymbols = msymbols;
+      trigram_index_free (objfile->per_bfd->msymbol_trigrams);
+      objfile->per_bfd->msymbol_trigrams = NULL;
 
       /* Now build the hash tables; we can't do this incrementally
          at an earlier point since we weren't finished with the obstack
@@ -1474,3 +1477,30 @@ minimal_symbol_upper_bound (struct bound_minimal_symbol minsym)
 
   return result;
 }
+
+/* See minsyms.h.  */
+
+int
+minimal_symbol_trigram_candidates (struct objfile *objf,
+				   const struct trigram_query *query,
+				   VEC (int) **ids)
+{
+  struct objfile_per_bfd_storage *per_bfd = objf->per_bfd;
+
+  if (query == NULL)
+    return 0;
+
+  if (per_bfd->msymbol_trigrams == NULL)
+    {
+      struct trigram_index_builder *builder = trigram_index_builder_new ();
+      int i;
+
+      for (i = 0; i < per_bfd->minimal_symbol_count; i++)
+	trigram_index_builder_add (builder, i,
+				   MSYMBOL_NATURAL_NAME (&per_bfd->msymbols[i]));
+      per_bfd->msymbol_trigrams = trigram_index_builder_finish (builder);
+    }
+
+  trigram_index_lookup (per_bfd->msymbol_trigrams, query, ids);
+  return 1;
+}
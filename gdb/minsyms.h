@@ -20,6 +20,8 @@
 #ifndef MINSYMS_H
 #define MINSYMS_H
 
+struct trigram_query;
+
 /* Several lookup functions return both a minimal symbol and the
    objfile in which it is found.  This structure is used in these
    cases.  */
@@ -252,4 +254,14 @@ void iterate_over_minimal_symbols (struct objfile *objf,
 
 CORE_ADDR minimal_symbol_upper_bound (struct bound_minimal_symbol minsym);
 
+/* If QUERY is not NULL, store in *IDS the indexes in the minimal
+   symbol table of OBJF of the minimal symbols whose natural names may
+   contain all the trigrams of QUERY, in increasing order, and return
+   non-zero.  Otherwise return zero: all the minimal symbols have to be
+   considered.  */
+
+int minimal_symbol_trigram_candidates (struct objfile *objf,
+				       const struct trigram_query *query,
+				       VEC (int) **ids);
+
 #endif /* MINSYMS_H */
@@ -52,6 +52,7 @@
 #include "solist.h"
 #include "gdb_bfd.h"
 #include "btrace.h"
+#include "trigram.h"
 
 /* Keep a registry of per-objfile data-pointers required by other GDB
    modules.  */
@@ -75,6 +76,9 @@ struct objfile_pspace_info
 
   /* Nonzero if section map updates should be inhibited if possible.  */
   int inhibit_updates;
+
+  /* Incremented whenever an objfile is added, removed or relocated.  */
+  unsigned int generation;
 };
 
 /* Per-program-space data key.  */
@@ -169,6 +173,7 @@ free_objfile_per_bfd_storage (struct objfile_per_bfd_storage *storage)
   bcache_xfree (storage->macro_cache);
   if (storage->demangled_names_hash)
     htab_delete (storage->demangled_names_hash);
+  trigram_index_free (storage->msymbol_trigrams);
   obstack_free (&storage->storage_obstack, 0);
 }
 
@@ -450,6 +455,7 @@ allocate_objfile (bfd *abfd, const char *name, int flags)
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->new_objfiles_available = 1;
+  get_objfile_pspace_data (objfile->pspace)->generation++;
 
   return objfile;
 }
@@ -738,12 +744,14 @@ free_objfile (struct objfile *objfile)
     xfree (objfile->global_psymbols.list);
   if (objfile->static_psymbols.list)
     xfree (objfile->static_psymbols.list);
+  trigram_index_free (objfile->psymtab_trigrams);
   /* Free the obstacks for non-reusable objfiles.  */
   psymbol_bcache_free (objfile->psymbol_cache);
   obstack_free (&objfile->objfile_obstack, 0);
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  get_objfile_pspace_data (objfile->pspace)->generation++;
 
   /* Free the map for static links.  There's no need to free static link
      themselves since they were allocated on the objstack.  */
@@ -884,10 +892,10 @@ objfile_relocate1 (struct objfile *objfile,
 
   /* Relocate isolated symbols.  */
   {
-    struct symbol *iter;
+    struct template_symbol_list *iter;
 
-    for (iter = objfile->template_symbols; iter; iter = iter->hash_next)
-      relocate_one_symbol (iter, objfile, delta);
+    for (iter = objfile->template_symbols; iter; iter = iter->next)
+      relocate_one_symbol (iter->symbol, objfile, delta);
   }
 
   if (objfile->psymtabs_addrmap)
@@ -906,6 +914,7 @@ objfile_relocate1 (struct objfile *objfile,
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  get_objfile_pspace_data (objfile->pspace)->generation++;
 
   /* Update the table in exec_ops, used to read memory.  */
   ALL_OBJFILE_OSECTIONS (objfile, s)
@@ -1501,6 +1510,15 @@ objfiles_changed (void)
 {
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->section_map_dirty = 1;
+  get_objfile_pspace_data (current_program_space)->generation++;
+}
+
+/* See comments in objfiles.h.  */
+
+unsigned int
+objfiles_generation (struct program_space *pspace)
+{
+  return get_objfile_pspace_data (pspace)->generation;
 }
 
 /* See comments in objfiles.h.  */
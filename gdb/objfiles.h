@@ -30,6 +30,7 @@
 struct bcache;
 struct htab;
 struct objfile_data;
+struct trigram_index;
 
 /* This structure maintains information on a per-objfile basis about the
    "entry point" of the objfile, and the scope within which the entry point
@@ -260,6 +261,20 @@ struct objfile_per_bfd_storage
      demangled names.  */
 
   struct minimal_symbol *msymbol_demangled_hash[MINIMAL_SYMBOL_HASH_SIZE];
+
+  /* A trigram index of the natural names of the minimal symbols, built
+     the first time a symbol search needs it, or NULL.  */
+
+  struct trigram_index *msymbol_trigrams;
+};
+
+/* A node of the list of the symbols of an objfile that are not in any
+   symbol table.  The nodes are allocated on the objfile's obstack.  */
+
+struct template_symbol_list
+{
+  struct symbol *symbol;
+  struct template_symbol_list *next;
 };
 
 /* Master structure for keeping track of each file from which
@@ -315,6 +330,15 @@ struct objfile
 
   struct addrmap *psymtabs_addrmap;
 
+  /* A trigram index of the names of the partial symbols of each
+     partial symtab, built the first time a symbol search needs it, or
+     NULL.  Partial symtabs are numbered in the order of PSYMTABS;
+     PSYMTAB_TRIGRAMS_COUNT is the number of them when the index was
+     built.  */
+
+  struct trigram_index *psymtab_trigrams;
+  int psymtab_trigrams_count;
+
   /* List of freed partial symtabs, available for re-use.  */
 
   struct partial_symtab *free_psymtabs;
@@ -428,7 +452,7 @@ struct objfile
      table, so we have to keep them here to relocate them
      properly.  */
 
-  struct symbol *template_symbols;
+  struct template_symbol_list *template_symbols;
 
   /* Associate a static link (struct dynamic_prop *) to all blocks (struct
      block *) that have one.
@@ -538,6 +562,12 @@ extern void objfile_set_sym_fns (struct objfile *objfile,
 
 extern void objfiles_changed (void);
 
+/* Return a number which changes whenever an objfile of PSPACE is
+   added, removed or relocated.  Maps of the addresses of the objfiles
+   must be rebuilt when it changes.  */
+
+extern unsigned int objfiles_generation (struct program_space *pspace);
+
 extern int is_addr_in_objfile (CORE_ADDR addr, const struct objfile *objfile);
 
 /* Return true if ADDRESS maps into one of the sections of a
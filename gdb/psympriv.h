@@ -32,13 +32,27 @@ struct psymbol_allocation_list;
    normal symtab once the partial_symtab has been referenced.  */
 
 /* This structure is space critical.  See space comments at the top of
-   symtab.h.  */
+   symtab.h.  Rather than a general_symbol_info, it holds the offset of
+   the names of the symbol in the string table of the psymbol_cache of
+   its objfile, where they are interned, and only the address among
+   the possible values of a symbol.  */
 
 struct partial_symbol
 {
-  /* The general symbol info required for all types of symbols.  */
+  /* The address of the symbol, for the address classes that have one,
+     zero otherwise.  */
 
-  struct general_symbol_info ginfo;
+  CORE_ADDR address;
+
+  /* The offset of the names of the symbol in the string table of the
+     psymbol_cache of its objfile.  Use psymbol_search_name and
+     friends to get the names.  */
+
+  unsigned int name;
+
+  /* The language of the symbol.  */
+
+  ENUM_BITFIELD(language) language : LANGUAGE_BITS;
 
   /* Name space code.  */
 
@@ -49,10 +63,41 @@ struct partial_symbol
      no need.  */
 
   ENUM_BITFIELD(address_class) aclass : SYMBOL_ACLASS_BITS;
+
+  /* The index of the section of the symbol in the section table of
+     its objfile, or -1 if it is not known yet.  */
+
+  short section;
 };
 
-#define PSYMBOL_DOMAIN(psymbol)	(psymbol)->domain
+#define PSYMBOL_VALUE_ADDRESS(psymbol)	(psymbol)->address
+#define PSYMBOL_LANGUAGE(psymbol)	(psymbol)->language
+#define PSYMBOL_DOMAIN(psymbol)		(psymbol)->domain
 #define PSYMBOL_CLASS(psymbol)		(psymbol)->aclass
+#define PSYMBOL_SECTION(psymbol)	(psymbol)->section
+#define PSYMBOL_OBJ_SECTION(objfile, psymbol)			\
+  (((psymbol)->section >= 0)					\
+   ? (&(((objfile)->sections)[(psymbol)->section]))		\
+   : NULL)
+
+/* Return the name of PSYM, a partial symbol of OBJFILE, used to search
+   for it, like SYMBOL_SEARCH_NAME.  */
+
+extern const char *psymbol_search_name (struct objfile *objfile,
+					const struct partial_symbol *psym);
+
+/* Return the linkage name of PSYM, a partial symbol of OBJFILE, like
+   SYMBOL_LINKAGE_NAME.  */
+
+extern const char *psymbol_linkage_name (struct objfile *objfile,
+					 const struct partial_symbol *psym);
+
+/* Return the demangled name of PSYM, a partial symbol of OBJFILE, or
+   NULL if it has none.  Unlike SYMBOL_DEMANGLED_NAME, this does not
+   decode the names of Ada symbols.  */
+
+extern const char *psymbol_demangled_name (struct objfile *objfile,
+					   const struct partial_symbol *psym);
 
 /* A convenience enum to give names to some constants used when
    searching psymtabs.  This is internal to psymtab and should not be
@@ -193,6 +238,15 @@ struct partial_symtab
 
   void (*read_symtab) (struct partial_symtab *, struct objfile *);
 
+  /* Optional function called before reading in, in turn, the COUNT
+     psymtabs PSTS, which all have this same function.  It may prepare
+     the reading of the first ones, e.g. by reading their debug info
+     in parallel, and returns how many of them it prepared; it is
+     called again for the rest once those are read in.  */
+
+  int (*prepare_read_symtabs) (struct partial_symtab **psts, int count,
+			       struct objfile *objfile);
+
   /* Information that lets read_symtab() locate the part of the symbol table
      that this psymtab corresponds to.  This information is private to the
      format-dependent symbol reading routines.  For further detail examine
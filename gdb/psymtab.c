@@ -35,14 +35,70 @@
 #include "language.h"
 #include "cp-support.h"
 #include "gdbcmd.h"
+#include "trigram.h"
+#include "value.h"
 
 #ifndef DEV_TTY
 #define DEV_TTY "/dev/tty"
 #endif
 
+/* The names of partial symbols are interned in a string table, so
+   that partial symbols can refer to them by a 32-bit offset.  The
+   table is made of chunks of PSYMBOL_NAMES_CHUNK_SIZE bytes, which
+   never move once allocated: offset O is at byte O modulo the chunk
+   size of chunk O divided by the chunk size.  The first chunks are
+   only partly allocated, and an entry too large for a chunk gets an
+   allocation spanning several consecutive chunks.
+
+   Each entry holds, in order:
+
+   - the offset of the entry, in host byte order, on 4 bytes;
+   - the language the symbols were added with, on a byte;
+   - a byte of flags: PSYMBOL_NAME_HAS_LINKAGE_NAME, ORed with the
+     language of the symbols, which demangling may have determined,
+     shifted by PSYMBOL_NAME_LANGUAGE_SHIFT;
+   - the search name of the symbols, NUL-terminated;
+   - if PSYMBOL_NAME_HAS_LINKAGE_NAME is set, their linkage name,
+     NUL-terminated.  Otherwise, the linkage name is the search name.
+
+   The offset of an entry, used by partial symbols, is that of its
+   search name.  */
+
+#define PSYMBOL_NAMES_CHUNK_BITS 16
+#define PSYMBOL_NAMES_CHUNK_SIZE (1 << PSYMBOL_NAMES_CHUNK_BITS)
+#define PSYMBOL_NAMES_MAX_SIZE ((ULONGEST) 1 << 32)
+#define PSYMBOL_NAMES_MIN_ALLOC 4096
+
+#define PSYMBOL_NAME_HEADER_SIZE 6
+#define PSYMBOL_NAME_HAS_LINKAGE_NAME 1
+#define PSYMBOL_NAME_LANGUAGE_SHIFT 1
+
 struct psymbol_bcache
 {
   struct bcache *bcache;
+
+  /* The chunks of the string table of names.  */
+  char **name_chunks;
+
+  /* The number of chunks used, and the number allocated in
+     NAME_CHUNKS.  */
+  unsigned int n_name_chunks;
+  unsigned int name_chunks_size;
+
+  /* The offset of the first unused byte of the string table, and the
+     end of the last allocation.  */
+  ULONGEST names_used;
+  ULONGEST names_end;
+
+  /* The number of bytes allocated for the string table.  */
+  ULONGEST names_allocated;
+
+  /* The memory allocated for the chunks, to free them.  */
+  VEC (char_ptr) *name_blocks;
+
+  /* The entries of the string table, hashed by linkage name and
+     language.  */
+  htab_t names;
 };
 
 static struct partial_symbol *match_partial_symbol (struct objfile *,
@@ -265,7 +321,7 @@ find_pc_sect_psymtab_closer (struct objfile *objfile,
 	     object's symbol table.  */
 	  p = find_pc_sect_psymbol (objfile, tpst, pc, section);
 	  if (p != NULL
-	      && (SYMBOL_VALUE_ADDRESS (p)
+	      && (PSYMBOL_VALUE_ADDRESS (p)
 		  == BMSYMBOL_VALUE_ADDRESS (msymbol)))
 	    return tpst;
 
@@ -274,7 +330,7 @@ find_pc_sect_psymtab_closer (struct objfile *objfile,
 	     symbol tables with line information but no debug
 	     symbols (e.g. those produced by an assembler).  */
 	  if (p != NULL)
-	    this_addr = SYMBOL_VALUE_ADDRESS (p);
+	    this_addr = PSYMBOL_VALUE_ADDRESS (p);
 	  else
 	    this_addr = tpst->textlow;
 
@@ -332,7 +388,7 @@ find_pc_sect_psymtab (struct objfile *objfile, CORE_ADDR pc,
 		 object's symbol table.  */
 	      p = find_pc_sect_psymbol (objfile, pst, pc, section);
 	      if (p == NULL
-		  || (SYMBOL_VALUE_ADDRESS (p)
+		  || (PSYMBOL_VALUE_ADDRESS (p)
 		      != BMSYMBOL_VALUE_ADDRESS (msymbol)))
 		goto next;
 	    }
@@ -425,21 +481,21 @@ find_pc_sect_psymbol (struct objfile *objfile,
        pp++)
     {
       p = *pp;
-      if (SYMBOL_DOMAIN (p) == VAR_DOMAIN
+      if (PSYMBOL_DOMAIN (p) == VAR_DOMAIN
 	  && PSYMBOL_CLASS (p) == LOC_BLOCK
-	  && pc >= SYMBOL_VALUE_ADDRESS (p)
-	  && (SYMBOL_VALUE_ADDRESS (p) > best_pc
+	  && pc >= PSYMBOL_VALUE_ADDRESS (p)
+	  && (PSYMBOL_VALUE_ADDRESS (p) > best_pc
 	      || (psymtab->textlow == 0
-		  && best_pc == 0 && SYMBOL_VALUE_ADDRESS (p) == 0)))
+		  && best_pc == 0 && PSYMBOL_VALUE_ADDRESS (p) == 0)))
 	{
 	  if (section != NULL)  /* Match on a specific section.  */
 	    {
 	      fixup_psymbol_section (p, objfile);
-	      if (!matching_obj_sections (SYMBOL_OBJ_SECTION (objfile, p),
+	      if (!matching_obj_sections (PSYMBOL_OBJ_SECTION (objfile, p),
 					  section))
 		continue;
 	    }
-	  best_pc = SYMBOL_VALUE_ADDRESS (p);
+	  best_pc = PSYMBOL_VALUE_ADDRESS (p);
 	  best = p;
 	}
     }
@@ -450,21 +506,21 @@ find_pc_sect_psymbol (struct objfile *objfile,
        pp++)
     {
       p = *pp;
-      if (SYMBOL_DOMAIN (p) == VAR_DOMAIN
+      if (PSYMBOL_DOMAIN (p) == VAR_DOMAIN
 	  && PSYMBOL_CLASS (p) == LOC_BLOCK
-	  && pc >= SYMBOL_VALUE_ADDRESS (p)
-	  && (SYMBOL_VALUE_ADDRESS (p) > best_pc
+	  && pc >= PSYMBOL_VALUE_ADDRESS (p)
+	  && (PSYMBOL_VALUE_ADDRESS (p) > best_pc
 	      || (psymtab->textlow == 0
-		  && best_pc == 0 && SYMBOL_VALUE_ADDRESS (p) == 0)))
+		  && best_pc == 0 && PSYMBOL_VALUE_ADDRESS (p) == 0)))
 	{
 	  if (section != NULL)  /* Match on a specific section.  */
 	    {
 	      fixup_psymbol_section (p, objfile);
-	      if (!matching_obj_sections (SYMBOL_OBJ_SECTION (objfile, p),
+	      if (!matching_obj_sections (PSYMBOL_OBJ_SECTION (objfile, p),
 					  section))
 		continue;
 	    }
-	  best_pc = SYMBOL_VALUE_ADDRESS (p);
+	  best_pc = PSYMBOL_VALUE_ADDRESS (p);
 	  best = p;
 	}
     }
@@ -475,12 +531,13 @@ find_pc_sect_psymbol (struct objfile *objfile,
 static void
 fixup_psymbol_section (struct partial_symbol *psym, struct objfile *objfile)
 {
+  struct general_symbol_info ginfo;
   CORE_ADDR addr;
 
   if (psym == NULL)
     return;
 
-  if (SYMBOL_SECTION (psym) >= 0)
+  if (PSYMBOL_SECTION (psym) >= 0)
     return;
 
   gdb_assert (objfile);
@@ -490,7 +547,7 @@ fixup_psymbol_section (struct partial_symbol *psym, struct objfile *objfile)
     case LOC_STATIC:
     case LOC_LABEL:
     case LOC_BLOCK:
-      addr = SYMBOL_VALUE_ADDRESS (psym);
+      addr = PSYMBOL_VALUE_ADDRESS (psym);
       break;
     default:
       /* Nothing else will be listed in the minsyms -- no use looking
@@ -498,7 +555,14 @@ fixup_psymbol_section (struct partial_symbol *psym, struct objfile *objfile)
       return;
     }
 
-  fixup_section (&psym->ginfo, addr, objfile);
+  /* fixup_section looks up the minimal symbol of the partial symbol
+     by its linkage name.  */
+  memset (&ginfo, 0, sizeof (ginfo));
+  ginfo.name = psymbol_linkage_name (objfile, psym);
+  ginfo.language = PSYMBOL_LANGUAGE (psym);
+  ginfo.section = -1;
+  fixup_section (&ginfo, addr, objfile);
+  PSYMBOL_SECTION (psym) = ginfo.section;
 }
 
 /* Psymtab version of lookup_symbol.  See its definition in
@@ -592,9 +656,9 @@ match_partial_symbol (struct objfile *objfile,
 	  center = bottom + (top - bottom) / 2;
 	  gdb_assert (center < top);
 	  if (!do_linear_search
-	      && (SYMBOL_LANGUAGE (*center) == language_java))
+	      && (PSYMBOL_LANGUAGE (*center) == language_java))
 	    do_linear_search = 1;
-	  if (ordered_compare (SYMBOL_SEARCH_NAME (*center), name) >= 0)
+	  if (ordered_compare (psymbol_search_name (objfile, *center), name) >= 0)
 	    top = center;
 	  else
 	    bottom = center + 1;
@@ -602,10 +666,10 @@ match_partial_symbol (struct objfile *objfile,
       gdb_assert (top == bottom);
 
       while (top <= real_top
-	     && match (SYMBOL_SEARCH_NAME (*top), name) == 0)
+	     && match (psymbol_search_name (objfile, *top), name) == 0)
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*top),
-				     SYMBOL_DOMAIN (*top), domain))
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*top),
+				     PSYMBOL_DOMAIN (*top), domain))
 	    return *top;
 	  top++;
 	}
@@ -618,9 +682,9 @@ match_partial_symbol (struct objfile *objfile,
     {
       for (psym = start; psym < start + length; psym++)
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*psym),
-				     SYMBOL_DOMAIN (*psym), domain)
-	      && match (SYMBOL_SEARCH_NAME (*psym), name) == 0)
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*psym),
+				     PSYMBOL_DOMAIN (*psym), domain)
+	      && match (psymbol_search_name (objfile, *psym), name) == 0)
 	    return *psym;
 	}
     }
@@ -705,11 +769,11 @@ lookup_partial_symbol (struct objfile *objfile,
 	    internal_error (__FILE__, __LINE__,
 			    _("failed internal consistency check"));
 	  if (!do_linear_search
-	      && SYMBOL_LANGUAGE (*center) == language_java)
+	      && PSYMBOL_LANGUAGE (*center) == language_java)
 	    {
 	      do_linear_search = 1;
 	    }
-	  if (strcmp_iw_ordered (SYMBOL_SEARCH_NAME (*center),
+	  if (strcmp_iw_ordered (psymbol_search_name (objfile, *center),
 				 search_name) >= 0)
 	    {
 	      top = center;
@@ -725,16 +789,20 @@ lookup_partial_symbol (struct objfile *objfile,
 
       /* For `case_sensitivity == case_sensitive_off' strcmp_iw_ordered will
 	 search more exactly than what matches SYMBOL_MATCHES_SEARCH_NAME.  */
-      while (top >= start && SYMBOL_MATCHES_SEARCH_NAME (*top, search_name))
+      while (top >= start
+	     && strcmp_iw (psymbol_search_name (objfile, *top),
+			   search_name) == 0)
 	top--;
 
       /* Fixup to have a symbol which matches SYMBOL_MATCHES_SEARCH_NAME.  */
       top++;
 
-      while (top <= real_top && SYMBOL_MATCHES_SEARCH_NAME (*top, search_name))
+      while (top <= real_top
+	     && strcmp_iw (psymbol_search_name (objfile, *top),
+			   search_name) == 0)
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*top),
-				     SYMBOL_DOMAIN (*top), domain))
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*top),
+				     PSYMBOL_DOMAIN (*top), domain))
 	    {
 	      do_cleanups (cleanup);
 	      return *top;
@@ -750,9 +818,9 @@ lookup_partial_symbol (struct objfile *objfile,
     {
       for (psym = start; psym < start + length; psym++)
 	{
-	  if (symbol_matches_domain (SYMBOL_LANGUAGE (*psym),
-				     SYMBOL_DOMAIN (*psym), domain)
-	      && SYMBOL_MATCHES_SEARCH_NAME (*psym, search_name))
+	  if (symbol_matches_domain (PSYMBOL_LANGUAGE (*psym),
+				     PSYMBOL_DOMAIN (*psym), domain)
+	      && strcmp_iw (psymbol_search_name (objfile, *psym), search_name) == 0)
 	    {
 	      do_cleanups (cleanup);
 	      return *psym;
@@ -794,6 +862,47 @@ psymtab_to_symtab (struct objfile *objfile, struct partial_symtab *pst)
   return pst->compunit_symtab;
 }
 
+/* Read in the COUNT psymtabs PSTS of OBJFILE in order, skipping the
+   ones already read in by then, and letting their
+   prepare_read_symtabs functions prepare several of them at once.
+   If EXPANSION_NOTIFY is not NULL, call it with DATA for each psymtab
+   read in.  */
+
+static void
+psymtabs_to_symtabs (struct objfile *objfile,
+		     struct partial_symtab **psts, int count,
+		     expand_symtabs_exp_notify_ftype *expansion_notify,
+		     void *data)
+{
+  int i, prepared = 0;
+
+  for (i = 0; i < count; ++i)
+    {
+      struct partial_symtab *ps = psts[i];
+      struct compunit_symtab *symtab;
+
+      QUIT;
+
+      if (ps->readin)
+	continue;
+
+      if (i >= prepared && ps->prepare_read_symtabs != NULL)
+	{
+	  int n = 1;
+
+	  while (i + n < count
+		 && psts[i + n]->prepare_read_symtabs == ps->prepare_read_symtabs)
+	    ++n;
+	  prepared = i + max (1, ps->prepare_read_symtabs (psts + i, n,
+							    objfile));
+	}
+
+      symtab = psymtab_to_symtab (objfile, ps);
+      if (expansion_notify != NULL)
+	expansion_notify (symtab, data);
+    }
+}
+
 /* Psymtab version of relocate.  See its definition in
    the definition of quick_symbol_functions in symfile.h.  */
 
@@ -816,18 +925,18 @@ psym_relocate (struct objfile *objfile,
        psym++)
     {
       fixup_psymbol_section (*psym, objfile);
-      if (SYMBOL_SECTION (*psym) >= 0)
-	SYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
-						  SYMBOL_SECTION (*psym));
+      if (PSYMBOL_SECTION (*psym) >= 0)
+	PSYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
+						  PSYMBOL_SECTION (*psym));
     }
   for (psym = objfile->static_psymbols.list;
        psym < objfile->static_psymbols.next;
        psym++)
     {
       fixup_psymbol_section (*psym, objfile);
-      if (SYMBOL_SECTION (*psym) >= 0)
-	SYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
-						  SYMBOL_SECTION (*psym));
+      if (PSYMBOL_SECTION (*psym) >= 0)
+	PSYMBOL_VALUE_ADDRESS (*psym) += ANOFFSET (delta,
+						  PSYMBOL_SECTION (*psym));
     }
 }
 
@@ -889,7 +998,7 @@ psym_forget_cached_source_info (struct objfile *objfile)
 }
 
 static void
-print_partial_symbols (struct gdbarch *gdbarch,
+print_partial_symbols (struct gdbarch *gdbarch, struct objfile *objfile,
 		       struct partial_symbol **p, int count, char *what,
 		       struct ui_file *outfile)
 {
@@ -897,13 +1006,15 @@ print_partial_symbols (struct gdbarch *gdbarch,
   while (count-- > 0)
     {
       QUIT;
-      fprintf_filtered (outfile, "    `%s'", SYMBOL_LINKAGE_NAME (*p));
-      if (SYMBOL_DEMANGLED_NAME (*p) != NULL)
+      fprintf_filtered (outfile, "    `%s'",
+			psymbol_linkage_name (objfile, *p));
+      if (psymbol_demangled_name (objfile, *p) != NULL)
 	{
-	  fprintf_filtered (outfile, "  `%s'", SYMBOL_DEMANGLED_NAME (*p));
+	  fprintf_filtered (outfile, "  `%s'",
+			    psymbol_demangled_name (objfile, *p));
 	}
       fputs_filtered (", ", outfile);
-      switch (SYMBOL_DOMAIN (*p))
+      switch (PSYMBOL_DOMAIN (*p))
 	{
 	case UNDEF_DOMAIN:
 	  fputs_filtered ("undefined domain, ", outfile);
@@ -973,7 +1084,7 @@ print_partial_symbols (struct gdbarch *gdbarch,
 	  break;
 	}
       fputs_filtered (", ", outfile);
-      fputs_filtered (paddress (gdbarch, SYMBOL_VALUE_ADDRESS (*p)), outfile);
+      fputs_filtered (paddress (gdbarch, PSYMBOL_VALUE_ADDRESS (*p)), outfile);
       fprintf_filtered (outfile, "\n");
       p++;
     }
@@ -1038,14 +1149,14 @@ dump_psymtab (struct objfile *objfile, struct partial_symtab *psymtab,
     }
   if (psymtab->n_global_syms > 0)
     {
-      print_partial_symbols (gdbarch,
+      print_partial_symbols (gdbarch, objfile,
 			     objfile->global_psymbols.list
 			     + psymtab->globals_offset,
 			     psymtab->n_global_syms, "Global", outfile);
     }
   if (psymtab->n_static_syms > 0)
     {
-      print_partial_symbols (gdbarch,
+      print_partial_symbols (gdbarch, objfile,
 			     objfile->static_psymbols.list
 			     + psymtab->statics_offset,
 			     psymtab->n_static_syms, "Static", outfile);
@@ -1125,11 +1236,21 @@ static void
 psym_expand_all_symtabs (struct objfile *objfile)
 {
   struct partial_symtab *psymtab;
+  struct partial_symtab **psts;
+  struct cleanup *cleanup;
+  int count = 0;
 
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, psymtab)
-    {
-      psymtab_to_symtab (objfile, psymtab);
-    }
+    ++count;
+
+  psts = XNEWVEC (struct partial_symtab *, count);
+  cleanup = make_cleanup (xfree, psts);
+  count = 0;
+  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, psymtab)
+    psts[count++] = psymtab;
+
+  psymtabs_to_symtabs (objfile, psts, count, NULL, NULL);
+  do_cleanups (cleanup);
 }
 
 /* Psymtab version of expand_symtabs_with_fullname.  See its definition in
@@ -1377,7 +1498,7 @@ recursively_search_psymtabs (struct partial_symtab *ps,
 		   && PSYMBOL_CLASS (*psym) == LOC_BLOCK)
 	       || (kind == TYPES_DOMAIN
 		   && PSYMBOL_CLASS (*psym) == LOC_TYPEDEF))
-	      && (*sym_matcher) (SYMBOL_SEARCH_NAME (*psym), data))
+	      && (*sym_matcher) (psymbol_search_name (objfile, *psym), data))
 	    {
 	      /* Found a match, so notify our caller.  */
 	      result = PST_SEARCHED_AND_FOUND;
@@ -1391,6 +1512,95 @@ recursively_search_psymtabs (struct partial_symtab *ps,
   return result == PST_SEARCHED_AND_FOUND;
 }
 
+/* Return the trigram index of the names of the partial symbols of each
+   psymtab of OBJFILE, building it if needed.  */
+
+static const struct trigram_index *
+psymtab_trigram_index (struct objfile *objfile)
+{
+  struct trigram_index_builder *builder;
+  struct partial_symtab *ps;
+  int count = 0;
+
+  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+    count++;
+
+  if (objfile->psymtab_trigrams != NULL
+      && objfile->psymtab_trigrams_count == count)
+    return objfile->psymtab_trigrams;
+
+  trigram_index_free (objfile->psymtab_trigrams);
+  objfile->psymtab_trigrams = NULL;
+
+  builder = trigram_index_builder_new ();
+  count = 0;
+  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+    {
+      struct partial_symbol **psym, **bound;
+
+      psym = objfile->global_psymbols.list + ps->globals_offset;
+      bound = psym + ps->n_global_syms;
+      for (; psym < bound; psym++)
+	trigram_index_builder_add (builder, count,
+				   psymbol_search_name (objfile, *psym));
+
+      psym = objfile->static_psymbols.list + ps->statics_offset;
+      bound = psym + ps->n_static_syms;
+      for (; psym < bound; psym++)
+	trigram_index_builder_add (builder, count,
+				   psymbol_search_name (objfile, *psym));
+
+      count++;
+    }
+
+  objfile->psymtab_trigrams = trigram_index_builder_finish (builder);
+  objfile->psymtab_trigrams_count = count;
+  return objfile->psymtab_trigrams;
+}
+
+/* Mark the psymtabs of OBJFILE that have no partial symbol whose name
+   contains all the trigrams of QUERY as searched, so that
+   psym_expand_symtabs_matching skips them.  */
+
+static void
+psymtab_skip_by_trigrams (struct objfile *objfile,
+			  const struct trigram_query *query)
+{
+  const struct trigram_index *index = psymtab_trigram_index (objfile);
+  VEC (int) *ids = NULL;
+  struct cleanup *cleanup = make_cleanup (VEC_cleanup (int), &ids);
+  struct partial_symtab *ps;
+  int count = 0, next = 0;
+
+  trigram_index_lookup (index, query, &ids);
+
+  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+    {
+      int i, candidate;
+
+      candidate = (next < VEC_length (int, ids)
+		   && VEC_index (int, ids, next) == count);
+      if (candidate)
+	next++;
+      count++;
+
+      if (candidate)
+	continue;
+
+      /* The shared psymtabs included by PS are searched along with it,
+	 so PS cannot be skipped because of its own symbols.  */
+      for (i = 0; i < ps->number_of_dependencies; i++)
+	if (ps->dependencies[i]->user != NULL)
+	  break;
+      if (i < ps->number_of_dependencies)
+	continue;
+
+      ps->searched_flag = PST_SEARCHED_AND_NOT_FOUND;
+    }
+
+  do_cleanups (cleanup);
+}
+
 /* Psymtab version of expand_symtabs_matching.  See its definition in
    the definition of quick_symbol_functions in symfile.h.  */
 
@@ -1399,18 +1609,30 @@ psym_expand_symtabs_matching
   (struct objfile *objfile,
    expand_symtabs_file_matcher_ftype *file_matcher,
    expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+   const struct trigram_query *query,
    expand_symtabs_exp_notify_ftype *expansion_notify,
    enum search_domain kind,
    void *data)
 {
   struct partial_symtab *ps;
+  struct partial_symtab **psts;
+  struct cleanup *cleanup;
+  int count = 0;
 
   /* Clear the search flags.  */
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
     {
       ps->searched_flag = PST_NOT_SEARCHED;
+      ++count;
     }
 
+  psts = XNEWVEC (struct partial_symtab *, count);
+  cleanup = make_cleanup (xfree, psts);
+  count = 0;
+
+  if (query != NULL)
+    psymtab_skip_by_trigrams (objfile, query);
+
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
     {
       QUIT;
@@ -1444,14 +1666,13 @@ psym_expand_symtabs_matching
 	}
 
       if (recursively_search_psymtabs (ps, objfile, kind, symbol_matcher, data))
-	{
-	  struct compunit_symtab *symtab =
-	    psymtab_to_symtab (objfile, ps);
-
-	  if (expansion_notify != NULL)
-	    expansion_notify (symtab, data);
-	}
+	psts[count++] = ps;
     }
+
+  /* Read in the matching psymtabs all at once, so that they can be
+     prepared together.  */
+  psymtabs_to_symtabs (objfile, psts, count, expansion_notify, data);
+  do_cleanups (cleanup);
 }
 
 /* Psymtab version of has_symbols.  See its definition in
@@ -1484,27 +1705,55 @@ const struct quick_symbol_functions psym_functions =
 
 
 
-/* This compares two partial symbols by names, using strcmp_iw_ordered
-   for the comparison.  */
+/* A partial symbol together with its search name, so that symbols
+   can be sorted without looking up the names of their objfile.  */
+
+struct psymbol_sort_entry
+{
+  const char *name;
+  struct partial_symbol *psymbol;
+};
+
+/* This compares two psymbol_sort_entry by names, using
+   strcmp_iw_ordered for the comparison.  */
 
 static int
 compare_psymbols (const void *s1p, const void *s2p)
 {
-  struct partial_symbol *const *s1 = (struct partial_symbol * const*) s1p;
-  struct partial_symbol *const *s2 = (struct partial_symbol * const*) s2p;
+  const struct psymbol_sort_entry *s1
+    = (const struct psymbol_sort_entry *) s1p;
+  const struct psymbol_sort_entry *s2
+    = (const struct psymbol_sort_entry *) s2p;
 
-  return strcmp_iw_ordered (SYMBOL_SEARCH_NAME (*s1),
-			    SYMBOL_SEARCH_NAME (*s2));
+  return strcmp_iw_ordered (s1->name, s2->name);
 }
 
 static void
 sort_pst_symbols (struct objfile *objfile, struct partial_symtab *pst)
 {
+  struct partial_symbol **list
+    = objfile->global_psymbols.list + pst->globals_offset;
+  struct psymbol_sort_entry *entries;
+  int i;
+
   /* Sort the global list; don't sort the static list.  */
 
-  qsort (objfile->global_psymbols.list + pst->globals_offset,
-	 pst->n_global_syms, sizeof (struct partial_symbol *),
+  if (pst->n_global_syms < 2)
+    return;
+
+  entries = XNEWVEC (struct psymbol_sort_entry, pst->n_global_syms);
+  for (i = 0; i < pst->n_global_syms; i++)
+    {
+      entries[i].name = psymbol_search_name (objfile, list[i]);
+      entries[i].psymbol = list[i];
+    }
+
+  qsort (entries, pst->n_global_syms, sizeof (struct psymbol_sort_entry),
 	 compare_psymbols);
+
+  for (i = 0; i < pst->n_global_syms; i++)
+    list[i] = entries[i].psymbol;
+  xfree (entries);
 }
 
 /* Allocate and partially fill a partial symtab.  It will be
@@ -1543,8 +1792,248 @@ end_psymtab_common (struct objfile *objfile, struct partial_symtab *pst)
   sort_pst_symbols (objfile, pst);
 }
 
+/* The key used to look up names in the string table of a
+   psymbol_bcache.  */
+
+struct psymbol_name_key
+{
+  const char *linkage_name;
+  enum language language;
+};
+
+/* Return the search name of the string table entry ENTRY.  */
+
+static const char *
+psymbol_name_entry_search_name (const char *entry)
+{
+  return entry + PSYMBOL_NAME_HEADER_SIZE;
+}
+
+/* Return the linkage name of the string table entry ENTRY.  */
+
+static const char *
+psymbol_name_entry_linkage_name (const char *entry)
+{
+  const char *name = psymbol_name_entry_search_name (entry);
+
+  if ((entry[5] & PSYMBOL_NAME_HAS_LINKAGE_NAME) != 0)
+    name += strlen (name) + 1;
+  return name;
+}
+
+/* Return a hash of LINKAGE_NAME and LANGUAGE.  */
+
+static hashval_t
+hash_psymbol_name (const char *linkage_name, enum language language)
+{
+  return htab_hash_string (linkage_name) * 17 + language;
+}
+
+/* Hash function for the names of a psymbol_bcache.  */
+
+static hashval_t
+hash_psymbol_name_entry (const void *p)
+{
+  const char *entry = (const char *) p;
+
+  return hash_psymbol_name (psymbol_name_entry_linkage_name (entry),
+			    (enum language) entry[4]);
+}
+
+/* Equality function for the names of a psymbol_bcache, comparing an
+   entry to a struct psymbol_name_key.  */
+
+static int
+eq_psymbol_name_entry (const void *p, const void *k)
+{
+  const char *entry = (const char *) p;
+  const struct psymbol_name_key *key = (const struct psymbol_name_key *) k;
+
+  return (entry[4] == key->language
+	  && strcmp (psymbol_name_entry_linkage_name (entry),
+		     key->linkage_name) == 0);
+}
+
+/* Return the string table entry of BCACHE at OFFSET.  */
+
+static const char *
+psymbol_name_entry (const struct psymbol_bcache *bcache, unsigned int offset)
+{
+  return (bcache->name_chunks[offset >> PSYMBOL_NAMES_CHUNK_BITS]
+	  + (offset & (PSYMBOL_NAMES_CHUNK_SIZE - 1))
+	  - PSYMBOL_NAME_HEADER_SIZE);
+}
+
+/* Allocate SIZE bytes at the end of the string table of BCACHE, in a
+   single allocation, and return them.  */
+
+static char *
+allocate_psymbol_name_entry (struct psymbol_bcache *bcache, size_t size)
+{
+  char *result;
+
+  if (bcache->names_end - bcache->names_used < size)
+    {
+      ULONGEST start, alloc;
+      unsigned int n_chunks, i;
+      char *block;
+
+      /* Start a new allocation at the next chunk.  The first ones are
+	 smaller, so that objfiles with few partial symbols use little
+	 memory.  */
+      start = ((bcache->names_end + PSYMBOL_NAMES_CHUNK_SIZE - 1)
+	       & ~(ULONGEST) (PSYMBOL_NAMES_CHUNK_SIZE - 1));
+      alloc = PSYMBOL_NAMES_CHUNK_SIZE;
+      if (VEC_length (char_ptr, bcache->name_blocks) < 4)
+	alloc = (PSYMBOL_NAMES_MIN_ALLOC
+		 << VEC_length (char_ptr, bcache->name_blocks));
+      if (alloc < size)
+	alloc = size;
+      if (start + alloc > PSYMBOL_NAMES_MAX_SIZE)
+	error (_("Too many partial symbol names"));
+
+      n_chunks = ((alloc + PSYMBOL_NAMES_CHUNK_SIZE - 1)
+		  / PSYMBOL_NAMES_CHUNK_SIZE);
+      if (bcache->n_name_chunks + n_chunks > bcache->name_chunks_size)
+	{
+	  bcache->name_chunks_size = 2 * bcache->name_chunks_size + n_chunks;
+	  bcache->name_chunks = XRESIZEVEC (char *, bcache->name_chunks,
+					    bcache->name_chunks_size);
+	}
+
+      block = (char *) xmalloc (alloc);
+      VEC_safe_push (char_ptr, bcache->name_blocks, block);
+      for (i = 0; i < n_chunks; ++i)
+	bcache->name_chunks[bcache->n_name_chunks++]
+	  = block + (size_t) i * PSYMBOL_NAMES_CHUNK_SIZE;
+
+      bcache->names_used = start;
+      bcache->names_end = start + alloc;
+      bcache->names_allocated += alloc;
+    }
+
+  result = (bcache->name_chunks[bcache->names_used >> PSYMBOL_NAMES_CHUNK_BITS]
+	    + (bcache->names_used & (PSYMBOL_NAMES_CHUNK_SIZE - 1)));
+  bcache->names_used += size;
+  return result;
+}
+
+/* Intern the NAMELENGTH bytes of NAME, the linkage name of partial
+   symbols of OBJFILE in *LANGUAGE, in the string table of the
+   psymbol_cache of OBJFILE, and return its offset there.  Like
+   symbol_set_names, demangle the name for the languages other than
+   Ada, and update *LANGUAGE if it was language_auto and a demangler
+   recognized the name.  */
+
+static unsigned int
+intern_psymbol_name (const char *name, int namelength,
+		     enum language *language, struct objfile *objfile)
+{
+  struct psymbol_bcache *bcache = objfile->psymbol_cache;
+  struct psymbol_name_key key;
+  const char *search_name;
+  char *linkage_name, *demangled = NULL, *entry = NULL;
+  size_t search_len, linkage_len, size;
+  unsigned int offset;
+  void **slot;
+
+  /* The stabs reader provides names that are not NUL-terminated.  */
+  linkage_name = (char *) alloca (namelength + 1);
+  memcpy (linkage_name, name, namelength);
+  linkage_name[namelength] = '\0';
+
+  key.linkage_name = linkage_name;
+  key.language = *language;
+  slot = htab_find_slot_with_hash (bcache->names, &key,
+				   hash_psymbol_name (linkage_name, *language),
+				   INSERT);
+  if (*slot != NULL)
+    {
+      const char *found = (const char *) *slot;
+
+      *language = (enum language) (found[5] >> PSYMBOL_NAME_LANGUAGE_SHIFT);
+      memcpy (&offset, found, 4);
+      return offset;
+    }
+
+  /* As in symbol_set_names, Ada symbols are searched for by their
+     linkage names, so their decoded names are not stored.  */
+  if (*language != language_ada)
+    {
+      struct general_symbol_info gsymbol;
+
+      memset (&gsymbol, 0, sizeof (gsymbol));
+      gsymbol.language = *language;
+      demangled = symbol_find_demangled_name (&gsymbol, linkage_name);
+      *language = gsymbol.language;
+    }
+  search_name = demangled != NULL ? demangled : linkage_name;
+
+  search_len = strlen (search_name) + 1;
+  linkage_len = demangled != NULL ? namelength + 1 : 0;
+  size = PSYMBOL_NAME_HEADER_SIZE + search_len + linkage_len;
+  TRY
+    {
+      entry = allocate_psymbol_name_entry (bcache, size);
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      htab_clear_slot (bcache->names, slot);
+      xfree (demangled);
+      throw_exception (except);
+    }
+  END_CATCH
+
+  offset = (bcache->names_used - size) + PSYMBOL_NAME_HEADER_SIZE;
+  memcpy (entry, &offset, 4);
+  entry[4] = key.language;
+  entry[5] = ((*language << PSYMBOL_NAME_LANGUAGE_SHIFT)
+	      | (demangled != NULL ? PSYMBOL_NAME_HAS_LINKAGE_NAME : 0));
+  memcpy (entry + PSYMBOL_NAME_HEADER_SIZE, search_name, search_len);
+  if (demangled != NULL)
+    memcpy (entry + PSYMBOL_NAME_HEADER_SIZE + search_len, linkage_name,
+	    linkage_len);
+  xfree (demangled);
+
+  *slot = entry;
+  return offset;
+}
+
+/* See psympriv.h.  */
+
+const char *
+psymbol_search_name (struct objfile *objfile,
+		     const struct partial_symbol *psym)
+{
+  return psymbol_name_entry_search_name
+    (psymbol_name_entry (objfile->psymbol_cache, psym->name));
+}
+
+/* See psympriv.h.  */
+
+const char *
+psymbol_linkage_name (struct objfile *objfile,
+		      const struct partial_symbol *psym)
+{
+  return psymbol_name_entry_linkage_name
+    (psymbol_name_entry (objfile->psymbol_cache, psym->name));
+}
+
+/* See psympriv.h.  */
+
+const char *
+psymbol_demangled_name (struct objfile *objfile,
+			const struct partial_symbol *psym)
+{
+  const char *entry = psymbol_name_entry (objfile->psymbol_cache, psym->name);
+
+  if ((entry[5] & PSYMBOL_NAME_HAS_LINKAGE_NAME) == 0)
+    return NULL;
+  return psymbol_name_entry_search_name (entry);
+}
+
 /* Calculate a hash code for the given partial symbol.  The hash is
-   calculated using the symbol's value, language, domain, class
+   calculated using the symbol's address, language, domain, class
    and name.  These are the values which are set by
    add_psymbol_to_bcache.  */
 
@@ -1553,21 +2042,23 @@ psymbol_hash (const void *addr, int length)
 {
   unsigned long h = 0;
   struct partial_symbol *psymbol = (struct partial_symbol *) addr;
-  unsigned int lang = psymbol->ginfo.language;
+  unsigned int lang = PSYMBOL_LANGUAGE (psymbol);
   unsigned int domain = PSYMBOL_DOMAIN (psymbol);
   unsigned int theclass = PSYMBOL_CLASS (psymbol);
+  ULONGEST key;
 
-  h = hash_continue (&psymbol->ginfo.value, sizeof (psymbol->ginfo.value), h);
-  h = hash_continue (&lang, sizeof (unsigned int), h);
-  h = hash_continue (&domain, sizeof (unsigned int), h);
-  h = hash_continue (&theclass, sizeof (unsigned int), h);
-  h = hash_continue (psymbol->ginfo.name, strlen (psymbol->ginfo.name), h);
+  /* Hash the fields two words at a time: the address, then the name
+     offset and the small enumerations packed together.  */
+  key = (((ULONGEST) psymbol->name << 32)
+	 | (lang << 16) | (domain << 8) | theclass);
+  h = hash_continue (&psymbol->address, sizeof (psymbol->address), h);
+  h = hash_continue (&key, sizeof (key), h);
 
   return h;
 }
 
 /* Returns true if the symbol at addr1 equals the symbol at addr2.
-   For the comparison this function uses a symbols value,
+   For the comparison this function uses a symbols address,
    language, domain, class and name.  */
 
 static int
@@ -1576,12 +2067,11 @@ psymbol_compare (const void *addr1, const void *addr2, int length)
   struct partial_symbol *sym1 = (struct partial_symbol *) addr1;
   struct partial_symbol *sym2 = (struct partial_symbol *) addr2;
 
-  return (memcmp (&sym1->ginfo.value, &sym1->ginfo.value,
-                  sizeof (sym1->ginfo.value)) == 0
-	  && sym1->ginfo.language == sym2->ginfo.language
+  return (PSYMBOL_VALUE_ADDRESS (sym1) == PSYMBOL_VALUE_ADDRESS (sym2)
+	  && PSYMBOL_LANGUAGE (sym1) == PSYMBOL_LANGUAGE (sym2)
           && PSYMBOL_DOMAIN (sym1) == PSYMBOL_DOMAIN (sym2)
           && PSYMBOL_CLASS (sym1) == PSYMBOL_CLASS (sym2)
-          && sym1->ginfo.name == sym2->ginfo.name);
+          && sym1->name == sym2->name);
 }
 
 /* Initialize a partial symbol bcache.  */
@@ -1592,6 +2082,9 @@ psymbol_bcache_init (void)
   struct psymbol_bcache *bcache = XCNEW (struct psymbol_bcache);
 
   bcache->bcache = bcache_xmalloc (psymbol_hash, psymbol_compare);
+  bcache->names = htab_create_alloc (64, hash_psymbol_name_entry,
+				     eq_psymbol_name_entry,
+				     NULL, xcalloc, xfree);
   return bcache;
 }
 
@@ -1600,10 +2093,18 @@ psymbol_bcache_init (void)
 void
 psymbol_bcache_free (struct psymbol_bcache *bcache)
 {
+  char *block;
+  int ix;
+
   if (bcache == NULL)
     return;
 
   bcache_xfree (bcache->bcache);
+  htab_delete (bcache->names);
+  for (ix = 0; VEC_iterate (char_ptr, bcache->name_blocks, ix, block); ++ix)
+    xfree (block);
+  VEC_free (char_ptr, bcache->name_blocks);
+  xfree (bcache->name_chunks);
   xfree (bcache);
 }
 
@@ -1615,6 +2116,16 @@ psymbol_bcache_get_bcache (struct psymbol_bcache *bcache)
   return bcache->bcache;
 }
 
+/* See psymtab.h.  */
+
+ULONGEST
+psymbol_bcache_names_memory_used (struct psymbol_bcache *bcache)
+{
+  return (bcache->names_allocated
+	  + bcache->name_chunks_size * sizeof (char *)
+	  + htab_size (bcache->names) * sizeof (void *));
+}
+
 /* Find a copy of the SYM in BCACHE.  If BCACHE has never seen this
    symbol before, add a copy to BCACHE.  In either case, return a pointer
    to BCACHE's copy of the symbol.  If optional ADDED is not NULL, return
@@ -1651,14 +2162,15 @@ add_psymbol_to_bcache (const char *name, int namelength, int copy_name,
      holes.  */
   memset (&psymbol, 0, sizeof (psymbol));
 
-  SYMBOL_VALUE_ADDRESS (&psymbol) = coreaddr;
-  SYMBOL_SECTION (&psymbol) = -1;
-  SYMBOL_SET_LANGUAGE (&psymbol, language, &objfile->objfile_obstack);
+  /* The name is interned in the psymbol_cache whether or not COPY_NAME
+     is set.  */
+  psymbol.name = intern_psymbol_name (name, namelength, &language, objfile);
+  PSYMBOL_VALUE_ADDRESS (&psymbol) = coreaddr;
+  PSYMBOL_SECTION (&psymbol) = -1;
+  PSYMBOL_LANGUAGE (&psymbol) = language;
   PSYMBOL_DOMAIN (&psymbol) = domain;
   PSYMBOL_CLASS (&psymbol) = theclass;
 
-  SYMBOL_SET_NAMES (&psymbol, name, namelength, copy_name, objfile);
-
   /* Stash the partial symbol away in the cache.  */
   return psymbol_bcache_full (&psymbol, objfile->psymbol_cache, added);
 }
@@ -2174,12 +2686,12 @@ maintenance_check_psymtabs (char *ignore, int from_tty)
     length = ps->n_static_syms;
     while (length--)
       {
-	sym = block_lookup_symbol (b, SYMBOL_LINKAGE_NAME (*psym),
-				   SYMBOL_DOMAIN (*psym));
+	sym = block_lookup_symbol (b, psymbol_linkage_name (objfile, *psym),
+				   PSYMBOL_DOMAIN (*psym));
 	if (!sym)
 	  {
 	    printf_filtered ("Static symbol `");
-	    puts_filtered (SYMBOL_LINKAGE_NAME (*psym));
+	    puts_filtered (psymbol_linkage_name (objfile, *psym));
 	    printf_filtered ("' only found in ");
 	    puts_filtered (ps->filename);
 	    printf_filtered (" psymtab\n");
@@ -2191,12 +2703,12 @@ maintenance_check_psymtabs (char *ignore, int from_tty)
     length = ps->n_global_syms;
     while (length--)
       {
-	sym = block_lookup_symbol (b, SYMBOL_LINKAGE_NAME (*psym),
-				   SYMBOL_DOMAIN (*psym));
+	sym = block_lookup_symbol (b, psymbol_linkage_name (objfile, *psym),
+				   PSYMBOL_DOMAIN (*psym));
 	if (!sym)
 	  {
 	    printf_filtered ("Global symbol `");
-	    puts_filtered (SYMBOL_LINKAGE_NAME (*psym));
+	    puts_filtered (psymbol_linkage_name (objfile, *psym));
 	    printf_filtered ("' only found in ");
 	    puts_filtered (ps->filename);
 	    printf_filtered (" psymtab\n");
@@ -2222,6 +2734,90 @@ maintenance_check_psymtabs (char *ignore, int from_tty)
 }
 
 
+/* Add the N partial symbols at LIST to CACHE.  Increment *TOTAL for
+   each of them, and *UNIQUE for each that CACHE did not hold yet.  */
+
+static void
+intern_psymbol_list (struct bcache *cache, struct partial_symbol **list,
+		     int n, unsigned long *total, unsigned long *unique)
+{
+  for (; n > 0; n--, list++)
+    {
+      int added;
+
+      bcache_full (*list, sizeof (struct partial_symbol), cache, &added);
+      ++*total;
+      *unique += added;
+    }
+}
+
+/* Implement the "maint intern-psymbols" command.  */
+
+static void
+maintenance_intern_psymbols (char *args, int from_tty)
+{
+  struct objfile *objfile;
+  struct partial_symtab *ps;
+  unsigned long total = 0, unique = 0, found = 0;
+  LONGEST count = 1;
+  LONGEST i;
+
+  if (args != NULL && *args != '\0')
+    {
+      count = parse_and_eval_long (args);
+      if (count <= 0)
+	error (_("The repeat count must be positive."));
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      total = unique = found = 0;
+
+      ALL_OBJFILES (objfile)
+	{
+	  struct bcache *cache;
+	  unsigned long lookups = 0, misses = 0;
+
+	  if (objfile->psymtabs == NULL)
+	    continue;
+
+	  /* Name offsets are only meaningful within their objfile, so
+	     each objfile gets its own cache.  The first pass inserts
+	     every partial symbol; the second finds all of them.  */
+	  cache = bcache_xmalloc (psymbol_hash, psymbol_compare);
+	  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+	    {
+	      intern_psymbol_list (cache, (objfile->global_psymbols.list
+					   + ps->globals_offset),
+				   ps->n_global_syms, &total, &unique);
+	      intern_psymbol_list (cache, (objfile->static_psymbols.list
+					   + ps->statics_offset),
+				   ps->n_static_syms, &total, &unique);
+	    }
+	  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+	    {
+	      intern_psymbol_list (cache, (objfile->global_psymbols.list
+					   + ps->globals_offset),
+				   ps->n_global_syms, &lookups, &misses);
+	      intern_psymbol_list (cache, (objfile->static_psymbols.list
+					   + ps->statics_offset),
+				   ps->n_static_syms, &lookups, &misses);
+	    }
+	  bcache_xfree (cache);
+
+	  gdb_assert (misses == 0);
+	  found += lookups;
+	}
+
+      QUIT;
+    }
+
+  printf_filtered (_("Interned %s partial symbols (%s unique) "
+		     "and found %s again, %s times.\n"),
+		   pulongest (total), pulongest (unique),
+		   pulongest (found), plongest (count));
+}
+
 
 extern initialize_file_ftype _initialize_psymtab;
 
@@ -2244,4 +2840,12 @@ just the symbol table structures themselves."),
 	   _("\
 Check consistency of currently expanded psymtabs versus symtabs."),
 	   &maintenancelist);
+
+  add_cmd ("intern-psymbols", class_maintenance, maintenance_intern_psymbols,
+	   _("\
+Intern every partial symbol in a new byte cache, then find each again.\n\
+Usage: maintenance intern-psymbols [COUNT]\n\
+This is repeated COUNT times, once by default, to measure the speed of\n\
+the byte cache."),
+	   &maintenancelist);
 }
@@ -30,6 +30,11 @@ extern struct psymbol_bcache *psymbol_bcache_init (void);
 extern void psymbol_bcache_free (struct psymbol_bcache *);
 extern struct bcache *psymbol_bcache_get_bcache (struct psymbol_bcache *);
 
+/* Return the number of bytes used by the string table of the names of
+   the partial symbols in BCACHE.  */
+
+extern ULONGEST psymbol_bcache_names_memory_used (struct psymbol_bcache *);
+
 extern const struct quick_symbol_functions psym_functions;
 
 extern const struct quick_symbol_functions dwarf2_gdb_index_functions;
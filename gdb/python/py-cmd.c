@@ -153,6 +153,10 @@ cmdpy_function (struct cmd_list_element *command, char *args, int from_tty)
   Py_DECREF (argobj);
   Py_DECREF (ttyobj);
 
+  /* The command may have changed the set of pretty-printers, for
+     instance "enable pretty-printer".  */
+  gdbpy_invalidate_pretty_printer_cache ();
+
   if (! result)
     {
       PyObject *ptype, *pvalue, *ptraceback;
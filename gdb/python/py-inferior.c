@@ -497,6 +497,39 @@ gdbpy_inferiors (PyObject *unused, PyObject *unused2)
 
 /* Membuf and memory manipulation.  */
 
+/* Return a Python buffer object for the LENGTH bytes of the inferior's
+   memory at ADDR held in BUFFER, which is xmalloc'd.  Ownership of
+   BUFFER is transferred to the result, or BUFFER is freed on error.
+   Returns NULL on error, with a python exception set.  */
+
+static PyObject *
+membuf_to_buffer_object (gdb_byte *buffer, CORE_ADDR addr, CORE_ADDR length)
+{
+  membuf_object *membuf_obj;
+  PyObject *result;
+
+  membuf_obj = PyObject_New (membuf_object, &membuf_object_type);
+  if (membuf_obj == NULL)
+    {
+      xfree (buffer);
+      return NULL;
+    }
+
+  membuf_obj->buffer = buffer;
+  membuf_obj->addr = addr;
+  membuf_obj->length = length;
+
+#ifdef IS_PY3K
+  result = PyMemoryView_FromObject ((PyObject *) membuf_obj);
+#else
+  result = PyBuffer_FromReadWriteObject ((PyObject *) membuf_obj, 0,
+					 Py_END_OF_BUFFER);
+#endif
+  Py_DECREF (membuf_obj);
+
+  return result;
+}
+
 /* Implementation of Inferior.read_memory (address, length).
    Returns a Python buffer object with LENGTH bytes of the inferior's
    memory at ADDRESS.  Both arguments are integers.  Returns NULL on error,
@@ -506,8 +539,7 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
 {
   CORE_ADDR addr, length;
   gdb_byte *buffer = NULL;
-  membuf_object *membuf_obj;
-  PyObject *addr_obj, *length_obj, *result;
+  PyObject *addr_obj, *length_obj;
   static char *keywords[] = { "address", "length", NULL };
 
   if (! PyArg_ParseTupleAndKeywords (args, kw, "OO", keywords,
@@ -531,25 +563,133 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
     }
   END_CATCH
 
-  membuf_obj = PyObject_New (membuf_object, &membuf_object_type);
-  if (membuf_obj == NULL)
+  return membuf_to_buffer_object (buffer, addr, length);
+}
+
+/* A cleanup that frees the data buffers of a vector of memory read
+   requests, and the vector itself.  */
+
+static void
+free_read_requests_vector (void *p)
+{
+  VEC(memory_read_request_s) **v = (VEC(memory_read_request_s) **) p;
+  struct memory_read_request *r;
+  int i;
+
+  for (i = 0; VEC_iterate (memory_read_request_s, *v, i, r); ++i)
+    xfree (r->data);
+
+  VEC_free (memory_read_request_s, *v);
+}
+
+/* Implementation of Inferior.read_memory_vectored (ranges).
+   RANGES is an iterable of (address, length) tuples.  Returns a list
+   holding, for each range, a Python buffer object with the contents
+   of the inferior's memory, or None if the memory could not be read.
+   All the ranges are read in one batch, see target_read_memory_blocks.
+   Returns NULL on error, with a python exception set.  */
+
+static PyObject *
+infpy_read_memory_vectored (PyObject *self, PyObject *args, PyObject *kw)
+{
+  PyObject *ranges_obj, *iter, *item, *result = NULL;
+  VEC(memory_read_request_s) *requests = NULL;
+  struct memory_read_request *r;
+  struct cleanup *cleanups;
+  int i;
+  static char *keywords[] = { "ranges", NULL };
+
+  if (! PyArg_ParseTupleAndKeywords (args, kw, "O", keywords, &ranges_obj))
+    return NULL;
+
+  iter = PyObject_GetIter (ranges_obj);
+  if (iter == NULL)
+    return NULL;
+
+  cleanups = make_cleanup_py_decref (iter);
+  make_cleanup (free_read_requests_vector, &requests);
+
+  while ((item = PyIter_Next (iter)) != NULL)
     {
-      xfree (buffer);
-      return NULL;
+      PyObject *addr_obj, *length_obj;
+      CORE_ADDR addr, length;
+      int ok;
+
+      ok = (PyTuple_Check (item) && PyTuple_Size (item) == 2);
+      if (ok)
+	{
+	  addr_obj = PyTuple_GetItem (item, 0);
+	  length_obj = PyTuple_GetItem (item, 1);
+	  ok = (get_addr_from_python (addr_obj, &addr) == 0
+		&& get_addr_from_python (length_obj, &length) == 0);
+	}
+      else
+	PyErr_SetString (PyExc_TypeError,
+			 _("Each range must be a tuple of an address"
+			   " and a length."));
+      Py_DECREF (item);
+      if (! ok)
+	goto fail;
+
+      r = VEC_safe_push (memory_read_request_s, requests, NULL);
+      r->begin = addr;
+      r->end = addr + length;
+      r->data = NULL;
+      r->status = 0;
+      if (r->end < r->begin)
+	{
+	  PyErr_SetString (PyExc_ValueError,
+			   _("Range wraps around the address space."));
+	  goto fail;
+	}
     }
+  if (PyErr_Occurred ())
+    goto fail;
 
-  membuf_obj->buffer = buffer;
-  membuf_obj->addr = addr;
-  membuf_obj->length = length;
+  TRY
+    {
+      for (i = 0; VEC_iterate (memory_read_request_s, requests, i, r); ++i)
+	r->data = (gdb_byte *) xmalloc (r->end - r->begin);
 
-#ifdef IS_PY3K
-  result = PyMemoryView_FromObject ((PyObject *) membuf_obj);
-#else
-  result = PyBuffer_FromReadWriteObject ((PyObject *) membuf_obj, 0,
-					 Py_END_OF_BUFFER);
-#endif
-  Py_DECREF (membuf_obj);
+      target_read_memory_blocks (requests);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      gdbpy_convert_exception (except);
+      goto fail;
+    }
+  END_CATCH
 
+  result = PyList_New (VEC_length (memory_read_request_s, requests));
+  if (result == NULL)
+    goto fail;
+
+  for (i = 0; VEC_iterate (memory_read_request_s, requests, i, r); ++i)
+    {
+      PyObject *buffer_obj;
+
+      if (r->status != 0)
+	{
+	  Py_INCREF (Py_None);
+	  buffer_obj = Py_None;
+	}
+      else
+	{
+	  buffer_obj = membuf_to_buffer_object (r->data, r->begin,
+						r->end - r->begin);
+	  r->data = NULL;
+	  if (buffer_obj == NULL)
+	    {
+	      Py_DECREF (result);
+	      result = NULL;
+	      goto fail;
+	    }
+	}
+      PyList_SET_ITEM (result, i, buffer_obj);
+    }
+
+ fail:
+  do_cleanups (cleanups);
   return result;
 }
 
@@ -928,6 +1068,12 @@ Return true if this inferior is valid, false if not." },
     METH_VARARGS | METH_KEYWORDS,
     "read_memory (address, length) -> buffer\n\
 Return a buffer object for reading from the inferior's memory." },
+  { "read_memory_vectored", (PyCFunction) infpy_read_memory_vectored,
+    METH_VARARGS | METH_KEYWORDS,
+    "read_memory_vectored (ranges) -> list\n\
+Return a list of buffer objects, one for each (address, length) tuple\n\
+in RANGES, read from the inferior's memory.  Reads of nearby ranges\n\
+are coalesced.  Ranges that cannot be read yield None." },
   { "write_memory", (PyCFunction) infpy_write_memory,
     METH_VARARGS | METH_KEYWORDS,
     "write_memory (address, buffer [, length])\n\
@@ -277,6 +277,8 @@ objfpy_set_printers (PyObject *o, PyObject *value, void *ignore)
   self->printers = value;
   Py_XDECREF (tmp);
 
+  gdbpy_invalidate_pretty_printer_cache ();
+
   return 0;
 }
 
@@ -19,6 +19,9 @@
 
 #include "defs.h"
 #include "objfiles.h"
+#include "progspace.h"
+#include "observer.h"
+#include "hashtab.h"
 #include "symtab.h"
 #include "language.h"
 #include "valprint.h"
@@ -42,10 +45,12 @@ enum string_repr_result
    calls each function and inspects output.  This will return a
    printer object if one recognizes VALUE.  If no printer is found, it
    will return None.  On error, it will set the Python error and
-   return NULL.  */
+   return NULL.  If a printer is found and MATCHED is not NULL,
+   *MATCHED is set to a borrowed reference to the lookup function
+   that recognized VALUE.  */
 
 static PyObject *
-search_pp_list (PyObject *list, PyObject *value)
+search_pp_list (PyObject *list, PyObject *value, PyObject **matched)
 {
   Py_ssize_t pp_list_size, list_index;
   PyObject *function, *printer = NULL;
@@ -78,7 +83,11 @@ search_pp_list (PyObject *list, PyObject *value)
       if (! printer)
 	return NULL;
       else if (printer != Py_None)
-	return printer;
+	{
+	  if (matched != NULL)
+	    *matched = function;
+	  return printer;
+	}
 
       Py_DECREF (printer);
     }
@@ -90,10 +99,11 @@ search_pp_list (PyObject *list, PyObject *value)
    Look for a pretty-printer to print VALUE in all objfiles.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Otherwise the result is the pretty-printer function, suitably inc-ref'd.
+   MATCHED is passed to search_pp_list.  */
 
 static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+find_pretty_printer_from_objfiles (PyObject *value, PyObject **matched)
 {
   PyObject *pp_list;
   PyObject *function;
@@ -110,7 +120,7 @@ find_pretty_printer_from_objfiles (PyObject *value)
       }
 
     pp_list = objfpy_get_printers (objf, NULL);
-    function = search_pp_list (pp_list, value);
+    function = search_pp_list (pp_list, value, matched);
     Py_XDECREF (pp_list);
 
     /* If there is an error in any objfile list, abort the search and exit.  */
@@ -130,10 +140,11 @@ find_pretty_printer_from_objfiles (PyObject *value)
    Look for a pretty-printer to print VALUE in the current program space.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Otherwise the result is the pretty-printer function, suitably inc-ref'd.
+   MATCHED is passed to search_pp_list.  */
 
 static PyObject *
-find_pretty_printer_from_progspace (PyObject *value)
+find_pretty_printer_from_progspace (PyObject *value, PyObject **matched)
 {
   PyObject *pp_list;
   PyObject *function;
@@ -142,7 +153,7 @@ find_pretty_printer_from_progspace (PyObject *value)
   if (!obj)
     return NULL;
   pp_list = pspy_get_printers (obj, NULL);
-  function = search_pp_list (pp_list, value);
+  function = search_pp_list (pp_list, value, matched);
   Py_XDECREF (pp_list);
   return function;
 }
@@ -151,10 +162,11 @@ find_pretty_printer_from_progspace (PyObject *value)
    Look for a pretty-printer to print VALUE in the gdb module.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Otherwise the result is the pretty-printer function, suitably inc-ref'd.
+   MATCHED is passed to search_pp_list.  */
 
 static PyObject *
-find_pretty_printer_from_gdb (PyObject *value)
+find_pretty_printer_from_gdb (PyObject *value, PyObject **matched)
 {
   PyObject *pp_list;
   PyObject *function;
@@ -170,35 +182,213 @@ find_pretty_printer_from_gdb (PyObject *value)
       Py_RETURN_NONE;
     }
 
-  function = search_pp_list (pp_list, value);
+  function = search_pp_list (pp_list, value, matched);
   Py_XDECREF (pp_list);
   return function;
 }
 
-/* Find the pretty-printing constructor function for VALUE.  If no
-   pretty-printer exists, return None.  If one exists, return a new
-   reference.  On error, set the Python error and return NULL.  */
+/* Search all the pretty-printer lists, in order, for a printer for
+   VALUE.  The result is as for find_pretty_printer.  If a printer is
+   found, *MATCHED is set to a borrowed reference to the lookup
+   function that recognized VALUE.  */
 
 static PyObject *
-find_pretty_printer (PyObject *value)
+search_pretty_printers (PyObject *value, PyObject **matched)
 {
   PyObject *function;
 
   /* Look at the pretty-printer list for each objfile
      in the current program-space.  */
-  function = find_pretty_printer_from_objfiles (value);
+  function = find_pretty_printer_from_objfiles (value, matched);
   if (function == NULL || function != Py_None)
     return function;
   Py_DECREF (function);
 
   /* Look at the pretty-printer list for the current program-space.  */
-  function = find_pretty_printer_from_progspace (value);
+  function = find_pretty_printer_from_progspace (value, matched);
   if (function == NULL || function != Py_None)
     return function;
   Py_DECREF (function);
 
   /* Look at the pretty-printer list in the gdb module.  */
-  function = find_pretty_printer_from_gdb (value);
+  function = find_pretty_printer_from_gdb (value, matched);
+  return function;
+}
+
+/* Searching the pretty-printer lists means calling every lookup
+   function until one of them accepts the value.  When printing a
+   large array or container this is done once per element, with the
+   same answer every time, so the result of the search is remembered
+   per type in this cache.
+
+   An entry records the lookup function that recognized a value of
+   TYPE in program space PSPACE, or Py_None if no lookup function did.
+   The lookup function is still called for every value, since the
+   printer it returns is specific to the value; but the other lookup
+   functions are skipped.
+
+   The cache is emptied whenever the set of pretty-printers may have
+   changed: when objfiles are loaded or freed, when a pretty_printers
+   attribute is assigned, and whenever Python code is run by a GDB
+   command or script.  Since discarding the entries requires the GIL,
+   gdbpy_invalidate_pretty_printer_cache only marks the cache as
+   stale, and the entries are freed the next time a lookup is done.  */
+
+struct pretty_printer_cache_entry
+{
+  /* The type of the value that was looked up.  */
+  struct type *type;
+
+  /* The program space in which the lookup was done.  */
+  struct program_space *pspace;
+
+  /* The lookup function that recognized the value, or Py_None.  This
+     is a new reference.  */
+  PyObject *function;
+};
+
+/* The cache of pretty-printer lookups.  NULL if no lookup has been
+   recorded yet.  */
+
+static htab_t pretty_printer_cache;
+
+/* Non-zero if the contents of PRETTY_PRINTER_CACHE must be discarded
+   before the next lookup.  */
+
+static int pretty_printer_cache_stale;
+
+/* Hash function for a pretty_printer_cache_entry.  */
+
+static hashval_t
+hash_pretty_printer_cache_entry (const void *p)
+{
+  const struct pretty_printer_cache_entry *entry
+    = (const struct pretty_printer_cache_entry *) p;
+
+  return (htab_hash_pointer (entry->type) * 67
+	  + htab_hash_pointer (entry->pspace));
+}
+
+/* Equality function for a pretty_printer_cache_entry.  */
+
+static int
+eq_pretty_printer_cache_entry (const void *a, const void *b)
+{
+  const struct pretty_printer_cache_entry *ea
+    = (const struct pretty_printer_cache_entry *) a;
+  const struct pretty_printer_cache_entry *eb
+    = (const struct pretty_printer_cache_entry *) b;
+
+  return ea->type == eb->type && ea->pspace == eb->pspace;
+}
+
+/* Deletion function for a pretty_printer_cache_entry.  The caller
+   must hold the GIL.  */
+
+static void
+del_pretty_printer_cache_entry (void *p)
+{
+  struct pretty_printer_cache_entry *entry
+    = (struct pretty_printer_cache_entry *) p;
+
+  Py_DECREF (entry->function);
+  xfree (entry);
+}
+
+/* See python-internal.h.  */
+
+void
+gdbpy_invalidate_pretty_printer_cache (void)
+{
+  pretty_printer_cache_stale = 1;
+}
+
+/* Return the slot in the pretty-printer cache for values of TYPE in
+   the current program space.  The slot is empty if there is no
+   entry.  */
+
+static struct pretty_printer_cache_entry **
+lookup_pretty_printer_cache (struct type *type)
+{
+  struct pretty_printer_cache_entry key;
+
+  if (pretty_printer_cache == NULL)
+    pretty_printer_cache
+      = htab_create_alloc (127, hash_pretty_printer_cache_entry,
+			   eq_pretty_printer_cache_entry,
+			   del_pretty_printer_cache_entry,
+			   xcalloc, xfree);
+  else if (pretty_printer_cache_stale)
+    htab_empty (pretty_printer_cache);
+  pretty_printer_cache_stale = 0;
+
+  key.type = type;
+  key.pspace = current_program_space;
+  return ((struct pretty_printer_cache_entry **)
+	  htab_find_slot (pretty_printer_cache, &key, INSERT));
+}
+
+/* Observer for the new_objfile and free_objfile events.  */
+
+static void
+pretty_printer_cache_objfile_changed (struct objfile *objfile)
+{
+  gdbpy_invalidate_pretty_printer_cache ();
+}
+
+/* Find the pretty-printing constructor function for VALUE.  If no
+   pretty-printer exists, return None.  If one exists, return a new
+   reference.  On error, set the Python error and return NULL.  */
+
+static PyObject *
+find_pretty_printer (PyObject *value)
+{
+  struct pretty_printer_cache_entry **slot, *entry;
+  PyObject *function, *matched = NULL;
+  struct value *val;
+
+  val = value_object_to_value (value);
+  if (val == NULL || !gdbpy_pretty_printer_cache_enabled_p ())
+    return search_pretty_printers (value, NULL);
+
+  slot = lookup_pretty_printer_cache (value_type (val));
+  entry = *slot;
+  if (entry != NULL)
+    {
+      if (entry->function == Py_None)
+	Py_RETURN_NONE;
+
+      /* The lookup function may cause the cache to be emptied.  */
+      matched = entry->function;
+      Py_INCREF (matched);
+      function = PyObject_CallFunctionObjArgs (matched, value, NULL);
+      Py_DECREF (matched);
+      if (function == NULL || function != Py_None)
+	return function;
+      Py_DECREF (function);
+
+      /* The lookup function does not only look at the type of the
+	 value.  Do a full search, and don't update the cache.  */
+      return search_pretty_printers (value, NULL);
+    }
+
+  function = search_pretty_printers (value, &matched);
+  if (function == NULL)
+    return NULL;
+
+  /* Calling the lookup functions may have invalidated the cache, and
+     with it SLOT.  */
+  slot = lookup_pretty_printer_cache (value_type (val));
+  if (*slot == NULL)
+    {
+      entry = XNEW (struct pretty_printer_cache_entry);
+      entry->type = value_type (val);
+      entry->pspace = current_program_space;
+      entry->function = function == Py_None ? Py_None : matched;
+      Py_INCREF (entry->function);
+      *slot = entry;
+    }
+
   return function;
 }
 
@@ -467,9 +657,252 @@ push_dummy_python_frame (void)
 }
 #endif
 
+/* The largest number of bytes read from the inferior at once when
+   printing the elements of a printer's children_ranges.  */
+
+#define CHILDREN_RANGES_CHUNK_SIZE 65536
+
+/* State of an iteration over the elements of the ranges returned by
+   a printer's children_ranges method.  */
+
+struct children_ranges_iterator
+{
+  /* A Python iterator over the (pointer, length) tuples.  */
+  PyObject *ranges;
+
+  /* The type of the elements of the current range.  */
+  struct type *elt_type;
+
+  /* The address of the next element of the current range.  */
+  CORE_ADDR addr;
+
+  /* The number of elements left in the current range.  */
+  LONGEST remaining;
+
+  /* Contents of the inferior's memory starting at BUFFER_ADDR, or
+     NULL.  */
+  gdb_byte *buffer;
+  CORE_ADDR buffer_addr;
+  size_t buffer_len;
+  size_t buffer_size;
+};
+
+/* Start the next range of ITER.  Return 1 on success, 0 if there are
+   no more ranges, and -1 with a Python exception set on error.  */
+
+static int
+children_ranges_next_range (struct children_ranges_iterator *iter)
+{
+  PyObject *item, *py_ptr;
+  LONGEST length;
+  struct value *ptr;
+  struct type *ptr_type;
+  int result = 1;
+
+  item = PyIter_Next (iter->ranges);
+  if (item == NULL)
+    return PyErr_Occurred () ? -1 : 0;
+
+  if (! PyTuple_Check (item) || PyTuple_Size (item) != 2
+      || ! PyArg_ParseTuple (item, "O" GDB_PY_LL_ARG, &py_ptr, &length))
+    {
+      PyErr_Clear ();
+      PyErr_SetString (PyExc_TypeError,
+		       _("Result of children_ranges is not a tuple"
+			 " of a pointer and a length."));
+      Py_DECREF (item);
+      return -1;
+    }
+
+  ptr = value_object_to_value (py_ptr);
+  if (ptr == NULL || length < 0)
+    {
+      PyErr_SetString (PyExc_TypeError,
+		       _("Result of children_ranges is not a tuple"
+			 " of a pointer and a length."));
+      Py_DECREF (item);
+      return -1;
+    }
+
+  TRY
+    {
+      ptr_type = check_typedef (value_type (ptr));
+      if (TYPE_CODE (ptr_type) != TYPE_CODE_PTR
+	  || TYPE_LENGTH (check_typedef (TYPE_TARGET_TYPE (ptr_type))) == 0)
+	{
+	  PyErr_SetString (PyExc_TypeError,
+			   _("Range start is not a pointer to a sized type."));
+	  result = -1;
+	}
+      else
+	{
+	  iter->elt_type = TYPE_TARGET_TYPE (ptr_type);
+	  iter->addr = value_as_address (ptr);
+	  iter->remaining = length;
+	}
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      gdbpy_convert_exception (except);
+      result = -1;
+    }
+  END_CATCH
+
+  Py_DECREF (item);
+  return result;
+}
+
+/* Return the next element of ITER in *CHILD.  At most MAX elements
+   will be requested from ITER, which is used to avoid reading memory
+   that will not be printed.  Return 1 on success, 0 if there are no
+   more elements, and -1 with a Python exception set on error.  */
+
+static int
+children_ranges_next (struct children_ranges_iterator *iter,
+		      unsigned int max, struct value **child)
+{
+  ULONGEST elt_len;
+  CORE_ADDR addr;
+
+  while (iter->remaining == 0)
+    {
+      int r = children_ranges_next_range (iter);
+
+      if (r <= 0)
+	return r;
+    }
+
+  elt_len = TYPE_LENGTH (check_typedef (iter->elt_type));
+  addr = iter->addr;
+
+  /* Refill the buffer with as many of the elements that may be
+     printed as fit in a chunk, reading at least one element.  */
+  if (iter->buffer == NULL
+      || addr < iter->buffer_addr
+      || addr + elt_len > iter->buffer_addr + iter->buffer_len)
+    {
+      LONGEST count = iter->remaining;
+
+      if (count > max)
+	count = max;
+      if (count > CHILDREN_RANGES_CHUNK_SIZE / elt_len)
+	count = CHILDREN_RANGES_CHUNK_SIZE / elt_len;
+      if (count == 0)
+	count = 1;
+
+      if (count * elt_len > iter->buffer_size)
+	{
+	  iter->buffer_size = count * elt_len;
+	  iter->buffer = (gdb_byte *) xrealloc (iter->buffer,
+						iter->buffer_size);
+	}
+
+      iter->buffer_len = 0;
+      if (target_read_memory (addr, iter->buffer, count * elt_len) == 0)
+	{
+	  iter->buffer_addr = addr;
+	  iter->buffer_len = count * elt_len;
+	}
+    }
+
+  TRY
+    {
+      /* If the memory could not be read, use a lazy value, so that
+	 the error is reported when the element is printed.  */
+      if (iter->buffer_len == 0)
+	*child = value_at_lazy (iter->elt_type, addr);
+      else
+	*child = value_from_contents_and_address (iter->elt_type,
+						  iter->buffer
+						  + (addr
+						     - iter->buffer_addr),
+						  addr);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      gdbpy_convert_exception (except);
+      return -1;
+    }
+  END_CATCH
+
+  iter->addr += elt_len;
+  --iter->remaining;
+  return 1;
+}
+
+/* Helper for print_children that prints what comes before child
+   number I, named NAME: the opening brace or separator, the
+   indentation, and the name or index of the child.  *PRETTY is the
+   pretty-printing flag computed by print_children.  Return 0 if
+   nothing more should be printed because we are in summary mode.  */
+
+static int
+print_child_prefix (unsigned int i, const char *name, int is_map,
+		    int is_array, int is_py_none, int *pretty,
+		    struct ui_file *stream, int recurse,
+		    const struct value_print_options *options)
+{
+  /* Print initial "{".  For other elements, there are three
+     cases:
+     1. Maps.  Print a "," after each value element.
+     2. Arrays.  Always print a ",".
+     3. Other.  Always print a ",".  */
+  if (i == 0)
+    {
+      if (is_py_none)
+	fputs_filtered ("{", stream);
+      else
+	fputs_filtered (" = {", stream);
+    }
+
+  else if (! is_map || i % 2 == 0)
+    fputs_filtered (*pretty ? "," : ", ", stream);
+
+  /* In summary mode, we just want to print "= {...}" if there is
+     a value.  */
+  if (options->summary)
+    {
+      /* This tricks the post-loop logic to print what we want.  */
+      *pretty = 0;
+      return 0;
+    }
+
+  if (! is_map || i % 2 == 0)
+    {
+      if (*pretty)
+	{
+	  fputs_filtered ("\n", stream);
+	  print_spaces_filtered (2 + 2 * recurse, stream);
+	}
+      else
+	wrap_here (n_spaces (2 + 2 *recurse));
+    }
+
+  if (is_map && i % 2 == 0)
+    fputs_filtered ("[", stream);
+  else if (is_array)
+    {
+      /* We print the index, not whatever the child method
+	 returned as the name.  */
+      if (options->print_array_indexes)
+	fprintf_filtered (stream, "[%d] = ", i);
+    }
+  else if (! is_map)
+    {
+      fputs_filtered (name, stream);
+      fputs_filtered (" = ", stream);
+    }
+
+  return 1;
+}
+
 /* Helper for gdbpy_apply_val_pretty_printer that formats children of the
    printer, if any exist.  If is_py_none is true, then nothing has
-   been printed by to_string, and format output accordingly. */
+   been printed by to_string, and format output accordingly.
+
+   If the printer has a children_ranges method, and this is not a
+   map, the elements of the ranges it returns are printed directly,
+   without calling into Python for each child.  */
 static void
 print_children (PyObject *printer, const char *hint,
 		struct ui_file *stream, int recurse,
@@ -477,28 +910,53 @@ print_children (PyObject *printer, const char *hint,
 		const struct language_defn *language,
 		int is_py_none)
 {
-  int is_map, is_array, done_flag, pretty;
+  int is_map, is_array, done_flag, pretty, use_ranges;
   unsigned int i;
   PyObject *children, *iter;
+  struct children_ranges_iterator ranges_iter;
 #ifndef IS_PY3K
   PyObject *frame;
 #endif
   struct cleanup *cleanups;
 
-  if (! PyObject_HasAttr (printer, gdbpy_children_cst))
-    return;
-
   /* If we are printing a map or an array, we want some special
      formatting.  */
   is_map = hint && ! strcmp (hint, "map");
   is_array = hint && ! strcmp (hint, "array");
 
-  children = PyObject_CallMethodObjArgs (printer, gdbpy_children_cst,
-					 NULL);
-  if (! children)
+  children = NULL;
+  use_ranges = 0;
+  if (! is_map && PyObject_HasAttr (printer, gdbpy_children_ranges_cst))
     {
-      print_stack_unless_memory_error (stream);
-      return;
+      children = PyObject_CallMethodObjArgs (printer,
+					     gdbpy_children_ranges_cst, NULL);
+      if (! children)
+	{
+	  print_stack_unless_memory_error (stream);
+	  return;
+	}
+      if (children == Py_None)
+	{
+	  /* The printer declined; fall back to the children method.  */
+	  Py_DECREF (children);
+	  children = NULL;
+	}
+      else
+	use_ranges = 1;
+    }
+
+  if (children == NULL)
+    {
+      if (! PyObject_HasAttr (printer, gdbpy_children_cst))
+	return;
+
+      children = PyObject_CallMethodObjArgs (printer, gdbpy_children_cst,
+					     NULL);
+      if (! children)
+	{
+	  print_stack_unless_memory_error (stream);
+	  return;
+	}
     }
 
   cleanups = make_cleanup_py_decref (children);
@@ -510,6 +968,12 @@ print_children (PyObject *printer, const char *hint,
       goto done;
     }
   make_cleanup_py_decref (iter);
+  if (use_ranges)
+    {
+      memset (&ranges_iter, 0, sizeof (ranges_iter));
+      ranges_iter.ranges = iter;
+      make_cleanup (free_current_contents, &ranges_iter.buffer);
+    }
 
   /* Use the prettyformat_arrays option if we are printing an array,
      and the pretty option otherwise.  */
@@ -539,10 +1003,45 @@ print_children (PyObject *printer, const char *hint,
   done_flag = 0;
   for (i = 0; i < options->print_max; ++i)
     {
-      PyObject *py_v, *item = PyIter_Next (iter);
+      PyObject *py_v, *item;
       const char *name;
       struct cleanup *inner_cleanup;
 
+      if (use_ranges)
+	{
+	  struct value *mark = value_mark ();
+	  struct value *child;
+	  char index_name[32];
+	  int r;
+
+	  r = children_ranges_next (&ranges_iter, options->print_max - i,
+				    &child);
+	  if (r < 0)
+	    {
+	      print_stack_unless_memory_error (stream);
+	      break;
+	    }
+	  else if (r == 0)
+	    {
+	      done_flag = 1;
+	      break;
+	    }
+
+	  xsnprintf (index_name, sizeof (index_name), "[%u]", i);
+	  if (! print_child_prefix (i, index_name, is_map, is_array,
+				    is_py_none, &pretty, stream, recurse,
+				    options))
+	    {
+	      ++i;
+	      break;
+	    }
+
+	  common_val_print (child, stream, recurse + 1, options, language);
+	  value_free_to_mark (mark);
+	  continue;
+	}
+
+      item = PyIter_Next (iter);
       if (! item)
 	{
 	  if (PyErr_Occurred ())
@@ -576,60 +1075,16 @@ print_children (PyObject *printer, const char *hint,
 	}
       inner_cleanup = make_cleanup_py_decref (item);
 
-      /* Print initial "{".  For other elements, there are three
-	 cases:
-	 1. Maps.  Print a "," after each value element.
-	 2. Arrays.  Always print a ",".
-	 3. Other.  Always print a ",".  */
-      if (i == 0)
-	{
-         if (is_py_none)
-           fputs_filtered ("{", stream);
-         else
-           fputs_filtered (" = {", stream);
-       }
-
-      else if (! is_map || i % 2 == 0)
-	fputs_filtered (pretty ? "," : ", ", stream);
-
-      /* In summary mode, we just want to print "= {...}" if there is
-	 a value.  */
-      if (options->summary)
+      if (! print_child_prefix (i, name, is_map, is_array, is_py_none,
+				&pretty, stream, recurse, options))
 	{
 	  /* This increment tricks the post-loop logic to print what
 	     we want.  */
 	  ++i;
-	  /* Likewise.  */
-	  pretty = 0;
+	  do_cleanups (inner_cleanup);
 	  break;
 	}
 
-      if (! is_map || i % 2 == 0)
-	{
-	  if (pretty)
-	    {
-	      fputs_filtered ("\n", stream);
-	      print_spaces_filtered (2 + 2 * recurse, stream);
-	    }
-	  else
-	    wrap_here (n_spaces (2 + 2 *recurse));
-	}
-
-      if (is_map && i % 2 == 0)
-	fputs_filtered ("[", stream);
-      else if (is_array)
-	{
-	  /* We print the index, not whatever the child method
-	     returned as the name.  */
-	  if (options->print_array_indexes)
-	    fprintf_filtered (stream, "[%d] = ", i);
-	}
-      else if (! is_map)
-	{
-	  fputs_filtered (name, stream);
-	  fputs_filtered (" = ", stream);
-	}
-
       if (gdbpy_is_lazy_string (py_v))
 	{
 	  CORE_ADDR addr;
@@ -718,8 +1173,10 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   enum ext_lang_rc result = EXT_LANG_RC_NOP;
   enum string_repr_result print_result;
 
-  /* No pretty-printer support for unavailable values.  */
-  if (!value_bytes_available (val, embedded_offset, TYPE_LENGTH (type)))
+  /* No pretty-printer support for unavailable values.  A lazy value
+     has not been read yet; the printer reads what it needs.  */
+  if (!value_lazy (val)
+      && !value_bytes_available (val, embedded_offset, TYPE_LENGTH (type)))
     return EXT_LANG_RC_NOP;
 
   if (!gdb_python_initialized)
@@ -864,3 +1321,14 @@ gdbpy_default_visualizer (PyObject *self, PyObject *args)
   cons = find_pretty_printer (val_obj);
   return cons;
 }
+
+/* Initialize the pretty-printer lookup cache.  */
+
+int
+gdbpy_initialize_prettyprint (void)
+{
+  observer_attach_new_objfile (pretty_printer_cache_objfile_changed);
+  observer_attach_free_objfile (pretty_printer_cache_objfile_changed);
+
+  return 0;
+}
@@ -991,6 +991,131 @@ valpy_fetch_lazy (PyObject *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+/* Return in *CONTENTS and *LENGTH the bytes of VALUE, fetching it
+   first if it is lazy.  The returned pointer refers to the value's
+   own contents buffer, which stays valid for as long as VALUE is
+   alive.  Values with bytes that are optimized out or unavailable
+   have no buffer: their contents hold placeholders, not the bytes of
+   the program.  Returns -1 with a Python exception set on error, 0
+   otherwise.  */
+
+static int
+valpy_get_contents (struct value *value, const gdb_byte **contents,
+		    Py_ssize_t *length)
+{
+  TRY
+    {
+      struct type *type = check_typedef (value_type (value));
+      const gdb_byte *bytes = value_contents_for_printing (value);
+      int offset = value_embedded_offset (value);
+
+      if (value_bits_any_optimized_out (value,
+					TARGET_CHAR_BIT * offset,
+					TARGET_CHAR_BIT * TYPE_LENGTH (type)))
+	error_value_optimized_out ();
+      if (!value_bytes_available (value, offset, TYPE_LENGTH (type)))
+	throw_error (NOT_AVAILABLE_ERROR, _("value is not available"));
+
+      *contents = bytes + offset;
+      *length = TYPE_LENGTH (type);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      gdbpy_convert_exception (except);
+      return -1;
+    }
+  END_CATCH
+
+  return 0;
+}
+
+#ifdef IS_PY3K
+
+/* Implementation of the buffer protocol for gdb.Value.  The buffer
+   exposes the value's contents directly, without copying them, and
+   is always read-only.  */
+
+static int
+valpy_get_buffer (PyObject *self, Py_buffer *buf, int flags)
+{
+  struct value *value = ((value_object *) self)->value;
+  const gdb_byte *contents;
+  Py_ssize_t length;
+
+  if (valpy_get_contents (value, &contents, &length) < 0)
+    {
+      buf->obj = NULL;
+      return -1;
+    }
+
+  if (PyBuffer_FillInfo (buf, self, (void *) contents, length, 1,
+			 flags) < 0)
+    return -1;
+  if ((flags & PyBUF_FORMAT) == PyBUF_FORMAT)
+    buf->format = "B";
+
+  return 0;
+}
+
+#else
+
+static Py_ssize_t
+valpy_get_read_buffer (PyObject *self, Py_ssize_t segment, void **ptrptr)
+{
+  struct value *value = ((value_object *) self)->value;
+  const gdb_byte *contents;
+  Py_ssize_t length;
+
+  if (segment)
+    {
+      PyErr_SetString (PyExc_SystemError,
+		       _("The value buffer supports only one segment."));
+      return -1;
+    }
+
+  if (valpy_get_contents (value, &contents, &length) < 0)
+    return -1;
+
+  *ptrptr = (void *) contents;
+
+  return length;
+}
+
+static Py_ssize_t
+valpy_get_seg_count (PyObject *self, Py_ssize_t *lenp)
+{
+  if (lenp)
+    {
+      struct value *value = ((value_object *) self)->value;
+      const gdb_byte *contents;
+
+      /* The segment count callback cannot report errors, so a value
+	 that cannot be fetched reports an empty buffer here and the
+	 error surfaces from the read buffer callback instead.  */
+      if (valpy_get_contents (value, &contents, lenp) < 0)
+	{
+	  PyErr_Clear ();
+	  *lenp = 0;
+	}
+    }
+
+  return 1;
+}
+
+static Py_ssize_t
+valpy_get_char_buffer (PyObject *self, Py_ssize_t segment, char **ptrptr)
+{
+  void *ptr = NULL;
+  Py_ssize_t ret;
+
+  ret = valpy_get_read_buffer (self, segment, &ptr);
+  *ptrptr = (char *) ptr;
+
+  return ret;
+}
+
+#endif	/* IS_PY3K */
+
 /* Calculate and return the address of the PyObject as the value of
    the builtin __hash__ call.  */
 static Py_hash_t
@@ -1844,6 +1969,32 @@ static PyMappingMethods value_object_as_mapping = {
   valpy_setitem
 };
 
+#ifdef IS_PY3K
+
+static PyBufferProcs value_object_as_buffer =
+{
+  valpy_get_buffer
+};
+
+#else
+
+/* Python doesn't provide a decent way to get compatibility here.  */
+#if HAVE_LIBPYTHON2_4
+#define CHARBUFFERPROC_NAME getcharbufferproc
+#else
+#define CHARBUFFERPROC_NAME charbufferproc
+#endif
+
+static PyBufferProcs value_object_as_buffer = {
+  valpy_get_read_buffer,
+  NULL,
+  valpy_get_seg_count,
+  /* The cast here works around a difference between Python 2.4 and
+     Python 2.5.  */
+  (CHARBUFFERPROC_NAME) valpy_get_char_buffer
+};
+#endif	/* IS_PY3K */
+
 PyTypeObject value_object_type = {
   PyVarObject_HEAD_INIT (NULL, 0)
   "gdb.Value",			  /*tp_name*/
@@ -1863,7 +2014,7 @@ PyTypeObject value_object_type = {
   valpy_str,			  /*tp_str*/
   0,				  /*tp_getattro*/
   0,				  /*tp_setattro*/
-  0,				  /*tp_as_buffer*/
+  &value_object_as_buffer,	  /*tp_as_buffer*/
   Py_TPFLAGS_DEFAULT | Py_TPFLAGS_CHECKTYPES
   | Py_TPFLAGS_BASETYPE,	  /*tp_flags*/
   "GDB value object",		  /* tp_doc */
@@ -56,6 +56,10 @@ static const char *const python_excp_enums[] =
    the default.  */
 static const char *gdbpy_should_print_stack = python_excp_message;
 
+/* Non-zero if the results of pretty-printer lookups may be cached by
+   type.  Controlled by "set python pretty-printer-cache".  */
+static int gdbpy_pretty_printer_cache = 1;
+
 #ifdef HAVE_PYTHON
 /* Forward decls, these are defined later.  */
 extern const struct extension_language_script_ops python_extension_script_ops;
@@ -116,6 +120,7 @@ PyObject *gdb_python_module;
 /* Some string constants we may wish to use.  */
 PyObject *gdbpy_to_string_cst;
 PyObject *gdbpy_children_cst;
+PyObject *gdbpy_children_ranges_cst;
 PyObject *gdbpy_display_hint_cst;
 PyObject *gdbpy_doc_cst;
 PyObject *gdbpy_enabled_cst;
@@ -355,6 +360,8 @@ python_interactive_command (char *arg, int from_tty)
       dont_repeat ();
     }
 
+  gdbpy_invalidate_pretty_printer_cache ();
+
   if (err)
     {
       gdbpy_print_stack ();
@@ -386,6 +393,7 @@ python_run_simple_file (FILE *file, const char *filename)
 #ifndef _WIN32
 
   PyRun_SimpleFile (file, filename);
+  gdbpy_invalidate_pretty_printer_cache ();
 
 #else /* _WIN32 */
 
@@ -407,6 +415,7 @@ python_run_simple_file (FILE *file, const char *filename)
 
   make_cleanup_py_decref (python_file);
   PyRun_SimpleFile (PyFile_AsFile (python_file), filename);
+  gdbpy_invalidate_pretty_printer_cache ();
   do_cleanups (cleanup);
 
 #endif /* _WIN32 */
@@ -460,6 +469,7 @@ gdbpy_eval_from_control_command (const struct extension_language_defn *extlang,
 
   script = compute_python_string (cmd->body_list[0]);
   ret = PyRun_SimpleString (script);
+  gdbpy_invalidate_pretty_printer_cache ();
   xfree (script);
   if (ret)
     error (_("Error while executing Python code."));
@@ -482,7 +492,10 @@ python_command (char *arg, int from_tty)
   arg = skip_spaces (arg);
   if (arg && *arg)
     {
-      if (PyRun_SimpleString (arg))
+      int ret = PyRun_SimpleString (arg);
+
+      gdbpy_invalidate_pretty_printer_cache ();
+      if (ret)
 	error (_("Error while executing Python code."));
     }
   else
@@ -1191,6 +1204,14 @@ gdbpy_print_python_errors_p (void)
   return gdbpy_should_print_stack != python_excp_none;
 }
 
+/* Return non-zero if pretty-printer lookups may be cached.  */
+
+int
+gdbpy_pretty_printer_cache_enabled_p (void)
+{
+  return gdbpy_pretty_printer_cache;
+}
+
 /* Print a python exception trace, print just a message, or print
    nothing and clear the python exception, depending on
    gdbpy_should_print_stack.  Only call this if a python exception is
@@ -1353,6 +1374,7 @@ gdbpy_execute_objfile_script (const struct extension_language_defn *extlang,
   gdbpy_current_objfile = objfile;
 
   PyRun_SimpleString (script);
+  gdbpy_invalidate_pretty_printer_cache ();
 
   do_cleanups (cleanups);
   gdbpy_current_objfile = NULL;
@@ -1706,6 +1728,18 @@ message == an error message without a stack will be printed."),
 			&user_set_python_list,
 			&user_show_python_list);
 
+  add_setshow_boolean_cmd ("pretty-printer-cache", no_class,
+			   &gdbpy_pretty_printer_cache, _("\
+Set whether pretty-printer lookups are cached by type."), _("\
+Show whether pretty-printer lookups are cached by type."), _("\
+When on, the lookup function that recognized a value is remembered for\n\
+the value's type, and other values of that type are only offered to\n\
+that function.  Turn this off if a lookup function chooses a printer\n\
+based on the contents of a value rather than only on its type."),
+			   NULL, NULL,
+			   &user_set_python_list,
+			   &user_show_python_list);
+
 #ifdef HAVE_PYTHON
 #ifdef WITH_PYTHON_PATH
   /* Work around problem where python gets confused about where it is,
@@ -1829,7 +1863,8 @@ message == an error message without a stack will be printed."),
       || gdbpy_initialize_clear_objfiles_event ()  < 0
       || gdbpy_initialize_arch () < 0
       || gdbpy_initialize_xmethods () < 0
-      || gdbpy_initialize_unwind () < 0)
+      || gdbpy_initialize_unwind () < 0
+      || gdbpy_initialize_prettyprint () < 0)
     goto fail;
 
   gdbpy_to_string_cst = PyString_FromString ("to_string");
@@ -1838,6 +1873,9 @@ message == an error message without a stack will be printed."),
   gdbpy_children_cst = PyString_FromString ("children");
   if (gdbpy_children_cst == NULL)
     goto fail;
+  gdbpy_children_ranges_cst = PyString_FromString ("children_ranges");
+  if (gdbpy_children_ranges_cst == NULL)
+    goto fail;
   gdbpy_display_hint_cst = PyString_FromString ("display_hint");
   if (gdbpy_display_hint_cst == NULL)
     goto fail;
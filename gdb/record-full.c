@@ -2613,7 +2613,7 @@ record_full_save (struct target_ops *self, const char *recfilename)
   bfd_section_lma (obfd, osec) = 0;
 
   /* Save corefile state.  */
-  write_gcore_file (obfd);
+  write_gcore_file (obfd, 0, NULL);
 
   /* Write out the record log.  */
   /* Write the magic code.  */
@@ -35,6 +35,7 @@ struct value;
 struct frame_info;
 struct agent_expr;
 struct axs_value;
+struct trigram_query;
 
 /* Comparison function for symbol look ups.  */
 
@@ -284,12 +285,17 @@ struct quick_symbol_functions
 
      Otherwise, this symbol's symbol table is expanded.
 
+     If QUERY is not NULL, SYMBOL_MATCHER only accepts names containing
+     all the trigrams of QUERY, so symbols whose names do not may be
+     skipped without calling it.
+
      DATA is user data that is passed unmodified to the callback
      functions.  */
   void (*expand_symtabs_matching)
     (struct objfile *objfile,
      expand_symtabs_file_matcher_ftype *file_matcher,
      expand_symtabs_symbol_matcher_ftype *symbol_matcher,
+     const struct trigram_query *query,
      expand_symtabs_exp_notify_ftype *expansion_notify,
      enum search_domain kind,
      void *data);
@@ -578,6 +584,7 @@ extern struct cleanup *increment_reading_symtab (void);
 
 void expand_symtabs_matching (expand_symtabs_file_matcher_ftype *,
 			      expand_symtabs_symbol_matcher_ftype *,
+			      const struct trigram_query *,
 			      expand_symtabs_exp_notify_ftype *,
 			      enum search_domain kind, void *data);
 
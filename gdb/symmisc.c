@@ -150,6 +150,9 @@ print_objfile_statistics (void)
     printf_filtered (_("  Total memory used for psymbol cache: %d\n"),
 		     bcache_memory_used (psymbol_bcache_get_bcache
 		                          (objfile->psymbol_cache)));
+    printf_filtered (_("  Total memory used for psymbol names: %s\n"),
+		     pulongest (psymbol_bcache_names_memory_used
+				(objfile->psymbol_cache)));
     printf_filtered (_("  Total memory used for macro cache: %d\n"),
 		     bcache_memory_used (objfile->per_bfd->macro_cache));
     printf_filtered (_("  Total memory used for file name cache: %d\n"),
@@ -926,7 +929,8 @@ maintenance_expand_symtabs (char *args, int from_tty)
 	{
 	  objfile->sf->qf->expand_symtabs_matching
 	    (objfile, maintenance_expand_file_matcher,
-	     maintenance_expand_name_matcher, NULL, ALL_DOMAIN, regexp);
+	     maintenance_expand_name_matcher, NULL, NULL, ALL_DOMAIN,
+	     regexp);
 	}
     }
 
@@ -61,6 +61,8 @@
 
 #include "parser-defs.h"
 #include "completer.h"
+#include "trigram.h"
+#include "worker-threads.h"
 
 /* Forward declarations for local functions.  */
 
@@ -708,7 +710,7 @@ create_demangled_names_hash (struct objfile *objfile)
    then set the language appropriately.  The returned name is allocated
    by the demangler and should be xfree'd.  */
 
-static char *
+char *
 symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 			    const char *mangled)
 {
@@ -4437,8 +4439,266 @@ struct search_symbols_data
   /* It is true if PREG contains valid data, false otherwise.  */
   unsigned preg_p : 1;
   regex_t preg;
+
+  /* If PREG just matches a literal string, this is that string, and
+     names are matched with string comparisons instead of PREG.
+     LITERAL_START and LITERAL_END are true if the string must start
+     and end the name.  */
+  char *literal;
+  size_t literal_len;
+  unsigned literal_start : 1;
+  unsigned literal_end : 1;
+
+  /* Otherwise, this holds the results of matching PREG against names,
+     as struct search_symbols_match objects allocated on
+     MATCHES_OBSTACK, keyed by the contents of the name.  A function
+     or variable usually has a partial, a full and a minimal symbol
+     of the same name, so most names are matched just once.  */
+  htab_t matches;
+  struct obstack matches_obstack;
+
+  /* Copies of PREG for the work items of search_minsyms_worker,
+     NPREGS of them, since concurrent calls to regexec must not share
+     a pattern buffer.  */
+  regex_t *pregs;
+  int npregs;
 };
 
+/* The result of matching a name in search_symbols.  */
+
+struct search_symbols_match
+{
+  const char *name;
+  int matches;
+};
+
+/* Hash function for search_symbols_data.matches.  */
+
+static hashval_t
+hash_search_symbols_match (const void *p)
+{
+  const struct search_symbols_match *match
+    = (const struct search_symbols_match *) p;
+
+  return htab_hash_string (match->name);
+}
+
+/* Equality function for search_symbols_data.matches.  */
+
+static int
+eq_search_symbols_match (const void *a, const void *b)
+{
+  const struct search_symbols_match *match_a
+    = (const struct search_symbols_match *) a;
+  const struct search_symbols_match *match_b
+    = (const struct search_symbols_match *) b;
+
+  return strcmp (match_a->name, match_b->name) == 0;
+}
+
+/* Set DATA->LITERAL if the regexp REGEXP, which DATA->PREG holds,
+   matches just a literal string, optionally anchored at the start or
+   the end of names.  */
+
+static void
+search_symbols_set_literal (struct search_symbols_data *data,
+			    const char *regexp)
+{
+  const char *start = regexp;
+  const char *end = regexp + strlen (regexp);
+  const char *p;
+
+  data->literal = NULL;
+  data->literal_start = 0;
+  data->literal_end = 0;
+
+  if (case_sensitivity == case_sensitive_off)
+    return;
+
+  if (*start == '^')
+    {
+      data->literal_start = 1;
+      start++;
+    }
+  if (end > start && end[-1] == '$')
+    {
+      data->literal_end = 1;
+      end--;
+    }
+
+  for (p = start; p < end; p++)
+    if (strchr (".[]\\*^$", *p) != NULL)
+      return;
+
+  data->literal = savestring (start, end - start);
+  data->literal_len = end - start;
+}
+
+/* Return non-zero if NAME matches the literal string of DATA, or else
+   the regexp PREG.  This only reads DATA, and may be called by worker
+   threads.  */
+
+static int
+search_symbols_match_name (const struct search_symbols_data *data,
+			   regex_t *preg, const char *name)
+{
+  if (data->literal != NULL)
+    {
+      size_t len;
+
+      if (data->literal_start)
+	{
+	  if (strncmp (name, data->literal, data->literal_len) != 0)
+	    return 0;
+	  return !data->literal_end || name[data->literal_len] == '\0';
+	}
+      if (!data->literal_end)
+	return strstr (name, data->literal) != NULL;
+
+      len = strlen (name);
+      return (len >= data->literal_len
+	      && strcmp (name + len - data->literal_len, data->literal) == 0);
+    }
+
+  return regexec (preg, name, 0, NULL, 0) == 0;
+}
+
+/* Return non-zero if NAME matches the regexp of DATA.  */
+
+static int
+search_symbols_regexec (struct search_symbols_data *data, const char *name)
+{
+  struct search_symbols_match match, **slot;
+
+  if (!data->preg_p)
+    return 1;
+
+  if (data->literal != NULL)
+    return search_symbols_match_name (data, NULL, name);
+
+  match.name = name;
+  slot = ((struct search_symbols_match **)
+	  htab_find_slot (data->matches, &match, INSERT));
+  if (*slot == NULL)
+    {
+      *slot = XOBNEW (&data->matches_obstack, struct search_symbols_match);
+      (*slot)->name = name;
+      (*slot)->matches = search_symbols_match_name (data, &data->preg, name);
+    }
+  return (*slot)->matches;
+}
+
+/* Objfiles with fewer minimal symbols than this are searched by the
+   main thread alone.  */
+
+#define SEARCH_MINSYMS_PARALLEL_MIN 4096
+
+/* The minimal symbols of an objfile whose names search_minsyms_worker
+   matches against the regexp of DATA.  */
+
+struct search_minsyms_work
+{
+  struct search_symbols_data *data;
+  struct objfile *objfile;
+
+  /* The indices of the minimal symbols to match in the msymbols of
+     OBJFILE, or NULL to match the first N of them.  */
+  const int *indices;
+  int n;
+
+  /* The types of the minimal symbols searched for.  */
+  const enum minimal_symbol_type *types;
+
+  /* The number of work items the symbols are split into.  */
+  int nitems;
+
+  /* For each minimal symbol, 1 if it has one of TYPES and a matching
+     name, 0 if not, or -1 if the main thread must match its name.  */
+  signed char *results;
+};
+
+/* Match the names of the minimal symbols of work item ITEM of the
+   search_minsyms_work P.  This runs in parallel_for_each.  */
+
+static void
+search_minsyms_worker (int item, void *p)
+{
+  struct search_minsyms_work *work = (struct search_minsyms_work *) p;
+  struct search_symbols_data *data = work->data;
+  regex_t *preg = data->literal != NULL ? NULL : &data->pregs[item];
+  int begin = (int) ((long long) work->n * item / work->nitems);
+  int end = (int) ((long long) work->n * (item + 1) / work->nitems);
+  int j;
+
+  for (j = begin; j < end; j++)
+    {
+      struct minimal_symbol *msymbol
+	= &work->objfile->per_bfd->msymbols[work->indices != NULL
+					    ? work->indices[j] : j];
+      enum minimal_symbol_type type = MSYMBOL_TYPE (msymbol);
+
+      if (msymbol->created_by_gdb
+	  || (type != work->types[0] && type != work->types[1]
+	      && type != work->types[2] && type != work->types[3]))
+	work->results[j] = 0;
+      /* The natural name of an Ada symbol is computed and cached the
+	 first time it is needed, which only the main thread may do.  */
+      else if (MSYMBOL_LANGUAGE (msymbol) == language_ada)
+	work->results[j] = -1;
+      else
+	work->results[j]
+	  = search_symbols_match_name (data, preg,
+				       MSYMBOL_NATURAL_NAME (msymbol));
+    }
+}
+
+/* Match the names of minimal symbols of OBJFILE of one of the four
+   TYPES against the regexp of DATA, using the worker threads.  Match
+   the minimal symbols whose indices are in INDICES, or the first N if
+   INDICES is NULL.  Return an xmalloc'd array of the results, as
+   described in struct search_minsyms_work, or NULL if the symbols
+   are better matched by the main thread alone.  */
+
+static signed char *
+search_minsyms_parallel (struct search_symbols_data *data,
+			 struct objfile *objfile, const int *indices, int n,
+			 const enum minimal_symbol_type *types)
+{
+  struct search_minsyms_work work;
+
+  if (!data->preg_p || n < SEARCH_MINSYMS_PARALLEL_MIN)
+    return NULL;
+
+  work.nitems = worker_thread_count ();
+  if (data->literal == NULL && data->npregs < work.nitems)
+    work.nitems = data->npregs;
+  if (work.nitems < 2)
+    return NULL;
+
+  work.data = data;
+  work.objfile = objfile;
+  work.indices = indices;
+  work.n = n;
+  work.types = types;
+  work.results = XNEWVEC (signed char, n);
+  parallel_for_each (work.nitems, search_minsyms_worker, &work);
+  return work.results;
+}
+
+/* A cleanup function freeing the copies of the regexp of the
+   search_symbols_data P.  */
+
+static void
+free_search_symbols_pregs (void *p)
+{
+  struct search_symbols_data *data = (struct search_symbols_data *) p;
+  int i;
+
+  for (i = 0; i < data->npregs; i++)
+    regfree (&data->pregs[i]);
+  xfree (data->pregs);
+}
+
 /* A callback for expand_symtabs_matching.  */
 
 static int
@@ -4457,7 +4717,7 @@ search_symbols_name_matches (const char *symname, void *user_data)
 {
   struct search_symbols_data *data = (struct search_symbols_data *) user_data;
 
-  return !data->preg_p || regexec (&data->preg, symname, 0, NULL, 0) == 0;
+  return search_symbols_regexec (data, symname);
 }
 
 /* Search the symbol table for matches to the regular expression REGEXP,
@@ -4502,10 +4762,15 @@ search_symbols (const char *regexp, enum search_domain kind,
   enum minimal_symbol_type ourtype2;
   enum minimal_symbol_type ourtype3;
   enum minimal_symbol_type ourtype4;
+  enum minimal_symbol_type ourtypes[4];
   struct symbol_search *found;
   struct symbol_search *tail;
   struct search_symbols_data datum;
   int nfound;
+  /* The trigrams that matching names contain, if known.  */
+  struct trigram_query *query = NULL;
+  /* The minimal symbols of an objfile which may match QUERY.  */
+  VEC (int) *candidates = NULL;
 
   /* OLD_CHAIN .. RETVAL_CHAIN is always freed, RETVAL_CHAIN .. current
      CLEANUP_CHAIN is freed only in the case of an error.  */
@@ -4518,9 +4783,16 @@ search_symbols (const char *regexp, enum search_domain kind,
   ourtype2 = types2[kind];
   ourtype3 = types3[kind];
   ourtype4 = types4[kind];
+  ourtypes[0] = ourtype;
+  ourtypes[1] = ourtype2;
+  ourtypes[2] = ourtype3;
+  ourtypes[3] = ourtype4;
 
   *matches = NULL;
   datum.preg_p = 0;
+  datum.pregs = NULL;
+  datum.npregs = 0;
+  make_cleanup (VEC_cleanup (int), &candidates);
 
   if (regexp != NULL)
     {
@@ -4571,6 +4843,39 @@ search_symbols (const char *regexp, enum search_domain kind,
 	}
       datum.preg_p = 1;
       make_regfree_cleanup (&datum.preg);
+
+      query = trigram_query_from_regexp (regexp, (case_sensitivity
+						  == case_sensitive_off));
+      make_cleanup_trigram_query_free (query);
+
+      search_symbols_set_literal (&datum, regexp);
+      if (datum.literal != NULL)
+	make_cleanup (xfree, datum.literal);
+      else
+	{
+	  datum.matches = htab_create_alloc (1024, hash_search_symbols_match,
+					     eq_search_symbols_match, NULL,
+					     xcalloc, xfree);
+	  make_cleanup_htab_delete (datum.matches);
+	  obstack_init (&datum.matches_obstack);
+	  make_cleanup_obstack_free (&datum.matches_obstack);
+
+	  /* Each worker thread matching minimal symbols needs its own
+	     copy of the regexp.  */
+	  if (nfiles == 0 && worker_thread_count () > 1)
+	    {
+	      int count = worker_thread_count ();
+
+	      datum.pregs = XNEWVEC (regex_t, count);
+	      make_cleanup (free_search_symbols_pregs, &datum);
+	      while (datum.npregs < count
+		     && regcomp (&datum.pregs[datum.npregs], regexp,
+				 REG_NOSUB
+				 | (case_sensitivity == case_sensitive_off
+				    ? REG_ICASE : 0)) == 0)
+		datum.npregs++;
+	    }
+	}
     }
 
   /* Search through the partial symtabs *first* for all symbols
@@ -4582,7 +4887,7 @@ search_symbols (const char *regexp, enum search_domain kind,
   expand_symtabs_matching ((nfiles == 0
 			    ? NULL
 			    : search_symbols_file_matches),
-			   search_symbols_name_matches,
+			   search_symbols_name_matches, query,
 			   NULL, kind, &datum);
 
   /* Here, we search through the minimal symbol tables for functions
@@ -4603,35 +4908,64 @@ search_symbols (const char *regexp, enum search_domain kind,
 
   if (nfiles == 0 && (kind == VARIABLES_DOMAIN || kind == FUNCTIONS_DOMAIN))
     {
-      ALL_MSYMBOLS (objfile, msymbol)
-      {
-        QUIT;
+      ALL_OBJFILES (objfile)
+	{
+	  int filtered = minimal_symbol_trigram_candidates (objfile, query,
+							    &candidates);
+	  int n = (filtered
+		   ? VEC_length (int, candidates)
+		   : objfile->per_bfd->minimal_symbol_count);
+	  signed char *results;
+	  struct cleanup *results_chain;
+	  int j;
+
+	  results = search_minsyms_parallel (&datum, objfile,
+					     (filtered
+					      ? VEC_address (int, candidates)
+					      : NULL),
+					     n, ourtypes);
+	  results_chain = make_cleanup (xfree, results);
+
+	  for (j = 0; j < n; j++)
+	    {
+	      msymbol = &objfile->per_bfd->msymbols[filtered
+						    ? VEC_index (int,
+								 candidates, j)
+						    : j];
+	      QUIT;
 
-	if (msymbol->created_by_gdb)
-	  continue;
+	      if (results != NULL && results[j] == 0)
+		continue;
 
-	if (MSYMBOL_TYPE (msymbol) == ourtype
-	    || MSYMBOL_TYPE (msymbol) == ourtype2
-	    || MSYMBOL_TYPE (msymbol) == ourtype3
-	    || MSYMBOL_TYPE (msymbol) == ourtype4)
-	  {
-	    if (!datum.preg_p
-		|| regexec (&datum.preg, MSYMBOL_NATURAL_NAME (msymbol), 0,
-			    NULL, 0) == 0)
-	      {
-		/* Note: An important side-effect of these lookup functions
-		   is to expand the symbol table if msymbol is found, for the
-		   benefit of the next loop on ALL_COMPUNITS.  */
-		if (kind == FUNCTIONS_DOMAIN
-		    ? (find_pc_compunit_symtab
-		       (MSYMBOL_VALUE_ADDRESS (objfile, msymbol)) == NULL)
-		    : (lookup_symbol_in_objfile_from_linkage_name
-		       (objfile, MSYMBOL_LINKAGE_NAME (msymbol), VAR_DOMAIN)
-		       .symbol == NULL))
-		  found_misc = 1;
-	      }
-	  }
-      }
+	      if (msymbol->created_by_gdb)
+		continue;
+
+	      if (MSYMBOL_TYPE (msymbol) == ourtype
+		  || MSYMBOL_TYPE (msymbol) == ourtype2
+		  || MSYMBOL_TYPE (msymbol) == ourtype3
+		  || MSYMBOL_TYPE (msymbol) == ourtype4)
+		{
+		  if ((results != NULL && results[j] > 0)
+		      || search_symbols_regexec (&datum,
+						 MSYMBOL_NATURAL_NAME (msymbol)))
+		    {
+		      /* Note: An important side-effect of these lookup
+			 functions is to expand the symbol table if msymbol
+			 is found, for the benefit of the next loop on
+			 ALL_COMPUNITS.  */
+		      if (kind == FUNCTIONS_DOMAIN
+			  ? (find_pc_compunit_symtab
+			     (MSYMBOL_VALUE_ADDRESS (objfile, msymbol)) == NULL)
+			  : (lookup_symbol_in_objfile_from_linkage_name
+			     (objfile, MSYMBOL_LINKAGE_NAME (msymbol),
+			      VAR_DOMAIN).symbol == NULL))
+			found_misc = 1;
+		    }
+		}
+	    }
+
+	  do_cleanups (results_chain);
+	}
     }
 
   found = NULL;
@@ -4651,31 +4985,30 @@ search_symbols (const char *regexp, enum search_domain kind,
 
 	    QUIT;
 
-	    /* Check first sole REAL_SYMTAB->FILENAME.  It does not need to be
-	       a substring of symtab_to_fullname as it may contain "./" etc.  */
-	    if ((file_matches (real_symtab->filename, files, nfiles, 0)
-		 || ((basenames_may_differ
-		      || file_matches (lbasename (real_symtab->filename),
-				       files, nfiles, 1))
-		     && file_matches (symtab_to_fullname (real_symtab),
-				      files, nfiles, 0)))
-		&& ((!datum.preg_p
-		     || regexec (&datum.preg, SYMBOL_NATURAL_NAME (sym), 0,
-				 NULL, 0) == 0)
-		    && ((kind == VARIABLES_DOMAIN
-			 && SYMBOL_CLASS (sym) != LOC_TYPEDEF
-			 && SYMBOL_CLASS (sym) != LOC_UNRESOLVED
-			 && SYMBOL_CLASS (sym) != LOC_BLOCK
-			 /* LOC_CONST can be used for more than just enums,
-			    e.g., c++ static const members.
-			    We only want to skip enums here.  */
-			 && !(SYMBOL_CLASS (sym) == LOC_CONST
-			      && (TYPE_CODE (SYMBOL_TYPE (sym))
-				  == TYPE_CODE_ENUM)))
-			|| (kind == FUNCTIONS_DOMAIN 
-			    && SYMBOL_CLASS (sym) == LOC_BLOCK)
-			|| (kind == TYPES_DOMAIN
-			    && SYMBOL_CLASS (sym) == LOC_TYPEDEF))))
+	    /* Check the cheap conditions first.  Check first sole
+	       REAL_SYMTAB->FILENAME.  It does not need to be a substring
+	       of symtab_to_fullname as it may contain "./" etc.  */
+	    if (((kind == VARIABLES_DOMAIN
+		  && SYMBOL_CLASS (sym) != LOC_TYPEDEF
+		  && SYMBOL_CLASS (sym) != LOC_UNRESOLVED
+		  && SYMBOL_CLASS (sym) != LOC_BLOCK
+		  /* LOC_CONST can be used for more than just enums,
+		     e.g., c++ static const members.
+		     We only want to skip enums here.  */
+		  && !(SYMBOL_CLASS (sym) == LOC_CONST
+		       && (TYPE_CODE (SYMBOL_TYPE (sym))
+			   == TYPE_CODE_ENUM)))
+		 || (kind == FUNCTIONS_DOMAIN 
+		     && SYMBOL_CLASS (sym) == LOC_BLOCK)
+		 || (kind == TYPES_DOMAIN
+		     && SYMBOL_CLASS (sym) == LOC_TYPEDEF))
+		&& (file_matches (real_symtab->filename, files, nfiles, 0)
+		    || ((basenames_may_differ
+			 || file_matches (lbasename (real_symtab->filename),
+					  files, nfiles, 1))
+			&& file_matches (symtab_to_fullname (real_symtab),
+					 files, nfiles, 0)))
+		&& search_symbols_regexec (&datum, SYMBOL_NATURAL_NAME (sym)))
 	      {
 		/* match */
 		struct symbol_search *psr = XCNEW (struct symbol_search);
@@ -4705,49 +5038,80 @@ search_symbols (const char *regexp, enum search_domain kind,
 
   if (found_misc || (nfiles == 0 && kind != FUNCTIONS_DOMAIN))
     {
-      ALL_MSYMBOLS (objfile, msymbol)
-      {
-        QUIT;
+      ALL_OBJFILES (objfile)
+	{
+	  int filtered = minimal_symbol_trigram_candidates (objfile, query,
+							    &candidates);
+	  int n = (filtered
+		   ? VEC_length (int, candidates)
+		   : objfile->per_bfd->minimal_symbol_count);
+	  signed char *results;
+	  struct cleanup *results_chain;
+	  int j;
+
+	  results = search_minsyms_parallel (&datum, objfile,
+					     (filtered
+					      ? VEC_address (int, candidates)
+					      : NULL),
+					     n, ourtypes);
+	  results_chain = make_cleanup (xfree, results);
+
+	  for (j = 0; j < n; j++)
+	    {
+	      msymbol = &objfile->per_bfd->msymbols[filtered
+						    ? VEC_index (int,
+								 candidates, j)
+						    : j];
+	      QUIT;
 
-	if (msymbol->created_by_gdb)
-	  continue;
+	      if (results != NULL && results[j] == 0)
+		continue;
 
-	if (MSYMBOL_TYPE (msymbol) == ourtype
-	    || MSYMBOL_TYPE (msymbol) == ourtype2
-	    || MSYMBOL_TYPE (msymbol) == ourtype3
-	    || MSYMBOL_TYPE (msymbol) == ourtype4)
-	  {
-	    if (!datum.preg_p
-		|| regexec (&datum.preg, MSYMBOL_NATURAL_NAME (msymbol), 0,
-			    NULL, 0) == 0)
-	      {
-		/* For functions we can do a quick check of whether the
-		   symbol might be found via find_pc_symtab.  */
-		if (kind != FUNCTIONS_DOMAIN
-		    || (find_pc_compunit_symtab
-			(MSYMBOL_VALUE_ADDRESS (objfile, msymbol)) == NULL))
-		  {
-		    if (lookup_symbol_in_objfile_from_linkage_name
-			(objfile, MSYMBOL_LINKAGE_NAME (msymbol), VAR_DOMAIN)
-			.symbol == NULL)
-		      {
-			/* match */
-			struct symbol_search *psr = XNEW (struct symbol_search);
-			psr->block = i;
-			psr->msymbol.minsym = msymbol;
-			psr->msymbol.objfile = objfile;
-			psr->symbol = NULL;
-			psr->next = NULL;
-			if (tail == NULL)
-			  found = psr;
-			else
-			  tail->next = psr;
-			tail = psr;
-		      }
-		  }
-	      }
-	  }
-      }
+	      if (msymbol->created_by_gdb)
+		continue;
+
+	      if (MSYMBOL_TYPE (msymbol) == ourtype
+		  || MSYMBOL_TYPE (msymbol) == ourtype2
+		  || MSYMBOL_TYPE (msymbol) == ourtype3
+		  || MSYMBOL_TYPE (msymbol) == ourtype4)
+		{
+		  if ((results != NULL && results[j] > 0)
+		      || search_symbols_regexec (&datum,
+						 MSYMBOL_NATURAL_NAME (msymbol)))
+		    {
+		      /* For functions we can do a quick check of whether the
+			 symbol might be found via find_pc_symtab.  */
+		      if (kind != FUNCTIONS_DOMAIN
+			  || (find_pc_compunit_symtab
+			      (MSYMBOL_VALUE_ADDRESS (objfile, msymbol))
+			      == NULL))
+			{
+			  if (lookup_symbol_in_objfile_from_linkage_name
+			      (objfile, MSYMBOL_LINKAGE_NAME (msymbol),
+			       VAR_DOMAIN).symbol == NULL)
+			    {
+			      /* match */
+			      struct symbol_search *psr
+				= XNEW (struct symbol_search);
+
+			      psr->block = i;
+			      psr->msymbol.minsym = msymbol;
+			      psr->msymbol.objfile = objfile;
+			      psr->symbol = NULL;
+			      psr->next = NULL;
+			      if (tail == NULL)
+				found = psr;
+			      else
+				tail->next = psr;
+			      tail = psr;
+			    }
+			}
+		    }
+		}
+	    }
+
+	  do_cleanups (results_chain);
+	}
     }
 
   discard_cleanups (retval_chain);
@@ -5468,7 +5832,7 @@ default_make_symbol_completion_list_break_on_1 (const char *text,
      by matching SYM_TEXT.  Expand all CUs that you find to the list.
      symtab_expansion_callback is called for each expanded symtab,
      causing those symtab's completions to be added to the list too.  */
-  expand_symtabs_matching (NULL, symbol_completion_matcher,
+  expand_symtabs_matching (NULL, symbol_completion_matcher, NULL,
 			   symtab_expansion_callback, ALL_DOMAIN,
 			   &datum);
 
@@ -214,6 +214,13 @@ extern void symbol_set_names (struct general_symbol_info *symbol,
 			      const char *linkage_name, int len, int copy_name,
 			      struct objfile *objfile);
 
+/* Return the demangled name of MANGLED, a name of GSYMBOL, or NULL if
+   it has none.  If the language of GSYMBOL is language_auto, set it
+   to the language whose demangler recognized MANGLED.  The result
+   must be xfree'd.  */
+extern char *symbol_find_demangled_name (struct general_symbol_info *gsymbol,
+					 const char *mangled);
+
 /* Now come lots of name accessor macros.  Short version as to when to
    use which: Use SYMBOL_NATURAL_NAME to refer to the name of the
    symbol in the original source code.  Use SYMBOL_LINKAGE_NAME if you
@@ -813,8 +820,6 @@ struct symbol
      or to have a generic debug info annotation slot for symbols.  */
 
   void *aux_value;
-
-  struct symbol *hash_next;
 };
 
 /* Several lookup functions return both a symbol and the block in which the
@@ -437,3 +437,128 @@ target_write_memory_blocks (VEC(memory_write_request_s) *requests,
 
   return err;
 }
+
+/* Requests passed to target_read_memory_blocks whose addresses are at
+   most this many bytes apart are satisfied with a single read.  */
+
+#define READ_BLOCKS_MAX_GAP 256
+
+/* The largest single read target_read_memory_blocks will make when
+   coalescing requests.  */
+
+#define READ_BLOCKS_MAX_READ (64 * 1024)
+
+/* qsort comparison function for pointers to memory_read_request
+   objects, ordering them by starting address.  */
+
+static int
+compare_read_request_ptrs (const void *a, const void *b)
+{
+  const struct memory_read_request *a_req
+    = *(const struct memory_read_request * const *) a;
+  const struct memory_read_request *b_req
+    = *(const struct memory_read_request * const *) b;
+
+  if (a_req->begin < b_req->begin)
+    return -1;
+  else if (a_req->begin == b_req->begin)
+    return 0;
+  else
+    return 1;
+}
+
+/* Satisfy the requests SORTED[FIRST] to SORTED[LAST - 1], which are
+   sorted by address and lie within [BEGIN, END), with a single read
+   into BUF.  If that read fails, fall back to reading each request on
+   its own.  Return the number of requests that failed.  */
+
+static int
+read_coalesced_requests (struct memory_read_request **sorted,
+			 int first, int last, ULONGEST begin, ULONGEST end,
+			 gdb_byte *buf)
+{
+  int i, failed = 0;
+
+  if (last - first > 1
+      && target_read_memory (begin, buf, end - begin) == 0)
+    {
+      for (i = first; i < last; i++)
+	{
+	  struct memory_read_request *r = sorted[i];
+
+	  memcpy (r->data, buf + (r->begin - begin), r->end - r->begin);
+	  r->status = 0;
+	}
+      return 0;
+    }
+
+  for (i = first; i < last; i++)
+    {
+      struct memory_read_request *r = sorted[i];
+
+      r->status = target_read_memory (r->begin, r->data, r->end - r->begin);
+      if (r->status != 0)
+	failed++;
+    }
+
+  return failed;
+}
+
+/* See target.h.  */
+
+int
+target_read_memory_blocks (VEC(memory_read_request_s) *requests)
+{
+  struct cleanup *back_to;
+  struct memory_read_request **sorted;
+  struct memory_read_request *r;
+  gdb_byte *buf;
+  int i, n, first, failed = 0;
+  ULONGEST begin, end;
+
+  n = VEC_length (memory_read_request_s, requests);
+  if (n == 0)
+    return 0;
+
+  sorted = XNEWVEC (struct memory_read_request *, n);
+  back_to = make_cleanup (xfree, sorted);
+  for (i = 0; VEC_iterate (memory_read_request_s, requests, i, r); ++i)
+    sorted[i] = r;
+  qsort (sorted, n, sizeof (sorted[0]), compare_read_request_ptrs);
+
+  buf = (gdb_byte *) xmalloc (READ_BLOCKS_MAX_READ);
+  make_cleanup (xfree, buf);
+
+  /* Group the requests into runs whose span fits in one read, and
+     whose members are separated by small gaps.  */
+  first = 0;
+  begin = sorted[0]->begin;
+  end = sorted[0]->end;
+  for (i = 1; i <= n; i++)
+    {
+      if (i < n)
+	{
+	  r = sorted[i];
+
+	  if (r->begin <= end + READ_BLOCKS_MAX_GAP
+	      && (r->end > end ? r->end : end) - begin <= READ_BLOCKS_MAX_READ)
+	    {
+	      if (r->end > end)
+		end = r->end;
+	      continue;
+	    }
+	}
+
+      failed += read_coalesced_requests (sorted, first, i, begin, end, buf);
+
+      if (i < n)
+	{
+	  first = i;
+	  begin = sorted[i]->begin;
+	  end = sorted[i]->end;
+	}
+    }
+
+  do_cleanups (back_to);
+  return failed;
+}
@@ -43,6 +43,7 @@
 #include "agent.h"
 #include "auxv.h"
 #include "target-debug.h"
+#include "value.h"
 
 static void target_info (char *, int);
 
@@ -419,6 +420,7 @@ add_deprecated_target_alias (struct target_ops *t, char *alias)
 void
 target_kill (void)
 {
+  fetch_lazy_history_values ();
   current_target.to_kill (&current_target);
 }
 
@@ -1495,6 +1497,8 @@ target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
 int
 target_write_memory (CORE_ADDR memaddr, const gdb_byte *myaddr, ssize_t len)
 {
+  fetch_lazy_history_values ();
+
   /* See comment in target_read_memory about why the request starts at
      current_target.beneath.  */
   if (target_write (current_target.beneath, TARGET_OBJECT_MEMORY, NULL,
@@ -1513,6 +1517,8 @@ target_write_memory (CORE_ADDR memaddr, const gdb_byte *myaddr, ssize_t len)
 int
 target_write_raw_memory (CORE_ADDR memaddr, const gdb_byte *myaddr, ssize_t len)
 {
+  fetch_lazy_history_values ();
+
   /* See comment in target_read_memory about why the request starts at
      current_target.beneath.  */
   if (target_write (current_target.beneath, TARGET_OBJECT_RAW_MEMORY, NULL,
@@ -2201,6 +2207,8 @@ target_preopen (int from_tty)
 {
   dont_repeat ();
 
+  fetch_lazy_history_values ();
+
   if (have_inferiors ())
     {
       if (!from_tty
@@ -2226,7 +2234,9 @@ void
 target_detach (const char *args, int from_tty)
 {
   struct target_ops* t;
-  
+
+  fetch_lazy_history_values ();
+
   if (gdbarch_has_global_breakpoints (target_gdbarch ()))
     /* Don't remove global breakpoints here.  They're removed on
        disconnection from the target.  */
@@ -2244,6 +2254,8 @@ target_detach (const char *args, int from_tty)
 void
 target_disconnect (const char *args, int from_tty)
 {
+  fetch_lazy_history_values ();
+
   /* If we're in breakpoints-always-inserted mode or if breakpoints
      are global across processes, we have to remove them before
      disconnecting.  */
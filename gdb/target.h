@@ -1479,6 +1479,34 @@ int target_write_memory_blocks (VEC(memory_write_request_s) *requests,
 				enum flash_preserve_mode preserve_flash_p,
 				void (*progress_cb) (ULONGEST, void *));
 
+/* Describes a request for a memory read operation.  */
+struct memory_read_request
+  {
+    /* Beginning address that must be read.  */
+    ULONGEST begin;
+    /* Past-the-end address.  */
+    ULONGEST end;
+    /* Buffer of END - BEGIN bytes which receives the data.  */
+    gdb_byte *data;
+    /* Set to 0 if the read succeeded, or to the error code returned
+       by target_read_memory otherwise.  */
+    int status;
+  };
+typedef struct memory_read_request memory_read_request_s;
+DEF_VEC_O(memory_read_request_s);
+
+/* Read several memory blocks.  Requests are sorted, and requests for
+   adjacent or nearby addresses are coalesced into a single
+   target_read_memory call; the others are still read one at a time,
+   as there is no target method for a vectored read.
+
+   REQUESTS is the vector (see vec.h) of memory_read_request.  The
+   status of each request is stored in its STATUS field; a request
+   failing does not prevent the others from being satisfied.
+
+   The function returns the number of requests that failed.  */
+int target_read_memory_blocks (VEC(memory_read_request_s) *requests);
+
 /* Print a line about the current target.  */
 
 #define	target_files_info()	\
@@ -0,0 +1,42 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int v;
+
+static void __attribute__ ((noinline))
+leaf (int x)
+{
+  v = x;
+}
+
+static int __attribute__ ((noinline))
+func (int a, int b)
+{
+  volatile int buf[16];
+
+  buf[0] = a;
+  buf[1] = b;
+  leaf (buf[0] + buf[1]);
+  return buf[0] * buf[1];
+}
+
+int
+main (void)
+{
+  v = func (2, 3);
+  return 0;
+}
@@ -0,0 +1,49 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct item
+{
+  int len;
+  short delta;
+  unsigned char flags;
+};
+
+struct item global_item = { 5, -3, 200 };
+int total;
+int *null_ptr;
+
+int
+consume (struct item *p, int i)
+{
+  total += p->len;
+  return total;
+}
+
+int
+main (void)
+{
+  struct item local_item = { 0, 1, 2 };
+  int i;
+
+  for (i = 0; i < 100; i++)
+    {
+      local_item.len = i;
+      consume (&local_item, i);
+    }
+
+  return 0;
+}
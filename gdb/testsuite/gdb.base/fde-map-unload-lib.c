@@ -0,0 +1,56 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Built twice, as two libraries whose functions have different frame
+   layouts at the same offsets.  */
+
+#ifdef SECOND_LIB
+
+static int __attribute__ ((noinline))
+lib_inner2 (void (*cb) (void), int depth)
+{
+  volatile char buf[256];
+
+  buf[0] = depth;
+  if (depth > 0)
+    return lib_inner2 (cb, depth - 1) + buf[0];
+  cb ();
+  return buf[0];
+}
+
+int
+lib_func2 (void (*cb) (void))
+{
+  return lib_inner2 (cb, 1);
+}
+
+#else
+
+static int __attribute__ ((noinline))
+lib_inner1 (void (*cb) (void))
+{
+  cb ();
+  return 1;
+}
+
+int
+lib_func1 (void (*cb) (void))
+{
+  return lib_inner1 (cb) + 1;
+}
+
+#endif
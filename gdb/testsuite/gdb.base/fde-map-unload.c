@@ -0,0 +1,65 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <dlfcn.h>
+
+int calls;
+
+void
+callback (void)
+{
+  calls++;	/* callback break */
+}
+
+static void
+call_lib (const char *name, const char *func)
+{
+  void *handle;
+  int (*lib_func) (void (*) (void));
+
+  handle = dlopen (name, RTLD_LAZY);
+  if (handle == NULL)
+    {
+      fprintf (stderr, "%s\n", dlerror ());
+      exit (1);
+    }
+
+  lib_func = (int (*) (void (*) (void))) dlsym (handle, func);
+  if (lib_func == NULL)
+    {
+      fprintf (stderr, "%s\n", dlerror ());
+      exit (1);
+    }
+
+  lib_func (callback);
+
+  dlclose (handle);
+}
+
+int
+main (void)
+{
+  call_lib (SHLIB_NAME1, "lib_func1");
+
+  /* The second library is likely loaded where the first one was.  */
+  call_lib (SHLIB_NAME2, "lib_func2");
+
+  callback ();
+  return 0;
+}
@@ -0,0 +1,35 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+
+#define BUFFER_SIZE (16 * 1024 * 1024)
+
+/* Mostly zero, so that most of it can be left out of the core
+   file.  */
+static char buffer[BUFFER_SIZE];
+
+int
+main (void)
+{
+  memset (buffer, 0, BUFFER_SIZE);
+  buffer[1024 * 1024 + 5] = 1;
+  buffer[BUFFER_SIZE / 2] = 2;
+  buffer[BUFFER_SIZE - 1] = 3;
+
+  return 0; /* Break here.  */
+}
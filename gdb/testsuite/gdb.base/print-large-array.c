@@ -0,0 +1,36 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define LARGE_ARRAY_SIZE 100000
+
+int large_array[LARGE_ARRAY_SIZE];
+char large_chars[LARGE_ARRAY_SIZE];
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < LARGE_ARRAY_SIZE; i++)
+    large_array[i] = i < 10 ? i : 7;
+  large_array[LARGE_ARRAY_SIZE - 1] = 42;
+
+  i = 0; /* Break here.  */
+  large_array[0] = 100;
+
+  return 0; /* Break again here.  */
+}
@@ -0,0 +1,39 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+extern int other_gamma (int);
+extern int other_gaama (int);
+
+int search_counter;
+
+int
+search_alpha (int x)
+{
+  return x + search_counter;
+}
+
+int
+search_alphabet (int x)
+{
+  return search_alpha (x) * 2;
+}
+
+int
+main (void)
+{
+  return search_alphabet (other_gamma (0) + other_gaama (1));
+}
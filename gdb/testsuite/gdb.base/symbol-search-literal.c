@@ -0,0 +1,61 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int lit_counter;
+
+int
+lit_alpha (int x)
+{
+  return x + lit_counter;
+}
+
+int
+lit_alphabet (int x)
+{
+  return lit_alpha (x) * 2;
+}
+
+int
+not_lit_alpha (int x)
+{
+  return lit_alphabet (x) - 1;
+}
+
+/* Enough functions that their minimal symbols are matched by the
+   worker threads, if any.  */
+
+#define DEF(N) int many_ ## N (void) { return 0; }
+#define DEF16(N) DEF (N ## 0) DEF (N ## 1) DEF (N ## 2) DEF (N ## 3) \
+  DEF (N ## 4) DEF (N ## 5) DEF (N ## 6) DEF (N ## 7) DEF (N ## 8) \
+  DEF (N ## 9) DEF (N ## a) DEF (N ## b) DEF (N ## c) DEF (N ## d) \
+  DEF (N ## e) DEF (N ## f)
+#define DEF256(N) DEF16 (N ## 0) DEF16 (N ## 1) DEF16 (N ## 2) \
+  DEF16 (N ## 3) DEF16 (N ## 4) DEF16 (N ## 5) DEF16 (N ## 6) \
+  DEF16 (N ## 7) DEF16 (N ## 8) DEF16 (N ## 9) DEF16 (N ## a) \
+  DEF16 (N ## b) DEF16 (N ## c) DEF16 (N ## d) DEF16 (N ## e) \
+  DEF16 (N ## f)
+
+DEF256 (x0) DEF256 (x1) DEF256 (x2) DEF256 (x3)
+DEF256 (x4) DEF256 (x5) DEF256 (x6) DEF256 (x7)
+DEF256 (x8) DEF256 (x9) DEF256 (xa) DEF256 (xb)
+DEF256 (xc) DEF256 (xd) DEF256 (xe) DEF256 (xf)
+
+int
+main (void)
+{
+  return not_lit_alpha (many_x000 ());
+}
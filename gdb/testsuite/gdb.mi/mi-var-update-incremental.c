@@ -0,0 +1,46 @@
+/* Copyright 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct point
+{
+  int x;
+  int y;
+  struct
+  {
+    int a;
+    char b[4];
+  } in;
+};
+
+struct point global_point;
+int global_array[100];
+const char *global_string = "hello";
+
+int
+main (void)
+{
+  struct point local_point = { 1, 2, { 3, "ab" } };
+  int i = 0;
+
+  local_point.x = 10;		/* Break here.  */
+  global_array[5] = 7;		/* Changed local_point.x.  */
+  global_point.in.a = 4;	/* Changed global_array.  */
+  local_point.in.b[1] = 'z';	/* Changed global_point.  */
+  global_string = "bye";	/* Changed local_point.in.b.  */
+  i++;				/* Changed global_string.  */
+  return i;			/* Changed i.  */
+}
@@ -0,0 +1,82 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* At -O0 most of the variables below live at offsets from the frame
+   base.  Optimized, they end up in registers, in pieces of registers,
+   as computed values and as values only known at function entry.  */
+
+#ifndef __GNUC__
+#define __attribute__(x)
+#endif
+
+struct pair
+{
+  long first;
+  long second;
+};
+
+volatile int v;
+long global_counter = 7;
+static int static_value = 11;
+
+void __attribute__ ((noinline))
+marker (void)
+{
+  v++;
+}
+
+long __attribute__ ((noinline))
+use_pair (struct pair p)
+{
+  marker ();
+  return p.first + p.second;
+}
+
+int __attribute__ ((noinline))
+use_entry (int x, int y)
+{
+  int scaled = x * 3 + 1;
+
+  marker ();
+  v = y;
+  return v;
+}
+
+long __attribute__ ((noinline))
+use_locals (long a, char c, double d)
+{
+  long sum = a + c;
+  double half = d / 2;
+  int array[4] = { 1, 2, 3, 4 };
+  struct pair local_pair = { a, sum };
+
+  array[v & 3] += static_value;
+  marker ();
+  return sum + (long) half + array[0] + local_pair.second + global_counter;
+}
+
+int
+main (void)
+{
+  struct pair p = { 40, 2 };
+  long r = 0;
+
+  r += use_pair (p);
+  r += use_entry (5, 6);
+  r += use_locals (100, 'x', 4.5);
+  return r == 0;
+}
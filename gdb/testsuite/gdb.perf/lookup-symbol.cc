@@ -0,0 +1,44 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Define many namespaces, each with a class, functions and variables,
+   so that the global block of the program is large.  */
+
+#include "many-defs.h"
+
+#define DEF1(N)					\
+  namespace ns ## N				\
+  {						\
+    struct cls					\
+    {						\
+      int method (int x);			\
+      static int member;			\
+    };						\
+    int cls::method (int x) { return x + 1; }	\
+    int cls::member;				\
+    int func (int x) { return x + 1; }		\
+    int func (const char *s) { return *s; }	\
+    int var;					\
+  }
+
+DEF4096
+
+int
+main (void)
+{
+  return ns_000000::func (0);
+}
@@ -0,0 +1,51 @@
+# Copyright (C) 2016 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures looking up every symbol of the global block
+# of a large C++ program, and names that are not in it.
+
+import random
+from perftest import perftest
+
+class LookupSymbol(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, count):
+        super(LookupSymbol, self).__init__("lookup-symbol")
+        self.count = count
+        self.block = None
+        self.names = []
+
+    def _lookup_all(self, count, names):
+        for _ in range(count):
+            for name in names:
+                gdb.lookup_global_symbol(name)
+                gdb.lookup_symbol(name, self.block)
+
+    def warm_up(self):
+        # Read all the symbols in, so that only the lookups are
+        # measured.
+        self.block = gdb.lookup_global_symbol("main").symtab.global_block()
+        self.names = [sym.name for sym in self.block]
+        # Don't look the names up in the order of the block, which
+        # would walk its hash table in order.
+        random.Random(0).shuffle(self.names)
+        self._lookup_all(1, self.names)
+
+    def execute_test(self):
+        names = self.names
+        missing = [name + "_missing" for name in names]
+        self.measure.measure(lambda: self._lookup_all(self.count, names),
+                             "found")
+        self.measure.measure(lambda: self._lookup_all(self.count, missing),
+                             "missing")
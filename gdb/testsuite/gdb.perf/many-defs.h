@@ -0,0 +1,35 @@
+/* Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef MANY_DEFS_H
+#define MANY_DEFS_H
+
+/* Expand DEF1 (N) for many different tokens N.  The includer defines
+   DEF1, for instance as
+
+   #define DEF1(N) int var ## N;
+
+   and DEF4096 then expands to the 4096 definitions of var_000000 to
+   var_333333, the digits of N being in base 4.  */
+
+#define DEF4(N) DEF1 (N ## 0) DEF1 (N ## 1) DEF1 (N ## 2) DEF1 (N ## 3)
+#define DEF16(N) DEF4 (N ## 0) DEF4 (N ## 1) DEF4 (N ## 2) DEF4 (N ## 3)
+#define DEF64(N) DEF16 (N ## 0) DEF16 (N ## 1) DEF16 (N ## 2) DEF16 (N ## 3)
+#define DEF256(N) DEF64 (N ## 0) DEF64 (N ## 1) DEF64 (N ## 2) DEF64 (N ## 3)
+#define DEF1024(N) \
+  DEF256 (N ## 0) DEF256 (N ## 1) DEF256 (N ## 2) DEF256 (N ## 3)
+#define DEF4096 DEF1024 (_0) DEF1024 (_1) DEF1024 (_2) DEF1024 (_3)
+
+#endif /* MANY_DEFS_H */
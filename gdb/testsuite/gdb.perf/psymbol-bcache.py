@@ -0,0 +1,35 @@
+# Copyright (C) 2016 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures interning all the partial symbols of a
+# program in a new byte cache, and finding each of them again.
+
+from perftest import perftest
+
+class PsymbolBcache(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, count):
+        super(PsymbolBcache, self).__init__("psymbol-bcache")
+        self.count = count
+
+    def _test(self, count):
+        gdb.execute("maint intern-psymbols %d" % count, False, True)
+
+    def warm_up(self):
+        self._test(1)
+
+    def execute_test(self):
+        for i in range(1, 4):
+            count = i * self.count
+            self.measure.measure(lambda: self._test(count), count)
@@ -0,0 +1,50 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+
+struct point
+{
+  int x, y;
+};
+
+/* A vector-like container, printed by the pretty-printers in
+   py-pp-children.py.  */
+
+struct vec
+{
+  struct point *begin;
+  struct point *end;
+};
+
+struct vec v;
+
+int
+main (void)
+{
+  int i;
+
+  v.begin = malloc (NUM_ELEMENTS * sizeof (struct point));
+  for (i = 0; i < NUM_ELEMENTS; i++)
+    {
+      v.begin[i].x = i;
+      v.begin[i].y = -i;
+    }
+  v.end = v.begin + NUM_ELEMENTS;
+
+  return 0; /* break here */
+}
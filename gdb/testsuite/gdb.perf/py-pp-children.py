@@ -0,0 +1,67 @@
+# Copyright (C) 2016 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures printing a large container with a
+# pretty-printer whose children are returned by its children method,
+# compared with one whose children are described by children_ranges.
+
+from perftest import perftest
+
+class VecPrinter (object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "vec"
+
+    def display_hint(self):
+        return "array"
+
+    def children(self):
+        begin = self.val["begin"]
+        for i in range(int(self.val["end"] - begin)):
+            yield ("[%d]" % i, (begin + i).dereference())
+
+class VecRangesPrinter (VecPrinter):
+    def children_ranges(self):
+        begin = self.val["begin"]
+        return [(begin, int(self.val["end"] - begin))]
+
+class PrettyPrintChildren (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self):
+        super (PrettyPrintChildren, self).__init__ ("py-pp-children")
+        self.use_ranges = False
+        gdb.pretty_printers.append (self.lookup)
+
+    def lookup(self, val):
+        if str (val.type.strip_typedefs ()) == "struct vec":
+            if self.use_ranges:
+                return VecRangesPrinter (val)
+            return VecPrinter (val)
+        return None
+
+    def warm_up(self):
+        gdb.execute ("set print elements unlimited")
+        gdb.execute ("set print repeats unlimited")
+        gdb.execute ("print v", False, True)
+
+    def execute_test(self):
+        for use_ranges in (False, True):
+            self.use_ranges = use_ranges
+            func = lambda: gdb.execute ("print v", False, True)
+            if use_ranges:
+                self.measure.measure (func, "children_ranges")
+            else:
+                self.measure.measure (func, "children")
@@ -0,0 +1,42 @@
+# Copyright (C) 2016 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It tests the caching of
+# python pretty-printer lookups.
+
+import gdb
+
+# The number of times each lookup function has been called.
+lookup_calls = { "point" : 0, "other" : 0 }
+
+class pp_point (object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "(%d, %d)" % (int(self.val["x"]), int(self.val["y"]))
+
+def lookup_point (val):
+    lookup_calls["point"] += 1
+    if str(val.type.strip_typedefs()) == "struct point":
+        return pp_point(val)
+    return None
+
+def lookup_other (val):
+    lookup_calls["other"] += 1
+    return None
+
+gdb.pretty_printers.append(lookup_point)
+gdb.pretty_printers.append(lookup_other)
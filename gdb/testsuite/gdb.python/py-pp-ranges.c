@@ -0,0 +1,44 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct point
+{
+  int x, y;
+};
+
+/* A container whose elements are stored in two separate chunks.  */
+
+struct chunked
+{
+  struct point *first;
+  int first_len;
+  struct point *second;
+  int second_len;
+};
+
+struct point a[3] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+struct point b[2] = { { 7, 8 }, { 9, 10 } };
+
+struct chunked c = { a, 3, b, 2 };
+struct chunked declined = { a, 1, b, 1 };
+struct chunked bad = { a, 3, 0, 0 };
+
+int
+main (void)
+{
+  return 0;  /* break to inspect */
+}
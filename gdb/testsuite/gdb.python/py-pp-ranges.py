@@ -0,0 +1,70 @@
+# Copyright (C) 2016 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It tests python
+# pretty-printers that implement children_ranges.
+
+import gdb
+
+class pp_chunked (object):
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "chunked"
+
+    def children(self):
+        count = 0
+        for ptr, length in self.children_ranges():
+            for i in range(length):
+                yield ("[%d]" % count, (ptr + i).dereference())
+                count += 1
+
+    def children_ranges(self):
+        return [(self.val["first"], int(self.val["first_len"])),
+                (self.val["second"], int(self.val["second_len"]))]
+
+class pp_chunked_array (pp_chunked):
+    def display_hint(self):
+        return "array"
+
+class pp_chunked_declined (pp_chunked):
+    def to_string(self):
+        return "declined"
+
+    def children(self):
+        yield ("only", self.val["first_len"])
+
+    def children_ranges(self):
+        return None
+
+class pp_chunked_bad (pp_chunked):
+    def children_ranges(self):
+        return [(self.val["first_len"], 3)]
+
+use_array = False
+
+def lookup_chunked (val):
+    if str(val.type.strip_typedefs()) != "struct chunked":
+        return None
+    if int(val["first_len"]) == 1:
+        return pp_chunked_declined(val)
+    if int(val["second_len"]) == 0:
+        return pp_chunked_bad(val)
+    if use_array:
+        return pp_chunked_array(val)
+    return pp_chunked(val)
+
+gdb.pretty_printers.append(lookup_chunked)
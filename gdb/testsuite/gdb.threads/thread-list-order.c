@@ -0,0 +1,110 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2016 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <assert.h>
+
+#define NSLOTS 3
+
+static pthread_t threads[NSLOTS];
+static sem_t started;
+static sem_t release[NSLOTS];
+
+/* Called by the thread in SLOT once it has been released, just before
+   it exits.  */
+
+void
+thread_released (int slot)
+{
+}
+
+static void *
+thread_function (void *arg)
+{
+  int slot = (int) (long) arg;
+
+  sem_post (&started);
+  sem_wait (&release[slot]);
+  thread_released (slot);
+  return NULL;
+}
+
+static void
+start_thread (int slot)
+{
+  int res;
+
+  res = pthread_create (&threads[slot], NULL, thread_function,
+			(void *) (long) slot);
+  assert (res == 0);
+  sem_wait (&started);
+}
+
+static void
+finish_thread (int slot)
+{
+  int res;
+
+  sem_post (&release[slot]);
+  res = pthread_join (threads[slot], NULL);
+  assert (res == 0);
+}
+
+void
+all_started (void)
+{
+}
+
+void
+some_exited (void)
+{
+}
+
+void
+readded (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  sem_init (&started, 0, 0);
+  for (i = 0; i < NSLOTS; i++)
+    sem_init (&release[i], 0, 0);
+
+  for (i = 0; i < NSLOTS; i++)
+    start_thread (i);
+  all_started ();
+
+  /* Remove the last thread in GDB's list first, then the first one
+     after the main thread.  */
+  finish_thread (2);
+  finish_thread (0);
+  some_exited ();
+
+  start_thread (0);
+  start_thread (2);
+  readded ();
+
+  finish_thread (0);
+  finish_thread (1);
+  finish_thread (2);
+  return 0;
+}
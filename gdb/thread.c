@@ -56,6 +56,16 @@ void _initialize_thread (void);
 struct thread_info *thread_list = NULL;
 static int highest_thread_num;
 
+/* The last thread in THREAD_LIST, so that new threads are appended
+   in constant time.  */
+static struct thread_info *thread_list_tail;
+
+/* Map from ptid to the first thread in THREAD_LIST with that ptid,
+   so that looking up a thread does not walk the whole list.  Targets
+   with many threads, and core files with tens of thousands of them,
+   would otherwise make adding threads quadratic.  */
+static htab_t thread_ptid_map;
+
 /* True if any thread is, or may be executing.  We need to track this
    separately because until we fully sync the thread list, we won't
    know whether the target is fully stopped, even if we see stop
@@ -224,9 +234,104 @@ init_thread_list (void)
     }
 
   thread_list = NULL;
+  thread_list_tail = NULL;
+  if (thread_ptid_map != NULL)
+    htab_empty (thread_ptid_map);
   threads_executing = 0;
 }
 
+/* Return the hash value of PTID.  */
+
+static hashval_t
+hash_ptid (ptid_t ptid)
+{
+  long lwp = ptid_get_lwp (ptid);
+  long tid = ptid_get_tid (ptid);
+  hashval_t hash = ptid_get_pid (ptid);
+
+  hash = iterative_hash_object (lwp, hash);
+  return iterative_hash_object (tid, hash);
+}
+
+/* Hash function for THREAD_PTID_MAP.  */
+
+static hashval_t
+hash_thread_ptid (const void *p)
+{
+  const struct thread_info *tp = (const struct thread_info *) p;
+
+  return hash_ptid (tp->ptid);
+}
+
+/* Equality function for THREAD_PTID_MAP.  The key is a ptid_t.  */
+
+static int
+eq_thread_ptid (const void *a, const void *b)
+{
+  const struct thread_info *tp = (const struct thread_info *) a;
+  const ptid_t *ptid = (const ptid_t *) b;
+
+  return ptid_equal (tp->ptid, *ptid);
+}
+
+/* Enter TP in THREAD_PTID_MAP, unless an earlier thread in
+   THREAD_LIST has the same ptid.  TP must be the last thread with its
+   ptid in THREAD_LIST.  */
+
+static void
+thread_ptid_map_add (struct thread_info *tp)
+{
+  void **slot;
+
+  if (thread_ptid_map == NULL)
+    thread_ptid_map = htab_create_alloc (127, hash_thread_ptid,
+					 eq_thread_ptid, NULL,
+					 xcalloc, xfree);
+
+  slot = htab_find_slot_with_hash (thread_ptid_map, &tp->ptid,
+				   hash_ptid (tp->ptid), INSERT);
+  if (*slot == NULL)
+    *slot = tp;
+}
+
+/* Make the entry for PTID in THREAD_PTID_MAP the first thread in
+   THREAD_LIST with that ptid again, after threads were removed or
+   had their ptid changed.  */
+
+static void
+thread_ptid_map_refresh (ptid_t ptid)
+{
+  struct thread_info *tp;
+  void **slot;
+
+  if (thread_ptid_map == NULL)
+    return;
+
+  slot = htab_find_slot_with_hash (thread_ptid_map, &ptid,
+				   hash_ptid (ptid), NO_INSERT);
+  if (slot != NULL)
+    htab_clear_slot (thread_ptid_map, slot);
+
+  for (tp = thread_list; tp != NULL; tp = tp->next)
+    if (ptid_equal (tp->ptid, ptid))
+      {
+	thread_ptid_map_add (tp);
+	break;
+      }
+}
+
+/* Change the ptid of thread TP to PTID.  */
+
+static void
+set_thread_ptid (struct thread_info *tp, ptid_t ptid)
+{
+  ptid_t old_ptid = tp->ptid;
+
+  tp->ptid = ptid;
+  thread_ptid_map_refresh (old_ptid);
+  thread_ptid_map_refresh (ptid);
+}
+
 /* Allocate a new thread of inferior INF with target id PTID and add
    it to the thread list.  */
 
@@ -247,13 +352,9 @@ new_thread (struct inferior *inf, ptid_t ptid)
   if (thread_list == NULL)
     thread_list = tp;
   else
-    {
-      struct thread_info *last;
-
-      for (last = thread_list; last->next != NULL; last = last->next)
-	;
-      last->next = tp;
-    }
+    thread_list_tail->next = tp;
+  thread_list_tail = tp;
+  thread_ptid_map_add (tp);
 
   /* Nothing to follow yet.  */
   tp->pending_follow.kind = TARGET_WAITKIND_SPURIOUS;
@@ -296,7 +397,7 @@ add_thread_silent (ptid_t ptid)
 	  delete_thread (ptid);
 
 	  /* Now reset its ptid, and reswitch inferior_ptid to it.  */
-	  tp->ptid = ptid;
+	  set_thread_ptid (tp, ptid);
 	  tp->state = THREAD_STOPPED;
 	  switch_to_thread (ptid);
 
@@ -469,6 +570,12 @@ delete_thread_1 (ptid_t ptid, int silent)
     tpprev->next = tp->next;
   else
     thread_list = tp->next;
+  if (thread_list_tail == tp)
+    thread_list_tail = tpprev;
+
+  if (htab_find_with_hash (thread_ptid_map, &tp->ptid,
+			   hash_ptid (tp->ptid)) == tp)
+    thread_ptid_map_refresh (tp->ptid);
 
   free_thread (tp);
 }
@@ -517,13 +624,11 @@ find_thread_id (struct inferior *inf, int thr_num)
 struct thread_info *
 find_thread_ptid (ptid_t ptid)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return tp;
+  if (thread_ptid_map == NULL)
+    return NULL;
 
-  return NULL;
+  return (struct thread_info *) htab_find_with_hash (thread_ptid_map, &ptid,
+						     hash_ptid (ptid));
 }
 
 /*
@@ -888,7 +993,7 @@ thread_change_ptid (ptid_t old_ptid, ptid_t new_ptid)
   inf->pid = ptid_get_pid (new_ptid);
 
   tp = find_thread_ptid (old_ptid);
-  tp->ptid = new_ptid;
+  set_thread_ptid (tp, new_ptid);
 
   observer_notify_thread_ptid_changed (old_ptid, new_ptid);
 }
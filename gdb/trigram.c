@@ -0,0 +1,550 @@
+/* trigram.c --- trigram indexes of names.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "trigram.h"
+#include "gdbcmd.h"
+
+/* Whether searches use trigram indexes.  */
+static int trigram_index_enabled = 1;
+
+/* Characters are coded on 6 bits: digits, letters and '_' have their
+   own code, and all other characters share the last one.  */
+#define TRIGRAM_CHAR_BITS 6
+#define TRIGRAM_OTHER_CHAR ((1 << TRIGRAM_CHAR_BITS) - 1)
+
+/* The number of distinct trigrams.  */
+#define TRIGRAM_COUNT (1 << (3 * TRIGRAM_CHAR_BITS))
+
+/* Return the code of character C.  */
+
+static unsigned int
+trigram_char_code (unsigned char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'A' && c <= 'Z')
+    return 10 + c - 'A';
+  if (c >= 'a' && c <= 'z')
+    return 36 + c - 'a';
+  if (c == '_')
+    return 62;
+  return TRIGRAM_OTHER_CHAR;
+}
+
+/* Return the trigram of the three characters at S.  */
+
+static unsigned int
+trigram_code (const char *s)
+{
+  return ((trigram_char_code (s[0]) << (2 * TRIGRAM_CHAR_BITS))
+	  | (trigram_char_code (s[1]) << TRIGRAM_CHAR_BITS)
+	  | trigram_char_code (s[2]));
+}
+
+struct trigram_index
+{
+  /* The number of trigrams appearing in the names.  */
+  unsigned int num_keys;
+
+  /* Those trigrams, in increasing order.  */
+  unsigned int *keys;
+
+  /* The objects whose names contain KEYS[I] are IDS[OFFSETS[I]] to
+     IDS[OFFSETS[I + 1] - 1], in increasing order.  */
+  unsigned int *offsets;
+  unsigned int *ids;
+};
+
+struct trigram_index_builder
+{
+  /* For each trigram, one more than the last object added with it, or
+     zero.  This avoids recording the same trigram twice for an
+     object.  */
+  unsigned int *last_id;
+
+  /* The pairs of trigram and object added so far.  */
+  unsigned int *pair_trigrams;
+  unsigned int *pair_ids;
+  size_t num_pairs;
+  size_t pairs_allocated;
+};
+
+struct trigram_query
+{
+  /* The number of trigrams that the names must contain.  */
+  int num_trigrams;
+
+  /* The trigrams, in increasing order, without duplicates.  */
+  unsigned int *trigrams;
+};
+
+/* See trigram.h.  */
+
+struct trigram_index_builder *
+trigram_index_builder_new (void)
+{
+  struct trigram_index_builder *builder
+    = XCNEW (struct trigram_index_builder);
+
+  builder->last_id = XCNEWVEC (unsigned int, TRIGRAM_COUNT);
+  return builder;
+}
+
+/* See trigram.h.  */
+
+void
+trigram_index_builder_add (struct trigram_index_builder *builder,
+			   unsigned int id, const char *name)
+{
+  size_t len = strlen (name);
+  size_t i;
+
+  gdb_assert (builder->num_pairs == 0
+	      || builder->pair_ids[builder->num_pairs - 1] <= id);
+
+  for (i = 0; i + 3 <= len; i++)
+    {
+      unsigned int trigram = trigram_code (name + i);
+
+      if (builder->last_id[trigram] == id + 1)
+	continue;
+      builder->last_id[trigram] = id + 1;
+
+      if (builder->num_pairs == builder->pairs_allocated)
+	{
+	  builder->pairs_allocated = max (1024, 2 * builder->pairs_allocated);
+	  builder->pair_trigrams
+	    = XRESIZEVEC (unsigned int, builder->pair_trigrams,
+			  builder->pairs_allocated);
+	  builder->pair_ids
+	    = XRESIZEVEC (unsigned int, builder->pair_ids,
+			  builder->pairs_allocated);
+	}
+      builder->pair_trigrams[builder->num_pairs] = trigram;
+      builder->pair_ids[builder->num_pairs] = id;
+      builder->num_pairs++;
+    }
+}
+
+/* See trigram.h.  */
+
+void
+trigram_index_builder_free (struct trigram_index_builder *builder)
+{
+  xfree (builder->last_id);
+  xfree (builder->pair_trigrams);
+  xfree (builder->pair_ids);
+  xfree (builder);
+}
+
+/* See trigram.h.  */
+
+struct trigram_index *
+trigram_index_builder_finish (struct trigram_index_builder *builder)
+{
+  struct trigram_index *index = XCNEW (struct trigram_index);
+  unsigned int *counts = builder->last_id;
+  unsigned int trigram, key;
+  size_t i;
+
+  /* Sort the pairs by trigram.  The sort is stable, so the objects of
+     each trigram stay in increasing order.  */
+  memset (counts, 0, TRIGRAM_COUNT * sizeof (unsigned int));
+  for (i = 0; i < builder->num_pairs; i++)
+    counts[builder->pair_trigrams[i]]++;
+
+  for (trigram = 0; trigram < TRIGRAM_COUNT; trigram++)
+    if (counts[trigram] != 0)
+      index->num_keys++;
+
+  index->keys = XNEWVEC (unsigned int, index->num_keys);
+  index->offsets = XNEWVEC (unsigned int, index->num_keys + 1);
+  index->ids = XNEWVEC (unsigned int, builder->num_pairs);
+
+  /* Turn COUNTS into the position where the next object of each
+     trigram goes.  */
+  key = 0;
+  index->offsets[0] = 0;
+  for (trigram = 0; trigram < TRIGRAM_COUNT; trigram++)
+    if (counts[trigram] != 0)
+      {
+	unsigned int count = counts[trigram];
+
+	index->keys[key] = trigram;
+	counts[trigram] = index->offsets[key];
+	index->offsets[key + 1] = index->offsets[key] + count;
+	key++;
+      }
+
+  for (i = 0; i < builder->num_pairs; i++)
+    index->ids[counts[builder->pair_trigrams[i]]++] = builder->pair_ids[i];
+
+  trigram_index_builder_free (builder);
+  return index;
+}
+
+/* See trigram.h.  */
+
+void
+trigram_index_free (struct trigram_index *index)
+{
+  if (index == NULL)
+    return;
+
+  xfree (index->keys);
+  xfree (index->offsets);
+  xfree (index->ids);
+  xfree (index);
+}
+
+/* See trigram.h.  */
+
+size_t
+trigram_index_size (const struct trigram_index *index)
+{
+  return (sizeof (*index)
+	  + (2 * index->num_keys + 1) * sizeof (unsigned int)
+	  + index->offsets[index->num_keys] * sizeof (unsigned int));
+}
+
+/* Return the position of TRIGRAM in the keys of INDEX, or -1.  */
+
+static int
+trigram_index_find (const struct trigram_index *index, unsigned int trigram)
+{
+  unsigned int lo = 0, hi = index->num_keys;
+
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (index->keys[mid] < trigram)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if (lo < index->num_keys && index->keys[lo] == trigram)
+    return lo;
+  return -1;
+}
+
+/* Return non-zero if ID is one of the N objects in increasing order at
+   IDS.  */
+
+static int
+trigram_ids_contain (const unsigned int *ids, unsigned int n, unsigned int id)
+{
+  unsigned int lo = 0, hi = n;
+
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (ids[mid] < id)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  return lo < n && ids[lo] == id;
+}
+
+/* See trigram.h.  */
+
+void
+trigram_index_lookup (const struct trigram_index *index,
+		      const struct trigram_query *query,
+		      VEC (int) **ids)
+{
+  int *keys = XALLOCAVEC (int, query->num_trigrams);
+  int i, shortest;
+  unsigned int j;
+
+  VEC_truncate (int, *ids, 0);
+
+  /* Start with the trigram with the fewest objects.  */
+  shortest = 0;
+  for (i = 0; i < query->num_trigrams; i++)
+    {
+      keys[i] = trigram_index_find (index, query->trigrams[i]);
+      if (keys[i] < 0)
+	return;
+      if (index->offsets[keys[i] + 1] - index->offsets[keys[i]]
+	  < (index->offsets[keys[shortest] + 1]
+	     - index->offsets[keys[shortest]]))
+	shortest = i;
+    }
+
+  for (j = index->offsets[keys[shortest]];
+       j < index->offsets[keys[shortest] + 1];
+       j++)
+    VEC_safe_push (int, *ids, index->ids[j]);
+
+  /* Keep the objects that all the other trigrams have too.  */
+  for (i = 0; i < query->num_trigrams && !VEC_empty (int, *ids); i++)
+    {
+      const unsigned int *other;
+      unsigned int other_len;
+      int id, ix, kept;
+
+      if (i == shortest)
+	continue;
+
+      other = index->ids + index->offsets[keys[i]];
+      other_len = index->offsets[keys[i] + 1] - index->offsets[keys[i]];
+      kept = 0;
+      for (ix = 0; VEC_iterate (int, *ids, ix, id); ix++)
+	if (trigram_ids_contain (other, other_len, id))
+	  VEC_replace (int, *ids, kept++, id);
+      VEC_truncate (int, *ids, kept);
+    }
+}
+
+/* Add to TRIGRAMS, whose size is *ALLOCATED and which holds *N
+   trigrams, those of the LEN characters at RUN.  */
+
+static void
+trigram_query_add_run (unsigned int **trigrams, int *n, int *allocated,
+		       const char *run, int len)
+{
+  int i;
+
+  for (i = 0; i + 3 <= len; i++)
+    {
+      if (*n == *allocated)
+	{
+	  *allocated = max (16, 2 * *allocated);
+	  *trigrams = XRESIZEVEC (unsigned int, *trigrams, *allocated);
+	}
+      (*trigrams)[(*n)++] = trigram_code (run + i);
+    }
+}
+
+/* Compare two trigrams, for qsort.  */
+
+static int
+compare_trigrams (const void *ap, const void *bp)
+{
+  unsigned int a = *(const unsigned int *) ap;
+  unsigned int b = *(const unsigned int *) bp;
+
+  return a < b ? -1 : a > b;
+}
+
+/* See trigram.h.  */
+
+struct trigram_query *
+trigram_query_from_regexp (const char *regexp, int icase)
+{
+  struct trigram_query *query;
+  unsigned int *trigrams = NULL;
+  int n = 0, allocated = 0;
+  /* The current run of characters that every match contains.  */
+  char *run = (char *) alloca (strlen (regexp) + 1);
+  int run_len = 0;
+  const char *p;
+  int i, unique;
+
+  if (!trigram_index_enabled || icase)
+    return NULL;
+
+#define END_RUN()							\
+  do									\
+    {									\
+      trigram_query_add_run (&trigrams, &n, &allocated, run, run_len);	\
+      run_len = 0;							\
+    }									\
+  while (0)
+
+  for (p = regexp; *p != '\0'; p++)
+    {
+      switch (*p)
+	{
+	case '\\':
+	  p++;
+	  if (*p == '\0')
+	    goto done;
+	  if (*p == '|' || *p == '(' || *p == ')')
+	    {
+	      /* Alternatives, and groups which may be repeated or
+		 optional, are not worth analyzing.  */
+	      xfree (trigrams);
+	      return NULL;
+	    }
+	  if (*p == '?' || *p == '{')
+	    {
+	      /* The previous character may be absent.  */
+	      if (run_len > 0)
+		run_len--;
+	      END_RUN ();
+
+	      /* Skip the bounds of an interval.  */
+	      if (*p == '{')
+		{
+		  while (*p != '\0' && !(p[0] == '\\' && p[1] == '}'))
+		    p++;
+		  if (*p == '\0')
+		    goto done;
+		  p++;
+		}
+	    }
+	  else if (*p == '+')
+	    {
+	      const char *next = p + 1;
+
+	      /* The previous character is required, unless a quantifier
+		 applies to the whole repetition and makes it optional.  */
+	      while (next[0] == '\\' && next[1] == '+')
+		next += 2;
+	      if (run_len > 0
+		  && (next[0] == '*'
+		      || (next[0] == '\\' && (next[1] == '?' || next[1] == '{'))))
+		run_len--;
+	      END_RUN ();
+	    }
+	  else if (strchr ("}123456789wWsSbB<>`'", *p) != NULL)
+	    END_RUN ();
+	  else
+	    run[run_len++] = *p;
+	  break;
+
+	case '*':
+	  /* A '*' at the start of the regexp is an ordinary character.  */
+	  if (p == regexp || (p == regexp + 1 && regexp[0] == '^'))
+	    run[run_len++] = *p;
+	  else
+	    {
+	      /* The previous character may be absent.  */
+	      if (run_len > 0)
+		run_len--;
+	      END_RUN ();
+	    }
+	  break;
+
+	case '[':
+	  /* Skip the bracket expression; a ']' right after the opening
+	     '[' or '[^' is part of it.  */
+	  END_RUN ();
+	  p++;
+	  if (*p == '^')
+	    p++;
+	  if (*p == ']')
+	    p++;
+	  while (*p != '\0' && *p != ']')
+	    {
+	      if (p[0] == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+		{
+		  char close = p[1];
+
+		  for (p += 2; *p != '\0' && !(p[0] == close && p[1] == ']');
+		       p++)
+		    ;
+		  if (*p == '\0')
+		    break;
+		  p++;
+		}
+	      p++;
+	    }
+	  if (*p == '\0')
+	    goto done;
+	  break;
+
+	case '.':
+	case '^':
+	case '$':
+	  END_RUN ();
+	  break;
+
+	default:
+	  run[run_len++] = *p;
+	  break;
+	}
+    }
+
+ done:
+  END_RUN ();
+
+#undef END_RUN
+
+  if (n == 0)
+    {
+      xfree (trigrams);
+      return NULL;
+    }
+
+  qsort (trigrams, n, sizeof (unsigned int), compare_trigrams);
+  unique = 1;
+  for (i = 1; i < n; i++)
+    if (trigrams[i] != trigrams[unique - 1])
+      trigrams[unique++] = trigrams[i];
+
+  query = XNEW (struct trigram_query);
+  query->num_trigrams = unique;
+  query->trigrams = trigrams;
+  return query;
+}
+
+/* See trigram.h.  */
+
+void
+trigram_query_free (struct trigram_query *query)
+{
+  if (query == NULL)
+    return;
+
+  xfree (query->trigrams);
+  xfree (query);
+}
+
+/* Cleanup function for make_cleanup_trigram_query_free.  */
+
+static void
+do_trigram_query_free (void *query)
+{
+  trigram_query_free ((struct trigram_query *) query);
+}
+
+/* See trigram.h.  */
+
+struct cleanup *
+make_cleanup_trigram_query_free (struct trigram_query *query)
+{
+  return make_cleanup (do_trigram_query_free, query);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_trigram;
+
+void
+_initialize_trigram (void)
+{
+  add_setshow_boolean_cmd ("symbol-search-index", class_maintenance,
+			   &trigram_index_enabled, _("\
+Set whether symbol searches use trigram indexes of symbol names."), _("\
+Show whether symbol searches use trigram indexes of symbol names."), _("\
+When on, searches for symbols matching a regular expression, such as\n\
+\"info functions REGEXP\", build an index of the trigrams in the names\n\
+of the minimal and partial symbols of each objfile, and only test the\n\
+names containing all the trigrams that any match must contain."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+}
@@ -0,0 +1,87 @@
+/* trigram.h --- interface to trigram indexes of names.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef TRIGRAM_H
+#define TRIGRAM_H
+
+#include "gdb_vecs.h"
+
+/* A trigram index maps the sequences of three characters appearing in
+   the names of a set of objects, such as the minimal symbols of an
+   objfile, to the objects.  Objects are identified by numbers.
+
+   A search for names matching a regular expression can then only test
+   the names of the objects containing all the trigrams that any match
+   must contain, instead of testing every name.  The index may return
+   objects whose names do not match, but never misses one that does:
+   several characters share the same code in the index.  */
+
+/* The opaque type representing trigram indexes.  */
+struct trigram_index;
+
+/* The opaque type used to build trigram indexes.  */
+struct trigram_index_builder;
+
+/* The opaque type representing the trigrams that the names matching a
+   search must contain.  */
+struct trigram_query;
+
+/* Return a new, empty, trigram index builder.  */
+extern struct trigram_index_builder *trigram_index_builder_new (void);
+
+/* Add NAME, a name of the object ID, to BUILDER.  Objects must be added
+   in increasing order of ID; an object may have several names.  */
+extern void trigram_index_builder_add (struct trigram_index_builder *builder,
+				       unsigned int id, const char *name);
+
+/* Free BUILDER and return the index it built.  */
+extern struct trigram_index *
+  trigram_index_builder_finish (struct trigram_index_builder *builder);
+
+/* Free BUILDER, without building an index.  */
+extern void trigram_index_builder_free (struct trigram_index_builder *builder);
+
+/* Free INDEX.  */
+extern void trigram_index_free (struct trigram_index *index);
+
+/* Return the number of bytes used by INDEX.  */
+extern size_t trigram_index_size (const struct trigram_index *index);
+
+/* Store in *IDS, in increasing order and without duplicates, the
+   objects of INDEX whose names may contain all the trigrams of
+   QUERY.  */
+extern void trigram_index_lookup (const struct trigram_index *index,
+				  const struct trigram_query *query,
+				  VEC (int) **ids);
+
+/* Return the query for names matching REGEXP, a basic regular
+   expression as used by search_symbols, or NULL if REGEXP does not
+   require any trigram, or if trigram indexes are disabled.  ICASE is
+   non-zero if the search ignores case, which no query supports.  */
+extern struct trigram_query *trigram_query_from_regexp (const char *regexp,
+							int icase);
+
+/* Free QUERY, which may be NULL.  */
+extern void trigram_query_free (struct trigram_query *query);
+
+/* Make a cleanup freeing QUERY.  */
+extern struct cleanup *make_cleanup_trigram_query_free
+  (struct trigram_query *query);
+
+#endif /* TRIGRAM_H */
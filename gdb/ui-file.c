@@ -658,6 +658,20 @@ stdio_file_fseek (struct ui_file *file, long offset, int whence)
   return fseek (stdio->file, offset, whence);
 }
 
+/* See ui-file.h.  */
+
+int
+stdio_file_fd (struct ui_file *file)
+{
+  struct stdio_file *stdio;
+
+  if (file->to_flush != stdio_file_flush)
+    return -1;
+
+  stdio = (struct stdio_file *) ui_file_data (file);
+  return stdio->fd;
+}
+
 #ifdef __MINGW32__
 /* This is the implementation of ui_file method to_write for stderr.
    gdb_stdout is flushed before writing to gdb_stderr.  */
@@ -135,6 +135,12 @@ extern struct ui_file *mem_fileopen (void);
 /* Open/create a STDIO based UI_FILE using the already open FILE.  */
 extern struct ui_file *stdio_fileopen (FILE *file);
 
+/* Return the file descriptor underlying FILE if it was created by
+   stdio_fileopen or gdb_fopen, or -1 otherwise.  Output written
+   directly to the descriptor bypasses FILE's stdio buffer, so flush
+   FILE first.  */
+extern int stdio_file_fd (struct ui_file *file);
+
 /* Create a ui_file from stderr.  */
 extern struct ui_file *stderr_fileopen (void);
 
@@ -1044,11 +1044,17 @@ quit (void)
 
 /* See defs.h.  */
 
+void (*quit_poll_hook) (void);
+
+/* See defs.h.  */
+
 void
 maybe_quit (void)
 {
   if (check_quit_flag () || sync_quit_force_run)
     quit ();
+  if (quit_poll_hook != NULL)
+    quit_poll_hook ();
   if (deprecated_interactive_hook)
     deprecated_interactive_hook ();
   target_check_pending_interrupt ();
@@ -1493,10 +1499,12 @@ parse_escape (struct gdbarch *gdbarch, const char **string_ptr)
   return target_char;
 }
 
-/* Print the character C on STREAM as part of the contents of a literal
-   string whose delimiter is QUOTER.  Note that this routine should only
-   be called for printing things which are independent of the language
-   of the program being debugged.
+/* Store in BUF the text printing the character C as part of the
+   contents of a literal string whose delimiter is QUOTER, and return
+   its length.  BUF must have room for PRINTCHAR_MAX_LEN characters.
+   Note that this routine should only be called for printing things
+   which are independent of the language of the program being
+   debugged.
 
    printchar will normally escape backslashes and instances of QUOTER. If
    QUOTER is 0, printchar won't escape backslashes or any quoting character.
@@ -1504,10 +1512,10 @@ parse_escape (struct gdbarch *gdbarch, const char **string_ptr)
    printchar will escape backslashes as usual, but not any other quoting
    character. */
 
-static void
-printchar (int c, void (*do_fputs) (const char *, struct ui_file *),
-	   void (*do_fprintf) (struct ui_file *, const char *, ...)
-	   ATTRIBUTE_FPTR_PRINTF_2, struct ui_file *stream, int quoter)
+#define PRINTCHAR_MAX_LEN 4
+
+static int
+printchar (int c, char *buf, int quoter)
 {
   c &= 0xFF;			/* Avoid sign bit follies */
 
@@ -1515,39 +1523,77 @@ printchar (int c, void (*do_fputs) (const char *, struct ui_file *),
       (c >= 0x7F && c < 0xA0) ||	/* DEL, High controls */
       (sevenbit_strings && c >= 0x80))
     {				/* high order bit set */
+      buf[0] = '\\';
       switch (c)
 	{
 	case '\n':
-	  do_fputs ("\\n", stream);
-	  break;
+	  buf[1] = 'n';
+	  return 2;
 	case '\b':
-	  do_fputs ("\\b", stream);
-	  break;
+	  buf[1] = 'b';
+	  return 2;
 	case '\t':
-	  do_fputs ("\\t", stream);
-	  break;
+	  buf[1] = 't';
+	  return 2;
 	case '\f':
-	  do_fputs ("\\f", stream);
-	  break;
+	  buf[1] = 'f';
+	  return 2;
 	case '\r':
-	  do_fputs ("\\r", stream);
-	  break;
+	  buf[1] = 'r';
+	  return 2;
 	case '\033':
-	  do_fputs ("\\e", stream);
-	  break;
+	  buf[1] = 'e';
+	  return 2;
 	case '\007':
-	  do_fputs ("\\a", stream);
-	  break;
+	  buf[1] = 'a';
+	  return 2;
 	default:
-	  do_fprintf (stream, "\\%.3o", (unsigned int) c);
-	  break;
+	  buf[1] = '0' + ((c >> 6) & 7);
+	  buf[2] = '0' + ((c >> 3) & 7);
+	  buf[3] = '0' + (c & 7);
+	  return 4;
 	}
     }
   else
     {
+      int len = 0;
+
       if (quoter != 0 && (c == '\\' || c == quoter))
-	do_fputs ("\\", stream);
-      do_fprintf (stream, "%c", c);
+	buf[len++] = '\\';
+      buf[len++] = c;
+      return len;
+    }
+}
+
+/* Print the N characters of STR on STREAM with DO_FPUTS, escaped as
+   by printchar.  The escaped text is gathered in chunks, rather than
+   printed a character at a time, as MI output goes through here for
+   every string it emits.  */
+
+static void
+fputstrn_1 (const char *str, int n, int quoter,
+	    void (*do_fputs) (const char *, struct ui_file *),
+	    struct ui_file *stream)
+{
+  char buf[256 + PRINTCHAR_MAX_LEN + 1];
+  int len = 0;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      len += printchar (str[i], buf + len, quoter);
+      if (len >= 256)
+	{
+	  buf[len] = '\0';
+	  do_fputs (buf, stream);
+	  len = 0;
+	}
+    }
+
+  if (len > 0)
+    {
+      buf[len] = '\0';
+      do_fputs (buf, stream);
     }
 }
 
@@ -1559,35 +1605,27 @@ printchar (int c, void (*do_fputs) (const char *, struct ui_file *),
 void
 fputstr_filtered (const char *str, int quoter, struct ui_file *stream)
 {
-  while (*str)
-    printchar (*str++, fputs_filtered, fprintf_filtered, stream, quoter);
+  fputstrn_1 (str, strlen (str), quoter, fputs_filtered, stream);
 }
 
 void
 fputstr_unfiltered (const char *str, int quoter, struct ui_file *stream)
 {
-  while (*str)
-    printchar (*str++, fputs_unfiltered, fprintf_unfiltered, stream, quoter);
+  fputstrn_1 (str, strlen (str), quoter, fputs_unfiltered, stream);
 }
 
 void
 fputstrn_filtered (const char *str, int n, int quoter,
 		   struct ui_file *stream)
 {
-  int i;
-
-  for (i = 0; i < n; i++)
-    printchar (str[i], fputs_filtered, fprintf_filtered, stream, quoter);
+  fputstrn_1 (str, n, quoter, fputs_filtered, stream);
 }
 
 void
 fputstrn_unfiltered (const char *str, int n, int quoter,
 		     struct ui_file *stream)
 {
-  int i;
-
-  for (i = 0; i < n; i++)
-    printchar (str[i], fputs_unfiltered, fprintf_unfiltered, stream, quoter);
+  fputstrn_1 (str, n, quoter, fputs_unfiltered, stream);
 }
 
 
@@ -35,6 +35,7 @@
 #include "gdb_obstack.h"
 #include "charset.h"
 #include "typeprint.h"
+#include "c-lang.h"
 #include <ctype.h>
 
 /* Maximum number of wchars returned from wchar_iterate.  */
@@ -1017,13 +1018,14 @@ val_print (struct type *type, const gdb_byte *valaddr, int embedded_offset,
   END_CATCH
 }
 
-/* Check whether the value VAL is printable.  Return 1 if it is;
-   return 0 and print an appropriate error message to STREAM according to
-   OPTIONS if it is not.  */
+/* Check whether the value VAL is printable in LANGUAGE.  Return 1 if
+   it is; return 0 and print an appropriate error message to STREAM
+   according to OPTIONS if it is not.  */
 
 static int
 value_check_printable (struct value *val, struct ui_file *stream,
-		       const struct value_print_options *options)
+		       const struct value_print_options *options,
+		       const struct language_defn *language)
 {
   if (val == 0)
     {
@@ -1031,6 +1033,11 @@ value_check_printable (struct value *val, struct ui_file *stream,
       return 0;
     }
 
+  /* Checking the whole value would read all of it; a streamed array
+     is checked element by element as it is printed instead.  */
+  if (val_print_array_streaming_p (val, options, language))
+    return 1;
+
   if (value_entirely_optimized_out (val))
     {
       if (options->summary && !val_print_scalar_type_p (value_type (val)))
@@ -1082,7 +1089,9 @@ common_val_print (struct value *val, struct ui_file *stream, int recurse,
 		  const struct value_print_options *options,
 		  const struct language_defn *language)
 {
-  if (!value_check_printable (val, stream, options))
+  const gdb_byte *valaddr = NULL;
+
+  if (!value_check_printable (val, stream, options, language))
     return;
 
   if (language->la_language == language_ada)
@@ -1092,7 +1101,10 @@ common_val_print (struct value *val, struct ui_file *stream, int recurse,
        get a fixed representation of our value.  */
     val = ada_to_fixed_value (val);
 
-  val_print (value_type (val), value_contents_for_printing (val),
+  if (!val_print_array_streaming_p (val, options, language))
+    valaddr = value_contents_for_printing (val);
+
+  val_print (value_type (val), valaddr,
 	     value_embedded_offset (val), value_address (val),
 	     stream, recurse,
 	     val, options, language);
@@ -1105,14 +1117,18 @@ void
 value_print (struct value *val, struct ui_file *stream,
 	     const struct value_print_options *options)
 {
-  if (!value_check_printable (val, stream, options))
+  if (!value_check_printable (val, stream, options, current_language))
     return;
 
   if (!options->raw)
     {
-      int r
-	= apply_ext_lang_val_pretty_printer (value_type (val),
-					     value_contents_for_printing (val),
+      const gdb_byte *valaddr = NULL;
+      int r;
+
+      if (!val_print_array_streaming_p (val, options, current_language))
+	valaddr = value_contents_for_printing (val);
+
+      r = apply_ext_lang_val_pretty_printer (value_type (val), valaddr,
 					     value_embedded_offset (val),
 					     value_address (val),
 					     stream, 0,
@@ -1845,13 +1861,137 @@ maybe_print_array_index (struct type *index_type, LONGEST index,
   LA_PRINT_ARRAY_INDEX (index_value, stream, options);
 }
 
+/* Arrays in target memory that are larger than this many bytes are
+   printed by reading their elements in chunks of about this size as
+   they are printed, instead of reading the whole array up front.  */
+
+#define ARRAY_PRINT_CHUNK_SIZE 65536
+
+/* See valprint.h.  */
+
+int
+val_print_array_streaming_p (struct value *val,
+			     const struct value_print_options *options,
+			     const struct language_defn *language)
+{
+  struct type *type, *elttype;
+
+  if (!value_lazy (val)
+      || VALUE_LVAL (val) != lval_memory
+      || value_bitsize (val) != 0
+      || value_embedded_offset (val) != 0)
+    return 0;
+
+  type = check_typedef (value_type (val));
+  if (TYPE_CODE (type) != TYPE_CODE_ARRAY
+      || TYPE_VECTOR (type)
+      || TYPE_LENGTH (type) <= ARRAY_PRINT_CHUNK_SIZE
+      || type != check_typedef (value_enclosing_type (val)))
+    return 0;
+
+  elttype = TYPE_TARGET_TYPE (type);
+  if (TYPE_LENGTH (check_typedef (elttype)) == 0)
+    return 0;
+
+  /* Only the C-like languages print arrays purely through
+     val_print_array_elements.  Arrays of characters are printed as
+     strings, which needs the whole contents.  */
+  switch (language->la_language)
+    {
+    case language_c:
+    case language_cplus:
+    case language_objc:
+    case language_asm:
+    case language_minimal:
+      return !c_textual_element_type (elttype, options->format);
+    default:
+      return 0;
+    }
+}
+
+/* A window of consecutive elements of an array in target memory,
+   read from the target in one access.  */
+
+struct array_print_window
+{
+  /* The elements, as a released value of array type, or NULL if
+     nothing has been read yet.  */
+  struct value *val;
+
+  /* The index of the first element in VAL, and the number of
+     elements it holds.  */
+  unsigned int first;
+  unsigned int count;
+};
+
+/* Return non-zero if window W holds the element with index IDX.  */
+
+static int
+array_print_window_holds (const struct array_print_window *w,
+			  unsigned int idx)
+{
+  return (w->val != NULL && idx >= w->first
+	  && idx - w->first < w->count);
+}
+
+/* Read into window W the elements of type ELTTYPE starting with index
+   IDX, out of the LEN elements of the array at ADDRESS.  Throws an
+   error if the memory cannot be read.  */
+
+static void
+array_print_window_read (struct array_print_window *w,
+			 struct type *elttype, CORE_ADDR address,
+			 unsigned int idx, unsigned int len)
+{
+  struct type *real_elttype = check_typedef (elttype);
+  unsigned int count = ARRAY_PRINT_CHUNK_SIZE / TYPE_LENGTH (real_elttype);
+  struct type *window_type;
+  struct value *val;
+
+  if (count == 0)
+    count = 1;
+  if (count > len - idx)
+    count = len - idx;
+
+  window_type = lookup_array_range_type (elttype, 0, count - 1);
+  val = value_at_lazy (window_type,
+		       address + idx * type_length_units (real_elttype));
+  value_fetch_lazy (val);
+  release_value (val);
+
+  if (w->val != NULL)
+    value_free (w->val);
+  w->val = val;
+  w->first = idx;
+  w->count = count;
+}
+
+/* Cleanup function that frees the values held by the two array print
+   windows in ARG.  */
+
+static void
+free_array_print_windows (void *arg)
+{
+  struct array_print_window *windows = (struct array_print_window *) arg;
+
+  if (windows[0].val != NULL)
+    value_free (windows[0].val);
+  if (windows[1].val != NULL)
+    value_free (windows[1].val);
+}
+
 /*  Called by various <lang>_val_print routines to print elements of an
    array in the form "<elem1>, <elem2>, <elem3>, ...".
 
    (FIXME?)  Assumes array element separator is a comma, which is correct
    for all languages currently handled.
    (FIXME?)  Some languages have a notation for repeated array elements,
-   perhaps we should try to use that notation when appropriate.  */
+   perhaps we should try to use that notation when appropriate.
+
+   If VALADDR is NULL, VAL is a lazy array in target memory for which
+   val_print_array_streaming_p returned true.  Its elements are then
+   read in chunks as they are printed, so that only the part of the
+   array that is shown is fetched.  */
 
 void
 val_print_array_elements (struct type *type,
@@ -1873,6 +2013,13 @@ val_print_array_elements (struct type *type,
   unsigned int reps;
   LONGEST low_bound, high_bound;
   LONGEST low_pos, high_pos;
+  /* When streaming, the window holding the element being printed and
+     the window used to look ahead for repeats.  */
+  struct array_print_window windows[2];
+  struct cleanup *old_chain;
+
+  memset (windows, 0, sizeof (windows));
+  old_chain = make_cleanup (free_array_print_windows, windows);
 
   elttype = TYPE_TARGET_TYPE (type);
   eltlen = type_length_units (check_typedef (elttype));
@@ -1919,6 +2066,11 @@ val_print_array_elements (struct type *type,
 
   for (; i < len && things_printed < options->print_max; i++)
     {
+      const struct value *elt_val = val;
+      const gdb_byte *elt_valaddr = valaddr;
+      int elt_offset = embedded_offset + i * eltlen;
+      CORE_ADDR elt_address = address;
+
       if (i != 0)
 	{
 	  if (options->prettyformat_arrays)
@@ -1935,20 +2087,101 @@ val_print_array_elements (struct type *type,
       maybe_print_array_index (index_type, i + low_bound,
                                stream, options);
 
+      if (valaddr == NULL)
+	{
+	  int read_ok = 1;
+
+	  if (array_print_window_holds (&windows[0], i))
+	    {
+	      /* Already read.  */
+	    }
+	  else if (array_print_window_holds (&windows[1], i))
+	    {
+	      struct array_print_window tmp = windows[0];
+
+	      /* The look-ahead window already has the element.  */
+	      windows[0] = windows[1];
+	      windows[1] = tmp;
+	    }
+	  else
+	    {
+	      TRY
+		{
+		  array_print_window_read (&windows[0], elttype,
+					   address + embedded_offset, i, len);
+		}
+	      CATCH (except, RETURN_MASK_ERROR)
+		{
+		  fprintf_filtered (stream, _("<error: %s>"), except.message);
+		  read_ok = 0;
+		}
+	      END_CATCH
+	    }
+
+	  if (!read_ok)
+	    {
+	      i = len;
+	      break;
+	    }
+
+	  elt_val = windows[0].val;
+	  elt_valaddr = value_contents_for_printing (windows[0].val);
+	  elt_offset = (i - windows[0].first) * eltlen;
+	  elt_address = value_address (windows[0].val);
+	}
+
       rep1 = i + 1;
       reps = 1;
       /* Only check for reps if repeat_count_threshold is not set to
 	 UINT_MAX (unlimited).  */
       if (options->repeat_count_threshold < UINT_MAX)
 	{
-	  while (rep1 < len
-		 && value_contents_eq (val,
-				       embedded_offset + i * eltlen,
-				       val,
-				       (embedded_offset
-					+ rep1 * eltlen),
-				       eltlen))
+	  while (rep1 < len)
 	    {
+	      const struct value *rep_val = val;
+	      int rep_offset = embedded_offset + rep1 * eltlen;
+
+	      if (valaddr == NULL)
+		{
+		  struct array_print_window *w = &windows[0];
+
+		  if (!array_print_window_holds (w, rep1))
+		    {
+		      int read_ok = 1;
+
+		      /* Never replace the window holding the element
+			 being printed; look ahead in the other one.  */
+		      w = &windows[1];
+		      if (!array_print_window_holds (w, rep1))
+			{
+			  TRY
+			    {
+			      array_print_window_read (w, elttype,
+						       (address
+							+ embedded_offset),
+						       rep1, len);
+			    }
+			  CATCH (except, RETURN_MASK_ERROR)
+			    {
+			      read_ok = 0;
+			    }
+			  END_CATCH
+			}
+
+		      /* Errors are reported when the element itself is
+			 printed.  */
+		      if (!read_ok)
+			break;
+		    }
+
+		  rep_val = w->val;
+		  rep_offset = (rep1 - w->first) * eltlen;
+		}
+
+	      if (!value_contents_eq (elt_val, elt_offset,
+				      rep_val, rep_offset, eltlen))
+		break;
+
 	      ++reps;
 	      ++rep1;
 	    }
@@ -1956,8 +2189,8 @@ val_print_array_elements (struct type *type,
 
       if (reps > options->repeat_count_threshold)
 	{
-	  val_print (elttype, valaddr, embedded_offset + i * eltlen,
-		     address, stream, recurse + 1, val, options,
+	  val_print (elttype, elt_valaddr, elt_offset,
+		     elt_address, stream, recurse + 1, elt_val, options,
 		     current_language);
 	  annotate_elt_rep (reps);
 	  fprintf_filtered (stream, " <repeats %u times>", reps);
@@ -1968,9 +2201,9 @@ val_print_array_elements (struct type *type,
 	}
       else
 	{
-	  val_print (elttype, valaddr, embedded_offset + i * eltlen,
-		     address,
-		     stream, recurse + 1, val, options, current_language);
+	  val_print (elttype, elt_valaddr, elt_offset,
+		     elt_address,
+		     stream, recurse + 1, elt_val, options, current_language);
 	  annotate_elt ();
 	  things_printed++;
 	}
@@ -1980,6 +2213,8 @@ val_print_array_elements (struct type *type,
     {
       fprintf_filtered (stream, "...");
     }
+
+  do_cleanups (old_chain);
 }
 
 /* Read LEN bytes of target memory at address MEMADDR, placing the
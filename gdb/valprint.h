@@ -115,6 +115,15 @@ extern void maybe_print_array_index (struct type *index_type, LONGEST index,
                                      struct ui_file *stream,
 				     const struct value_print_options *);
 
+/* Return non-zero if VAL, printed in LANGUAGE with OPTIONS, is a
+   large lazy array in target memory whose elements should be read as
+   they are printed rather than all at once.  Callers then pass a NULL
+   contents pointer down to val_print instead of fetching VAL.  */
+
+extern int val_print_array_streaming_p (struct value *val,
+					const struct value_print_options *options,
+					const struct language_defn *language);
+
 extern void val_print_array_elements (struct type *, const gdb_byte *, int,
 				      CORE_ADDR, struct ui_file *, int,
 				      const struct value *,
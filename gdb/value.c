@@ -40,6 +40,7 @@
 #include "tracepoint.h"
 #include "cp-abi.h"
 #include "user-regs.h"
+#include "observer.h"
 
 /* Prototypes for exported functions.  */
 
@@ -906,6 +907,11 @@ static struct value_history_chunk *value_history_chain;
 
 static int value_history_count;	/* Abs number of last entry stored.  */
 
+/* The number of values in the value history whose contents have not
+   been fetched yet; see record_latest_value.  */
+
+static int lazy_history_count;
+
 
 /* List of all value objects currently allocated
    (except for those released by calls to release_value)
@@ -1387,7 +1393,7 @@ value_contents_copy (struct value *dst, int dst_offset,
 }
 
 int
-value_lazy (struct value *value)
+value_lazy (const struct value *value)
 {
   return value->lazy;
 }
@@ -1877,9 +1883,22 @@ record_latest_value (struct value *val)
   /* We don't want this value to have anything to do with the inferior anymore.
      In particular, "set $1 = 50" should not affect the variable from which
      the value was taken, and fast watchpoints should be able to assume that
-     a value on the value history never changes.  */
+     a value on the value history never changes.
+
+     The exception is a large array in memory that the printing code
+     reads element by element.  It is recorded lazily, and only
+     fetched by fetch_lazy_history_values before the program or its
+     memory can change, so that printing it need not read it all.  */
   if (value_lazy (val))
-    value_fetch_lazy (val);
+    {
+      struct value_print_options opts;
+
+      get_user_print_options (&opts);
+      if (val_print_array_streaming_p (val, &opts, current_language))
+	lazy_history_count++;
+      else
+	value_fetch_lazy (val);
+    }
   /* We preserve VALUE_LVAL so that the user can find out where it was fetched
      from.  This is a bit dubious, because then *&$1 does not just return $1
      but the current contents of that location.  c'est la vie...  */
@@ -1947,6 +1966,72 @@ access_value_history (int num)
   return value_copy (chunk->values[absnum % VALUE_HISTORY_CHUNK]);
 }
 
+/* The read method of history values whose contents could not be
+   fetched by fetch_lazy_history_values.  */
+
+static void
+unsaved_history_value_read (struct value *v)
+{
+  error (_("The contents of this value could not be saved "
+	   "in the value history."));
+}
+
+static const struct lval_funcs unsaved_history_value_funcs =
+{
+  unsaved_history_value_read,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+/* See value.h.  */
+
+void
+fetch_lazy_history_values (void)
+{
+  struct value_history_chunk *chunk;
+  int i;
+
+  if (lazy_history_count == 0)
+    return;
+  lazy_history_count = 0;
+
+  for (chunk = value_history_chain; chunk != NULL; chunk = chunk->next)
+    for (i = 0; i < VALUE_HISTORY_CHUNK; i++)
+      {
+	struct value *val = chunk->values[i];
+
+	if (val == NULL || !value_lazy (val))
+	  continue;
+
+	TRY
+	  {
+	    value_fetch_lazy (val);
+	  }
+	CATCH (ex, RETURN_MASK_ERROR)
+	  {
+	    /* Typically, the value is larger than max-value-size.
+	       Rather than let its contents change, make any further
+	       attempt to fetch them fail.  */
+	    val->lval = lval_computed;
+	    val->location.computed.funcs = &unsaved_history_value_funcs;
+	    val->location.computed.closure = NULL;
+	  }
+	END_CATCH
+      }
+}
+
+/* Implement the "about_to_proceed" observer notification.  */
+
+static void
+history_about_to_proceed (void)
+{
+  fetch_lazy_history_values ();
+}
+
 static void
 show_values (char *num_exp, int from_tty)
 {
@@ -4054,6 +4139,8 @@ isvoid_internal_fn (struct gdbarch *gdbarch,
 void
 _initialize_values (void)
 {
+  observer_attach_about_to_proceed (history_about_to_proceed);
+
   add_cmd ("convenience", no_class, show_convenience, _("\
 Debugger convenience (\"$foo\") variables and functions.\n\
 Convenience variables are created when you assign them values;\n\
@@ -312,7 +312,7 @@ extern void *value_computed_closure (const struct value *value);
    element.  If you ever change the way lazy flag is set and reset, be
    sure to consider this use as well!  */
 
-extern int value_lazy (struct value *);
+extern int value_lazy (const struct value *);
 extern void set_value_lazy (struct value *value, int val);
 
 extern int value_stack (struct value *);
@@ -978,6 +978,13 @@ extern void release_value_or_incref (struct value *val);
 
 extern int record_latest_value (struct value *val);
 
+/* Fetch the contents of the values recorded lazily in the value
+   history, before the program resumes or its memory is written.
+   Values that cannot be fetched, for instance because they are larger
+   than max-value-size, are made unreadable instead.  */
+
+extern void fetch_lazy_history_values (void);
+
 extern void modify_field (struct type *type, gdb_byte *addr,
 			  LONGEST fieldval, int bitpos, int bitsize);
 
@@ -30,6 +30,10 @@
 #include "gdbthread.h"
 #include "inferior.h"
 #include "varobj-iter.h"
+#include "observer.h"
+#include "gdb_sys_time.h"
+#include "target.h"
+#include "tracepoint.h"
 
 #if HAVE_PYTHON
 #include "python/python.h"
@@ -215,6 +219,86 @@ static struct varobj_root *rootlist;
 /* Pointer to the varobj hash table (built at run time).  */
 static struct vlist **varobj_table;
 
+/* Whether -var-update skips recomputing varobjs whose memory did not
+   change since the previous update.  */
+static int varobj_incremental_update = 1;
+
+/* A range of target memory read at the start of a batch of updates.  */
+struct varobj_mem_range
+{
+  CORE_ADDR addr;
+  ULONGEST length;
+
+  /* The contents of the range, or NULL if it could not be read.  */
+  gdb_byte *contents;
+};
+typedef struct varobj_mem_range varobj_mem_range_s;
+DEF_VEC_O (varobj_mem_range_s);
+
+/* Counters describing the work done by batches of updates.  */
+struct varobj_update_stats
+{
+  /* Number of batches.  */
+  unsigned long batches;
+
+  /* Number of varobjs considered, recomputed, and found unchanged
+     without being recomputed.  */
+  unsigned long visited;
+  unsigned long recomputed;
+  unsigned long skipped;
+
+  /* Number of target reads made, and bytes read, when reading memory
+     ahead of the updates.  */
+  unsigned long reads;
+  ULONGEST bytes;
+
+  /* Time spent reading memory ahead, and in total, in
+     microseconds.  */
+  LONGEST prefetch_usec;
+  LONGEST total_usec;
+};
+
+/* A batch of updates, usually those done by a single -var-update.
+   The memory of every varobj that may be checked without being
+   recomputed is read at once when the batch starts.  */
+struct varobj_update_batch
+{
+  /* The inferior whose memory is in RANGES.  */
+  struct inferior *inf;
+
+  /* The memory read, sorted by address, with no overlaps.  Emptied if
+     the memory may have changed since.  */
+  VEC (varobj_mem_range_s) *ranges;
+
+  /* When the batch started.  */
+  struct timeval start;
+
+  struct varobj_update_stats stats;
+};
+
+/* The current batch of updates, or NULL.  */
+static struct varobj_update_batch *current_update_batch;
+
+/* The statistics of the last batch, and of all of them.  */
+static struct varobj_update_stats last_update_stats;
+static struct varobj_update_stats total_update_stats;
+
+/* What varobj_update knows about a varobj's value compared to the
+   previous update; see the parent_status field of
+   varobj_update_result.  */
+enum varobj_value_status
+{
+  /* Nothing is known.  */
+  VAROBJ_VALUE_UNKNOWN = 0,
+
+  /* The value is at the same address, so the children of an aggregate
+     are too.  */
+  VAROBJ_VALUE_SAME_ADDRESS,
+
+  /* The value is at the same address and has the same contents.  */
+  VAROBJ_VALUE_UNCHANGED
+};
+
 
 
 /* API Implementation */
@@ -1561,23 +1645,494 @@ varobj_value_has_mutated (const struct varobj *var, struct value *new_value,
     return 0;
 }
 
-/* Update the values for a variable and its children.  This is a
-   two-pronged attack.  First, re-parse the value for the root's
-   expression to see if it's changed.  Then go all the way
-   through its children, reconstructing them and noting if they've
-   changed.
+/* Return non-zero if varobj_update may find VAR unchanged without
+   recomputing it.  This requires the printed value of VAR to depend
+   only on the bytes of its value: VAR must not have a pretty-printer
+   or a dynamic type, and must not be a pointer to characters, whose
+   printed value includes the string it points to.  */
 
-   The EXPLICIT parameter specifies if this call is result
-   of MI request to update this specific variable, or 
-   result of implicit -var-update *.  For implicit request, we don't
-   update frozen variables.
+static int
+varobj_incremental_p (const struct varobj *var)
+{
+  struct value_print_options opts;
+  struct type *type;
 
-   NOTE: This function may delete the caller's varobj.  If it
-   returns TYPE_CHANGED, then it has done this and VARP will be modified
-   to point to the new varobj.  */
+  if (!varobj_incremental_update
+      || (var->root->lang_ops != &c_varobj_ops
+	  && var->root->lang_ops != &cplus_varobj_ops)
+      || var->updated
+      || var->not_fetched
+      || var->dynamic->pretty_printer != NULL
+      || varobj_is_dynamic_p (var))
+    return 0;
 
-VEC(varobj_update_result) *
-varobj_update (struct varobj **varp, int is_explicit)
+  get_user_print_options (&opts);
+  if (opts.objectprint)
+    return 0;
+
+  /* C++ fake children have no type.  */
+  if (var->type == NULL)
+    return 1;
+
+  type = check_typedef (var->type);
+  if (TYPE_CODE (type) == TYPE_CODE_REF)
+    type = check_typedef (TYPE_TARGET_TYPE (type));
+  if (TYPE_CODE (type) == TYPE_CODE_PTR)
+    {
+      struct type *target = check_typedef (TYPE_TARGET_TYPE (type));
+
+      if (TYPE_CODE (target) == TYPE_CODE_INT
+	  || TYPE_CODE (target) == TYPE_CODE_CHAR)
+	return 0;
+    }
+
+  return 1;
+}
+
+/* Return non-zero if VALUE is a plain value in target memory: not a
+   bitfield, and with no enclosing object around it.  */
+
+static int
+varobj_plain_memory_value_p (struct value *value)
+{
+  struct type *type;
+
+  if (value == NULL
+      || VALUE_LVAL (value) != lval_memory
+      || value_bitsize (value) != 0
+      || value_embedded_offset (value) != 0)
+    return 0;
+
+  type = check_typedef (value_type (value));
+  return (TYPE_LENGTH (type) != 0
+	  && (TYPE_LENGTH (check_typedef (value_enclosing_type (value)))
+	      == TYPE_LENGTH (type)));
+}
+
+/* If VALUE is a plain value in target memory, store its address and
+   length in *ADDR and *LENGTH and return non-zero.  */
+
+static int
+varobj_value_range (struct value *value, CORE_ADDR *addr, ULONGEST *length)
+{
+  if (!varobj_plain_memory_value_p (value))
+    return 0;
+
+  *addr = value_address (value);
+  *length = TYPE_LENGTH (check_typedef (value_type (value)));
+  return 1;
+}
+
+/* Like varobj_value_range, but also require the contents of VALUE to
+   be fetched, so that they can be compared.  */
+
+static int
+varobj_value_memory (struct value *value, CORE_ADDR *addr, ULONGEST *length)
+{
+  return (varobj_value_range (value, addr, length)
+	  && !value_lazy (value)
+	  && value_entirely_available (value)
+	  && !value_optimized_out (value));
+}
+
+/* Return the varobj whose value VAR's value is computed from.  That is
+   VAR's parent, skipping C++ fake children.  */
+
+static const struct varobj *
+varobj_value_parent (const struct varobj *var)
+{
+  const struct varobj *parent = var->parent;
+
+  while (parent != NULL && CPLUS_FAKE_CHILD (parent))
+    parent = parent->parent;
+  return parent;
+}
+
+/* Return non-zero if the value of VAR lies within the value of its
+   parent, as the values of fields and array elements do.  */
+
+static int
+varobj_contained_p (const struct varobj *var)
+{
+  const struct varobj *parent = varobj_value_parent (var);
+  CORE_ADDR addr, parent_addr;
+  ULONGEST length, parent_length;
+
+  return (parent != NULL
+	  && varobj_value_range (var->value, &addr, &length)
+	  && varobj_value_range (parent->value, &parent_addr,
+				 &parent_length)
+	  && addr >= parent_addr
+	  && addr + length <= parent_addr + parent_length);
+}
+
+/* Return the contents of the LENGTH bytes at ADDR if the current
+   batch of updates read them ahead, or NULL.  */
+
+static const gdb_byte *
+varobj_batch_memory (CORE_ADDR addr, ULONGEST length)
+{
+  struct varobj_update_batch *batch = current_update_batch;
+  varobj_mem_range_s *range;
+  int lo, hi;
+
+  if (batch == NULL || batch->inf != current_inferior ())
+    return NULL;
+
+  /* Find the last range starting at or before ADDR.  */
+  lo = 0;
+  hi = VEC_length (varobj_mem_range_s, batch->ranges);
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      range = VEC_index (varobj_mem_range_s, batch->ranges, mid);
+      if (range->addr <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  if (lo == 0)
+    return NULL;
+
+  range = VEC_index (varobj_mem_range_s, batch->ranges, lo - 1);
+  if (range->contents == NULL
+      || addr - range->addr + length > range->length)
+    return NULL;
+  return range->contents + (addr - range->addr);
+}
+
+/* Return non-zero if the memory read ahead of the current batch of
+   updates shows that the value of VAR is unchanged.  If NEW_VALUE is
+   not NULL, it is the lazy new value of VAR, which must be at the same
+   address.  Otherwise, the caller knows that the address of VAR is
+   unchanged.  */
+
+static int
+varobj_memory_unchanged_p (const struct varobj *var, struct value *new_value)
+{
+  const gdb_byte *contents;
+  CORE_ADDR addr;
+  ULONGEST length;
+
+  if (!varobj_value_memory (var->value, &addr, &length))
+    return 0;
+
+  if (new_value != NULL
+      && (!varobj_plain_memory_value_p (new_value)
+	  || value_type (new_value) != value_type (var->value)
+	  || value_address (new_value) != addr))
+    return 0;
+
+  contents = varobj_batch_memory (addr, length);
+  return (contents != NULL
+	  && memcmp (contents, value_contents (var->value), length) == 0);
+}
+
+/* If VALUE is lazy and its memory was read ahead of the current batch
+   of updates, fill it in from there instead of reading the target
+   again.  */
+
+static void
+varobj_fill_from_batch (struct value *value)
+{
+  const gdb_byte *contents;
+  ULONGEST length;
+
+  if (value == NULL || !value_lazy (value)
+      || !varobj_plain_memory_value_p (value))
+    return;
+
+  length = TYPE_LENGTH (check_typedef (value_type (value)));
+  contents = varobj_batch_memory (value_address (value), length);
+  if (contents == NULL)
+    return;
+
+  memcpy (value_contents_raw (value), contents, length);
+  set_value_lazy (value, 0);
+}
+
+/* Compare OLD_VALUE, the previous value of VAR, with its new value,
+   and return what that tells about the children of VAR.  */
+
+static enum varobj_value_status
+varobj_value_status (const struct varobj *var, struct value *old_value)
+{
+  struct value *new_value = var->value;
+  CORE_ADDR addr;
+  ULONGEST length;
+  struct type *type;
+
+  if (old_value == NULL || new_value == NULL
+      || !varobj_plain_memory_value_p (old_value)
+      || !varobj_plain_memory_value_p (new_value)
+      || value_type (old_value) != value_type (new_value)
+      || value_address (old_value) != value_address (new_value))
+    return VAROBJ_VALUE_UNKNOWN;
+
+  if (varobj_value_memory (old_value, &addr, &length)
+      && varobj_value_memory (new_value, &addr, &length)
+      && memcmp (value_contents (old_value), value_contents (new_value),
+		 length) == 0)
+    return VAROBJ_VALUE_UNCHANGED;
+
+  /* The children of an array are at fixed offsets from it.  So are
+     those of a C structure, but the layout of a C++ class with
+     virtual bases depends on its contents.  The children of a pointer
+     depend on the value of the pointer.  */
+  type = check_typedef (value_type (new_value));
+  if (TYPE_CODE (type) == TYPE_CODE_ARRAY
+      || (var->root->lang_ops == &c_varobj_ops
+	  && (TYPE_CODE (type) == TYPE_CODE_STRUCT
+	      || TYPE_CODE (type) == TYPE_CODE_UNION)))
+    return VAROBJ_VALUE_SAME_ADDRESS;
+
+  return VAROBJ_VALUE_UNKNOWN;
+}
+
+/* Ranges of memory closer than this are read together.  */
+#define VAROBJ_BATCH_GAP 64
+
+/* Ranges of memory are not read ahead, or merged, past this size.  */
+#define VAROBJ_BATCH_MAX_READ 65536
+
+/* Add to RANGES the memory of VAR and its children that may be
+   compared without recomputing them.  */
+
+static void
+varobj_batch_collect (struct varobj *var, VEC (varobj_mem_range_s) **ranges)
+{
+  varobj_mem_range_s range;
+  varobj_p child;
+  int i;
+
+  if (varobj_incremental_p (var)
+      && !varobj_contained_p (var)
+      && varobj_value_range (var->value, &range.addr, &range.length)
+      && range.length <= VAROBJ_BATCH_MAX_READ)
+    {
+      range.contents = NULL;
+      VEC_safe_push (varobj_mem_range_s, *ranges, &range);
+    }
+
+  if (varobj_is_dynamic_p (var))
+    return;
+
+  for (i = 0; VEC_iterate (varobj_p, var->children, i, child); i++)
+    if (child != NULL && !child->frozen)
+      varobj_batch_collect (child, ranges);
+}
+
+/* Callback for all_root_varobjs.  Collect the memory of the varobjs
+   rooted at VAR that are updated in the inferior of the current
+   batch.  */
+
+static void
+varobj_batch_collect_root (struct varobj *var, void *data)
+{
+  VEC (varobj_mem_range_s) **ranges = (VEC (varobj_mem_range_s) **) data;
+  struct varobj_root *root = var->root;
+
+  if (!root->is_valid || var->frozen)
+    return;
+
+  if (root->valid_block != NULL && root->thread_id != 0)
+    {
+      struct thread_info *tp = find_thread_global_id (root->thread_id);
+
+      if (tp == NULL
+	  || find_inferior_ptid (tp->ptid) != current_update_batch->inf)
+	return;
+    }
+
+  varobj_batch_collect (var, ranges);
+}
+
+static int
+compare_varobj_mem_range (const void *ap, const void *bp)
+{
+  const varobj_mem_range_s *a = (const varobj_mem_range_s *) ap;
+  const varobj_mem_range_s *b = (const varobj_mem_range_s *) bp;
+
+  if (a->addr != b->addr)
+    return a->addr < b->addr ? -1 : 1;
+  return 0;
+}
+
+/* Read the memory of the varobjs rooted at VAR, or of all varobjs if
+   VAR is NULL, into BATCH.  Nearby ranges are merged, so that the
+   memory is read with as few target reads as possible.  */
+
+static void
+varobj_batch_prefetch (struct varobj_update_batch *batch, struct varobj *var)
+{
+  VEC (varobj_mem_range_s) *ranges = NULL;
+  struct cleanup *cleanup;
+  varobj_mem_range_s *range, *merged = NULL;
+  struct timeval start, end;
+  int i;
+
+  gettimeofday (&start, NULL);
+  cleanup = make_cleanup (VEC_cleanup (varobj_mem_range_s), &ranges);
+
+  if (var != NULL)
+    varobj_batch_collect_root (var->root->rootvar, &ranges);
+  else
+    all_root_varobjs (varobj_batch_collect_root, &ranges);
+
+  if (!VEC_empty (varobj_mem_range_s, ranges))
+    qsort (VEC_address (varobj_mem_range_s, ranges),
+	   VEC_length (varobj_mem_range_s, ranges),
+	   sizeof (varobj_mem_range_s), compare_varobj_mem_range);
+
+  for (i = 0; VEC_iterate (varobj_mem_range_s, ranges, i, range); i++)
+    {
+      if (merged != NULL
+	  && range->addr <= merged->addr + merged->length + VAROBJ_BATCH_GAP
+	  && (range->addr + range->length - merged->addr
+	      <= VAROBJ_BATCH_MAX_READ
+	      || range->addr + range->length <= merged->addr + merged->length))
+	{
+	  if (range->addr + range->length > merged->addr + merged->length)
+	    merged->length = range->addr + range->length - merged->addr;
+	  continue;
+	}
+
+      merged = VEC_safe_push (varobj_mem_range_s, batch->ranges, range);
+    }
+
+  for (i = 0; VEC_iterate (varobj_mem_range_s, batch->ranges, i, range); i++)
+    {
+      range->contents = (gdb_byte *) xmalloc (range->length);
+      batch->stats.reads++;
+      batch->stats.bytes += range->length;
+      if (target_read_memory (range->addr, range->contents,
+			      range->length) != 0)
+	{
+	  xfree (range->contents);
+	  range->contents = NULL;
+	}
+    }
+
+  do_cleanups (cleanup);
+
+  gettimeofday (&end, NULL);
+  batch->stats.prefetch_usec
+    += ((end.tv_sec - start.tv_sec) * (LONGEST) 1000000
+	+ (end.tv_usec - start.tv_usec));
+}
+
+/* Discard the memory read ahead of the current batch of updates,
+   because it may have changed.  */
+
+static void
+varobj_batch_discard_memory (void)
+{
+  varobj_mem_range_s *range;
+  int i;
+
+  if (current_update_batch == NULL)
+    return;
+
+  for (i = 0;
+       VEC_iterate (varobj_mem_range_s, current_update_batch->ranges,
+		    i, range);
+       i++)
+    xfree (range->contents);
+  VEC_truncate (varobj_mem_range_s, current_update_batch->ranges, 0);
+}
+
+/* Observer for the memory_changed notification.  */
+
+static void
+varobj_memory_changed (struct inferior *inf, CORE_ADDR addr, ssize_t len,
+		       const bfd_byte *data)
+{
+  varobj_batch_discard_memory ();
+}
+
+/* Observer for the target_resumed notification.  */
+
+static void
+varobj_target_resumed (ptid_t ptid)
+{
+  varobj_batch_discard_memory ();
+}
+
+/* Add the counters of FROM to TO.  */
+
+static void
+add_varobj_update_stats (struct varobj_update_stats *to,
+			 const struct varobj_update_stats *from)
+{
+  to->batches += from->batches;
+  to->visited += from->visited;
+  to->recomputed += from->recomputed;
+  to->skipped += from->skipped;
+  to->reads += from->reads;
+  to->bytes += from->bytes;
+  to->prefetch_usec += from->prefetch_usec;
+  to->total_usec += from->total_usec;
+}
+
+/* Cleanup function ending the batch of updates ARG.  */
+
+static void
+varobj_update_batch_end (void *arg)
+{
+  struct varobj_update_batch *batch = (struct varobj_update_batch *) arg;
+  struct timeval end;
+
+  gdb_assert (batch == current_update_batch);
+
+  gettimeofday (&end, NULL);
+  batch->stats.batches = 1;
+  batch->stats.total_usec
+    = ((end.tv_sec - batch->start.tv_sec) * (LONGEST) 1000000
+       + (end.tv_usec - batch->start.tv_usec));
+  last_update_stats = batch->stats;
+  add_varobj_update_stats (&total_update_stats, &batch->stats);
+
+  varobj_batch_discard_memory ();
+  VEC_free (varobj_mem_range_s, batch->ranges);
+  xfree (batch);
+  current_update_batch = NULL;
+}
+
+/* Start a batch of updates of the varobj rooted at VAR, or of all
+   varobjs if VAR is NULL, and read their memory ahead.  Return a
+   cleanup ending the batch.  If a batch is already started, just
+   return a null cleanup.  */
+
+struct cleanup *
+varobj_update_batch_begin (struct varobj *var)
+{
+  struct varobj_update_batch *batch;
+  struct cleanup *cleanup;
+
+  if (current_update_batch != NULL)
+    return make_cleanup (null_cleanup, NULL);
+
+  batch = XCNEW (struct varobj_update_batch);
+  gettimeofday (&batch->start, NULL);
+  batch->inf = current_inferior ();
+  current_update_batch = batch;
+  cleanup = make_cleanup (varobj_update_batch_end, batch);
+
+  /* The memory of a traceframe is only partially collected; read it
+     as needed.  */
+  if (varobj_incremental_update && get_traceframe_number () == -1)
+    varobj_batch_prefetch (batch, var);
+
+  return cleanup;
+}
+
+/* Worker for varobj_update.  Count the varobjs considered in
+   STATS.  */
+
+static VEC(varobj_update_result) *
+varobj_update_1 (struct varobj **varp, int is_explicit,
+		 struct varobj_update_stats *stats)
 {
   int type_changed = 0;
   int i;
@@ -1620,8 +2175,33 @@ varobj_update (struct varobj **varp, int is_explicit)
 	  type_changed = 1;
       r.varobj = *varp;
       r.type_changed = type_changed;
-      if (install_new_value ((*varp), newobj, type_changed))
-	r.changed = 1;
+      stats->visited++;
+
+      /* The memory of a reference is that of the reference itself, not
+	 of the referenced value that is printed.  */
+      if (!type_changed && newobj != NULL
+	  && varobj_incremental_p (*varp)
+	  && TYPE_CODE (check_typedef (value_type (newobj))) != TYPE_CODE_REF
+	  && varobj_memory_unchanged_p (*varp, newobj))
+	{
+	  /* Keep the old value; NEWOBJ is released with all other
+	     values.  */
+	  r.parent_status = VAROBJ_VALUE_UNCHANGED;
+	  stats->skipped++;
+	}
+      else
+	{
+	  struct value *old_value = type_changed ? NULL : (*varp)->value;
+
+	  if (old_value != NULL)
+	    value_incref (old_value);
+	  varobj_fill_from_batch (newobj);
+	  if (install_new_value ((*varp), newobj, type_changed))
+	    r.changed = 1;
+	  r.parent_status = varobj_value_status (*varp, old_value);
+	  value_free (old_value);
+	  stats->recomputed++;
+	}
       
       if (newobj == NULL)
 	r.status = VAROBJ_NOT_IN_SCOPE;
@@ -1656,32 +2236,83 @@ varobj_update (struct varobj **varp, int is_explicit)
 	 updated.  */
       if (!r.value_installed)
 	{
-	  struct type *new_type;
-
-	  newobj = value_of_child (v->parent, v->index);
-	  if (update_type_if_necessary(v, newobj))
-	    r.type_changed = 1;
-	  if (newobj)
-	    new_type = value_type (newobj);
-	  else
-	    new_type = v->root->lang_ops->type_of_child (v->parent, v->index);
-
-	  if (varobj_value_has_mutated (v, newobj, new_type))
+	  enum varobj_value_status parent_status
+	    = (enum varobj_value_status) r.parent_status;
+	  int incremental = varobj_incremental_p (v);
+
+	  stats->visited++;
+
+	  /* A field or element of a value whose bytes are unchanged is
+	     unchanged.  So is one at an unchanged address, whose own
+	     bytes are unchanged.  */
+	  if (incremental
+	      && !CPLUS_FAKE_CHILD (v)
+	      && (parent_status == VAROBJ_VALUE_UNCHANGED
+		  || parent_status == VAROBJ_VALUE_SAME_ADDRESS)
+	      && varobj_contained_p (v)
+	      && (parent_status == VAROBJ_VALUE_UNCHANGED
+		  || varobj_memory_unchanged_p (v, NULL)))
 	    {
-	      /* The children are no longer valid; delete them now.
-	         Report the fact that its type changed as well.  */
-	      varobj_delete (v, 1 /* only_children */);
-	      v->num_children = -1;
-	      v->to = -1;
-	      v->from = -1;
-	      v->type = new_type;
-	      r.type_changed = 1;
+	      r.parent_status = VAROBJ_VALUE_UNCHANGED;
+	      stats->skipped++;
 	    }
-
-	  if (install_new_value (v, newobj, r.type_changed))
+	  else
 	    {
-	      r.changed = 1;
-	      v->updated = 0;
+	      struct type *new_type;
+	      struct value *old_value;
+
+	      newobj = value_of_child (v->parent, v->index);
+	      if (update_type_if_necessary(v, newobj))
+		r.type_changed = 1;
+
+	      if (!r.type_changed && incremental
+		  && !CPLUS_FAKE_CHILD (v)
+		  && varobj_memory_unchanged_p (v, newobj))
+		{
+		  r.parent_status = VAROBJ_VALUE_UNCHANGED;
+		  stats->skipped++;
+		  goto push_children;
+		}
+
+	      if (newobj)
+		new_type = value_type (newobj);
+	      else
+		new_type = v->root->lang_ops->type_of_child (v->parent,
+							     v->index);
+
+	      old_value = v->value;
+	      if (varobj_value_has_mutated (v, newobj, new_type))
+		{
+		  /* The children are no longer valid; delete them now.
+		     Report the fact that its type changed as well.  */
+		  varobj_delete (v, 1 /* only_children */);
+		  v->num_children = -1;
+		  v->to = -1;
+		  v->from = -1;
+		  v->type = new_type;
+		  r.type_changed = 1;
+		  old_value = NULL;
+		}
+
+	      if (old_value != NULL)
+		value_incref (old_value);
+	      varobj_fill_from_batch (newobj);
+	      if (install_new_value (v, newobj, r.type_changed))
+		{
+		  r.changed = 1;
+		  v->updated = 0;
+		}
+
+	      /* The children of a C++ fake child are computed from its
+		 parent's value.  */
+	      if (CPLUS_FAKE_CHILD (v))
+		r.parent_status = parent_status;
+	      else if (r.type_changed)
+		r.parent_status = VAROBJ_VALUE_UNKNOWN;
+	      else
+		r.parent_status = varobj_value_status (v, old_value);
+	      value_free (old_value);
+	      stats->recomputed++;
 	    }
 	}
 
@@ -1783,6 +2414,7 @@ varobj_update (struct varobj **varp, int is_explicit)
 	    }
 	}
 
+    push_children:
       /* Push any children.  Use reverse order so that the first
 	 child is popped from the work stack first, and so
 	 will be added to result first.  This does not
@@ -1794,10 +2426,11 @@ varobj_update (struct varobj **varp, int is_explicit)
 	  /* Child may be NULL if explicitly deleted by -var-delete.  */
 	  if (c != NULL && !c->frozen)
 	    {
-	      varobj_update_result r = {0};
+	      varobj_update_result child_r = {0};
 
-	      r.varobj = c;
-	      VEC_safe_push (varobj_update_result, stack, &r);
+	      child_r.varobj = c;
+	      child_r.parent_status = r.parent_status;
+	      VEC_safe_push (varobj_update_result, stack, &child_r);
 	    }
 	}
 
@@ -1809,6 +2442,38 @@ varobj_update (struct varobj **varp, int is_explicit)
 
   return result;
 }
+
+/* Update the values for a variable and its children.  This is a
+   two-pronged attack.  First, re-parse the value for the root's
+   expression to see if it's changed.  Then go all the way
+   through its children, reconstructing them and noting if they've
+   changed.
+
+   The EXPLICIT parameter specifies if this call is result
+   of MI request to update this specific variable, or 
+   result of implicit -var-update *.  For implicit request, we don't
+   update frozen variables.
+
+   NOTE: This function may delete the caller's varobj.  If it
+   returns TYPE_CHANGED, then it has done this and VARP will be modified
+   to point to the new varobj.
+
+   Unless this is disabled by "maint set varobj-incremental-update",
+   the memory of the varobjs is read ahead at once, and varobjs whose
+   memory is unchanged are not recomputed.  See varobj_incremental_p
+   for the varobjs this applies to.  */
+
+VEC(varobj_update_result) *
+varobj_update (struct varobj **varp, int is_explicit)
+{
+  struct cleanup *cleanup = varobj_update_batch_begin (*varp);
+  VEC(varobj_update_result) *result;
+
+  result = varobj_update_1 (varp, is_explicit,
+			    &current_update_batch->stats);
+  do_cleanups (cleanup);
+  return result;
+}
 
 
 /* Helper functions */
@@ -2017,9 +2682,11 @@ create_child_with_value (struct varobj *parent, int index,
 			 struct varobj_item *item)
 {
   struct varobj *child;
+  struct cleanup *old_chain;
   char *childs_name;
 
   child = new_variable ();
+  old_chain = make_cleanup_free_variable (child);
 
   /* NAME is allocated by caller.  */
   child->name = item->name;
@@ -2033,8 +2700,6 @@ create_child_with_value (struct varobj *parent, int index,
     childs_name = xstrprintf ("%s.%s", parent->obj_name, item->name);
   child->obj_name = childs_name;
 
-  install_variable (child);
-
   /* Compute the type of the child.  Must do this before
      calling install_new_value.  */
   if (item->value != NULL)
@@ -2047,6 +2712,12 @@ create_child_with_value (struct varobj *parent, int index,
 							   child->index);
   install_new_value (child, item->value, 1);
 
+  /* Only make the child known once it is complete: the command
+     creating it may be cancelled, and a later command would then
+     find a child of that name already installed.  */
+  install_variable (child);
+  discard_cleanups (old_chain);
+
   return child;
 }
 
@@ -2706,12 +3377,53 @@ varobj_invalidate (void)
   all_root_varobjs (varobj_invalidate_iter, NULL);
 }
 
+/* Print the counters STATS of varobj updates.  */
+
+static void
+print_varobj_update_stats (const struct varobj_update_stats *stats)
+{
+  printf_filtered (_("  Varobjs considered: %s\n"),
+		   pulongest (stats->visited));
+  printf_filtered (_("  Varobjs recomputed: %s\n"),
+		   pulongest (stats->recomputed));
+  printf_filtered (_("  Varobjs found unchanged without "
+		     "recomputing them: %s\n"),
+		   pulongest (stats->skipped));
+  printf_filtered (_("  Memory reads ahead: %s (%s bytes)\n"),
+		   pulongest (stats->reads), pulongest (stats->bytes));
+  printf_filtered (_("  Time reading memory ahead: %s us\n"),
+		   plongest (stats->prefetch_usec));
+  printf_filtered (_("  Total time: %s us\n"),
+		   plongest (stats->total_usec));
+}
+
+/* Implement the "maint info varobj-updates" command.  */
+
+static void
+maintenance_info_varobj_updates (char *args, int from_tty)
+{
+  if (total_update_stats.batches == 0)
+    {
+      printf_filtered (_("No varobj updates.\n"));
+      return;
+    }
+
+  printf_filtered (_("Last varobj update:\n"));
+  print_varobj_update_stats (&last_update_stats);
+  printf_filtered (_("All %s varobj updates:\n"),
+		   pulongest (total_update_stats.batches));
+  print_varobj_update_stats (&total_update_stats);
+}
+
 extern void _initialize_varobj (void);
 void
 _initialize_varobj (void)
 {
   varobj_table = XCNEWVEC (struct vlist *, VAROBJ_TABLE_SIZE);
 
+  observer_attach_memory_changed (varobj_memory_changed);
+  observer_attach_target_resumed (varobj_target_resumed);
+
   add_setshow_zuinteger_cmd ("varobj", class_maintenance,
 			     &varobjdebug,
 			     _("Set varobj debugging."),
@@ -2719,4 +3431,21 @@ _initialize_varobj (void)
 			     _("When non-zero, varobj debugging is enabled."),
 			     NULL, show_varobjdebug,
 			     &setdebuglist, &showdebuglist);
+
+  add_setshow_boolean_cmd ("varobj-incremental-update", class_maintenance,
+			   &varobj_incremental_update, _("\
+Set whether variable object updates skip unchanged memory."), _("\
+Show whether variable object updates skip unchanged memory."), _("\
+When on, the memory of all variable objects being updated is read at once,\n\
+and variable objects whose memory is unchanged are not recomputed."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_cmd ("varobj-updates", class_maintenance,
+	   maintenance_info_varobj_updates, _("\
+Show statistics about variable object updates.\n\
+Show how many variable objects the last update, and all updates,\n\
+considered and recomputed, and how long they took."),
+	   &maintenanceinfolist);
 }
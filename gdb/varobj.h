@@ -72,6 +72,10 @@ typedef struct varobj_update_result_t
      be yet installed.  Don't use this outside varobj.c.  */
   int value_installed;  
 
+  /* What the update of the parent varobj tells about the value of
+     this one.  Don't use this outside varobj.c.  */
+  int parent_status;
+
   /* This will be non-NULL when new children were added to the varobj.
      It lists the new children (which must necessarily come at the end
      of the child list) added during an update.  The caller is
@@ -308,6 +312,8 @@ extern void all_root_varobjs (void (*func) (struct varobj *var, void *data),
 extern VEC(varobj_update_result) *varobj_update (struct varobj **varp, 
 						 int is_explicit);
 
+extern struct cleanup *varobj_update_batch_begin (struct varobj *var);
+
 extern void varobj_invalidate (void);
 
 extern int varobj_editable_p (const struct varobj *var);
@@ -0,0 +1,343 @@
+/* Worker threads for GDB.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "worker-threads.h"
+#include "command.h"
+#include "gdbcmd.h"
+
+#ifdef HAVE_WORKER_THREADS
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+/* The number of threads set by "maint set worker-threads", or -1 to
+   use one thread per processor.  */
+
+static int worker_threads = -1;
+
+/* Non-zero in worker threads.  */
+
+static GDB_THREAD_LOCAL int in_parallel_work;
+
+/* See worker-threads.h.  */
+
+int
+worker_thread_count (void)
+{
+#ifdef HAVE_WORKER_THREADS
+  if (worker_threads >= 0)
+    return worker_threads > 0 ? worker_threads : 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+  {
+    long count = sysconf (_SC_NPROCESSORS_ONLN);
+
+    if (count > 1)
+      return count > INT_MAX ? INT_MAX : (int) count;
+  }
+#endif
+#endif /* HAVE_WORKER_THREADS */
+
+  return 1;
+}
+
+/* See worker-threads.h.  */
+
+int
+worker_thread_p (void)
+{
+  return in_parallel_work;
+}
+
+/* The work shared by the threads of a call to parallel_for_each.  */
+
+struct parallel_work
+{
+  /* The function to call, and its data.  */
+  void (*func) (int, void *);
+  void *data;
+
+  /* The number of items.  */
+  int n;
+
+  /* The next item to run.  */
+  int next;
+};
+
+#ifdef HAVE_WORKER_THREADS
+
+/* The worker threads are started once, and then wait for work until
+   the number of threads is changed.  POOL_LOCK protects all of the
+   following, and the NEXT field of the current work.  */
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Signalled when there is new work, or when the threads must exit.  */
+
+static pthread_cond_t pool_work_cond = PTHREAD_COND_INITIALIZER;
+
+/* Signalled when the last busy thread is done with the current
+   work.  */
+
+static pthread_cond_t pool_idle_cond = PTHREAD_COND_INITIALIZER;
+
+/* The worker threads, and their number.  */
+
+static pthread_t *pool_threads;
+static int pool_size;
+
+/* The work the threads should join, or NULL.  */
+
+static struct parallel_work *pool_work;
+
+/* Incremented each time POOL_WORK is set, so that a thread joins each
+   work at most once.  */
+
+static unsigned long pool_generation;
+
+/* The number of threads running items of POOL_WORK.  */
+
+static int pool_busy;
+
+/* Non-zero when the threads must exit.  */
+
+static int pool_stopping;
+
+#endif /* HAVE_WORKER_THREADS */
+
+/* Non-zero while the main thread hands out work to the pool.  A call
+   to parallel_for_each made by a work item then runs its own items
+   in the calling thread.  */
+
+static int pool_in_use;
+
+/* Run the items of WORK until there is none left.  */
+
+static void
+run_parallel_work (struct parallel_work *work)
+{
+  while (1)
+    {
+      int i;
+
+#ifdef HAVE_WORKER_THREADS
+      pthread_mutex_lock (&pool_lock);
+#endif
+      i = work->next++;
+#ifdef HAVE_WORKER_THREADS
+      pthread_mutex_unlock (&pool_lock);
+#endif
+
+      if (i >= work->n)
+	break;
+      work->func (i, work->data);
+    }
+}
+
+#ifdef HAVE_WORKER_THREADS
+
+/* The start routine of worker threads: run the items of each work
+   handed to the pool, until told to exit.  */
+
+static void *
+worker_thread_main (void *arg)
+{
+  unsigned long generation = pool_generation;
+
+  in_parallel_work = 1;
+
+  pthread_mutex_lock (&pool_lock);
+  while (1)
+    {
+      struct parallel_work *work;
+
+      while (!pool_stopping
+	     && (pool_work == NULL || pool_generation == generation))
+	pthread_cond_wait (&pool_work_cond, &pool_lock);
+      if (pool_stopping)
+	break;
+
+      generation = pool_generation;
+      work = pool_work;
+      pool_busy++;
+      pthread_mutex_unlock (&pool_lock);
+
+      run_parallel_work (work);
+
+      pthread_mutex_lock (&pool_lock);
+      if (--pool_busy == 0)
+	pthread_cond_signal (&pool_idle_cond);
+    }
+  pthread_mutex_unlock (&pool_lock);
+
+  free_exception_messages ();
+  return NULL;
+}
+
+/* Make the threads of the pool exit, and wait for them.  */
+
+static void
+stop_worker_pool (void)
+{
+  int i;
+
+  gdb_assert (!pool_in_use);
+
+  pthread_mutex_lock (&pool_lock);
+  pool_stopping = 1;
+  pthread_cond_broadcast (&pool_work_cond);
+  pthread_mutex_unlock (&pool_lock);
+
+  for (i = 0; i < pool_size; i++)
+    pthread_join (pool_threads[i], NULL);
+
+  xfree (pool_threads);
+  pool_threads = NULL;
+  pool_size = 0;
+  pool_stopping = 0;
+}
+
+/* Start the threads of the pool, one less than worker_thread_count
+   since the calling thread also runs work items.  */
+
+static void
+start_worker_pool (void)
+{
+  int count = worker_thread_count () - 1;
+  int i;
+#ifdef HAVE_SIGPROCMASK
+  sigset_t all_signals, old_signals;
+
+  /* Worker threads must leave the signals to the main thread.  */
+  sigfillset (&all_signals);
+  pthread_sigmask (SIG_BLOCK, &all_signals, &old_signals);
+#endif
+
+  pool_threads = XNEWVEC (pthread_t, count);
+  for (i = 0; i < count; i++)
+    {
+      /* If a thread cannot be started, the other threads do its
+	 share of the work.  */
+      if (pthread_create (&pool_threads[pool_size], NULL,
+			  worker_thread_main, NULL) == 0)
+	pool_size++;
+    }
+
+#ifdef HAVE_SIGPROCMASK
+  pthread_sigmask (SIG_SETMASK, &old_signals, NULL);
+#endif
+}
+
+#endif /* HAVE_WORKER_THREADS */
+
+/* See worker-threads.h.  */
+
+void
+parallel_for_each (int n, void (*func) (int i, void *data), void *data)
+{
+  struct parallel_work work;
+
+  work.func = func;
+  work.data = data;
+  work.n = n;
+  work.next = 0;
+
+#ifdef HAVE_WORKER_THREADS
+  /* Work items run by the pool itself are not split further.  */
+  if (n > 1 && !worker_thread_p () && !pool_in_use)
+    {
+      if (pool_threads == NULL && worker_thread_count () > 1)
+	start_worker_pool ();
+
+      if (pool_size > 0)
+	{
+	  pool_in_use = 1;
+
+	  pthread_mutex_lock (&pool_lock);
+	  pool_work = &work;
+	  pool_generation++;
+	  pthread_cond_broadcast (&pool_work_cond);
+	  pthread_mutex_unlock (&pool_lock);
+
+	  run_parallel_work (&work);
+
+	  /* All the items are handed out; wait for those still
+	     running.  */
+	  pthread_mutex_lock (&pool_lock);
+	  pool_work = NULL;
+	  while (pool_busy > 0)
+	    pthread_cond_wait (&pool_idle_cond, &pool_lock);
+	  pthread_mutex_unlock (&pool_lock);
+
+	  pool_in_use = 0;
+	  return;
+	}
+    }
+#endif /* HAVE_WORKER_THREADS */
+
+  run_parallel_work (&work);
+}
+
+/* Implement "maint set worker-threads": replace the threads of the
+   pool with as many as now requested.  */
+
+static void
+set_worker_threads (char *args, int from_tty, struct cmd_list_element *c)
+{
+#ifdef HAVE_WORKER_THREADS
+  if (pool_threads != NULL)
+    stop_worker_pool ();
+  if (worker_thread_count () > 1)
+    start_worker_pool ();
+#endif
+}
+
+/* Implement "maint show worker-threads".  */
+
+static void
+show_worker_threads (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  if (worker_threads < 0)
+    fprintf_filtered (file,
+		      _("The number of worker threads is unlimited "
+			"(%d in use).\n"),
+		      worker_thread_count ());
+  else
+    fprintf_filtered (file, _("The number of worker threads is %s.\n"),
+		      value);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_worker_threads;
+
+void
+_initialize_worker_threads (void)
+{
+  add_setshow_zuinteger_unlimited_cmd ("worker-threads", class_maintenance,
+				       &worker_threads, _("\
+Set the number of threads GDB uses to read debug info in parallel."), _("\
+Show the number of threads GDB uses to read debug info in parallel."), _("\
+When set to \"unlimited\", the default, GDB uses one thread per processor.\n\
+When set to 0 or 1, GDB does all the work in the main thread."),
+				       set_worker_threads, show_worker_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+}
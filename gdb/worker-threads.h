@@ -0,0 +1,56 @@
+/* Worker threads for GDB.
+
+   Copyright (C) 2016 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef WORKER_THREADS_H
+#define WORKER_THREADS_H
+
+/* Some work, such as reading the debug info of many compilation
+   units, can be split into independent items run in parallel by
+   worker threads.  Most of GDB is not thread-safe: a work item may
+   only read the data structures that nothing else modifies while the
+   work runs, and write to its own data.  The worker threads are
+   started on first use, or by "maint set worker-threads", and then
+   wait for the next work until the number of threads changes.  Each
+   worker thread has its own chain of cleanups and exception handlers,
+   so work items may use cleanups and TRY/CATCH, but must catch all
+   their exceptions; they must not print anything, query the user, or
+   check for a quit request.  Complaints issued by a work item in a worker thread are
+   turned into errors, so that the caller can redo the item in the
+   main thread, where the complaint is issued.  */
+
+/* Return the number of threads, including the calling thread, that
+   parallel_for_each spreads its work over.  */
+
+extern int worker_thread_count (void);
+
+/* Return non-zero if the calling thread is a worker thread, rather
+   than the main thread.  */
+
+extern int worker_thread_p (void);
+
+/* Call FUNC (I, DATA) for each I from 0 to N - 1, in no particular
+   order and in parallel, and return once all the calls are complete.
+   The calling thread runs some of the calls itself.  A call made by
+   a work item, while the worker threads are busy, runs all of its
+   calls in the calling thread.  */
+
+extern void parallel_for_each (int n, void (*func) (int i, void *data),
+			       void *data);
+
+#endif /* WORKER_THREADS_H */